@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -43,19 +44,35 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, bool polyphase);
 	~Channel();
 
+	// ResidualVM specific start
 	/**
-	 * Mixes the channel's samples into the given buffer.
+	 * Prepares the channel for mixing, with the mixer's _mutex held.
 	 *
-	 * @param data buffer where to mix the data
-	 * @param len  number of sample *pairs*. So a value of
-	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 * Updates the elapsed time bookkeeping and takes a snapshot of the
+	 * volumes, so that mix() only touches state of its own.
+	 *
+	 * @param volL   the left volume to mix with
+	 * @param volR   the right volume to mix with
+	 * @return false when the stream has no data to mix
+	 */
+	bool beginMix(st_volume_t &volL, st_volume_t &volR);
+
+	/**
+	 * Mixes the channel's samples into the given accumulation buffer.
+	 *
+	 * @param acc    buffer where to mix the data, holding 2 * len samples
+	 * @param buffer scratch buffer for the converted samples, as large as acc
+	 * @param len    number of sample *pairs*
+	 * @param dsp    the kernels to mix with
+	 * @param volL   the left volume, from beginMix()
+	 * @param volR   the right volume, from beginMix()
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int32 *acc, int16 *buffer, uint len, const MixerDSP &dsp, st_volume_t volL, st_volume_t volR);
+	// ResidualVM specific end
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -152,6 +169,7 @@ private:
 
 	byte _volume;
 	int8 _balance;
+	bool _reverseStereo; // ResidualVM specific
 
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
@@ -173,17 +191,26 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _accumBuffer(nullptr), _channelBuffer(nullptr), _mixBufferSize(0) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
+
+	// ResidualVM specific
+	initMixerDSP(_dsp, g_system && g_system->hasFeature(OSystem::kFeatureCpuSSE2));
+	_polyphaseResampler = ConfMan.get("audio_resampler") == "polyphase";
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	// ResidualVM specific
+	delete[] _accumBuffer;
+	delete[] _channelBuffer;
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -258,7 +285,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _polyphaseResampler);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -267,38 +294,82 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	// ResidualVM specific start
+	// _mutex is only held while picking the channels to mix, see _mixMutex
+	Common::StackLock mixLock(_mixMutex);
+	uint64 startTime = g_system->getMicros();
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
 	len >>= 2;
 
-	// Since the mixer callback has been called, the mixer must be ready...
-	_mixerReady = true;
+	Channel *mixChannels[NUM_CHANNELS];
+	st_volume_t mixVolumes[NUM_CHANNELS][2];
+	int mixChannelCount = 0;
+	{
+		Common::StackLock lock(_mutex);
 
-	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+		// Since the mixer callback has been called, the mixer must be ready...
+		_mixerReady = true;
+
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_channels[i]) {
+				if (_channels[i]->isFinished()) {
+					delete _channels[i];
+					_channels[i] = 0;
+				} else if (!_channels[i]->isPaused()
+				           && _channels[i]->beginMix(mixVolumes[mixChannelCount][0], mixVolumes[mixChannelCount][1])) {
+					mixChannels[mixChannelCount++] = _channels[i];
+				}
+			}
+	}
+
+	if (len > _mixBufferSize) {
+		delete[] _accumBuffer;
+		delete[] _channelBuffer;
+		_accumBuffer = new int32[2 * len];
+		_channelBuffer = new int16[2 * len];
+		_mixBufferSize = len;
+	}
 
 	// mix all channels
+	memset(_accumBuffer, 0, 2 * len * sizeof(int32));
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
-			}
-		}
+	for (int i = 0; i < mixChannelCount; i++) {
+		tmp = mixChannels[i]->mix(_accumBuffer, _channelBuffer, len, _dsp, mixVolumes[i][0], mixVolumes[i][1]);
+
+		if (tmp > res)
+			res = tmp;
+	}
+	_dsp.pack(buf, _accumBuffer, len);
+
+	uint32 mixTime = (uint32)(g_system->getMicros() - startTime);
+	Common::StackLock lock(_mutex);
+	_mixStatistics.callbacks++;
+	_mixStatistics.samples += len;
+	_mixStatistics.mixTime += mixTime;
+	_mixStatistics.maxMixTime = MAX(_mixStatistics.maxMixTime, mixTime);
+	_mixStatistics.maxBufferSize = MAX<uint32>(_mixStatistics.maxBufferSize, len);
+	// ResidualVM specific end
 
 	return res;
 }
 
+// ResidualVM-specific function
+Mixer::MixStatistics MixerImpl::getMixStatistics() {
+	Common::StackLock lock(_mutex);
+	return _mixStatistics;
+}
+
+// ResidualVM-specific function
+void MixerImpl::resetMixStatistics() {
+	Common::StackLock lock(_mutex);
+	_mixStatistics = MixStatistics();
+}
+
 void MixerImpl::stopAll() {
+	Common::StackLock mixLock(_mixMutex); // ResidualVM specific
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
@@ -309,6 +380,7 @@ void MixerImpl::stopAll() {
 }
 
 void MixerImpl::stopID(int id) {
+	Common::StackLock mixLock(_mixMutex); // ResidualVM specific
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
@@ -319,6 +391,7 @@ void MixerImpl::stopID(int id) {
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
+	Common::StackLock mixLock(_mixMutex); // ResidualVM specific
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
@@ -332,6 +405,7 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+	Common::StackLock lock(_mutex); // ResidualVM specific
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -495,15 +569,21 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, bool polyphase)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+      _balance(0), _reverseStereo(reverseStereo), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
       _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
+	// ResidualVM specific start
+	if (polyphase && (uint)_stream->getRate() != mixer->getOutputRate())
+		_converter = makePolyphaseRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo,
+		                                        g_system->hasFeature(OSystem::kFeatureCpuSSE2));
+	else
+	// ResidualVM specific end
 	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
 }
 
@@ -602,21 +682,48 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
-int Channel::mix(int16 *data, uint len) {
+// ResidualVM-specific function
+bool Channel::beginMix(st_volume_t &volL, st_volume_t &volR) {
 	assert(_stream);
 
-	int res = 0;
 	if (_stream->endOfData()) {
 		// TODO: call drain method
-	} else {
-		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
-		_samplesDecoded += res;
+		return false;
 	}
 
+	_samplesConsumed = _samplesDecoded;
+	_mixerTimeStamp = g_system->getMillis(true);
+	_pauseTime = 0;
+
+	// The converter applies the left volume to the right output when
+	// reversing stereo, so do the same here.
+	volL = _volL;
+	volR = _volR;
+	if (_reverseStereo)
+		SWAP(volL, volR);
+
+	return true;
+}
+
+// ResidualVM-specific function
+int Channel::mix(int32 *acc, int16 *buffer, uint len, const MixerDSP &dsp, st_volume_t volL, st_volume_t volR) {
+	assert(_converter);
+
+	// Convert at full volume, then scale while accumulating
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	for (uint i = 0; i < 2 * len; i++)
+		buffer[i] = (int16)0x8000;
+#else
+	memset(buffer, 0, 2 * len * sizeof(int16));
+#endif
+	int res = _converter->flow(*_stream, buffer, len, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	for (int i = 0; i < 2 * res; i++)
+		buffer[i] ^= 0x8000;
+#endif
+	dsp.accumulate(acc, buffer, res, volL, volR);
+	_samplesDecoded += res;
+
 	return res;
 }
 
@@ -277,6 +277,28 @@ public:
 	 * @return the output sample rate in Hz
 	 */
 	virtual uint getOutputRate() const = 0;
+
+	// ResidualVM specific start
+	/** Timing of the mixer callback, to see how much headroom the audio buffer size leaves. */
+	struct MixStatistics {
+		MixStatistics() : callbacks(0), samples(0), mixTime(0), maxMixTime(0), maxBufferSize(0) {}
+
+		uint32 callbacks;     ///< Number of mixer callbacks
+		uint32 samples;       ///< Number of sample pairs mixed
+		uint64 mixTime;       ///< Total time spent mixing, in microseconds
+		uint32 maxMixTime;    ///< Longest callback, in microseconds
+		uint32 maxBufferSize; ///< Largest buffer mixed in a callback, in sample pairs
+	};
+
+	/**
+	 * Get the timing of the mixer callbacks since the mixer was created,
+	 * or since the last resetMixStatistics().
+	 */
+	virtual MixStatistics getMixStatistics() = 0;
+
+	/** Start counting the mixer statistics again. */
+	virtual void resetMixStatistics() = 0;
+	// ResidualVM specific end
 };
 
 
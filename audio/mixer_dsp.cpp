@@ -0,0 +1,109 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/mixer_dsp.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/util.h"
+
+#ifdef MIXER_SIMD_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace Audio {
+
+static void accumulate(int32 *acc, const int16 *src, uint len, int volL, int volR) {
+	for (uint i = 0; i < len; i++) {
+		acc[0] += (src[0] * volL) / Mixer::kMaxMixerVolume;
+		acc[1] += (src[1] * volR) / Mixer::kMaxMixerVolume;
+		acc += 2;
+		src += 2;
+	}
+}
+
+static void pack(int16 *dest, const int32 *acc, uint len) {
+	for (uint i = 0; i < 2 * len; i++) {
+		int val = CLIP<int32>(acc[i], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		dest[i] = ((int16)val) ^ 0x8000;
+#else
+		dest[i] = val;
+#endif
+	}
+}
+
+#ifdef MIXER_SIMD_KERNELS
+
+/** Divide by kMaxMixerVolume, rounding towards zero like the scalar division. */
+static inline __m128i divideVolume(__m128i products) {
+	const __m128i bias = _mm_and_si128(_mm_srai_epi32(products, 31), _mm_set1_epi32(Mixer::kMaxMixerVolume - 1));
+	return _mm_srai_epi32(_mm_add_epi32(products, bias), 8);
+}
+
+static void accumulateSSE2(int32 *acc, const int16 *src, uint len, int volL, int volR) {
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+	uint i = 0;
+	for (; i + 4 <= len; i += 4) {
+		__m128i samples = _mm_loadu_si128((const __m128i *)(src + 2 * i));
+		__m128i lo = _mm_mullo_epi16(samples, vol);
+		__m128i hi = _mm_mulhi_epi16(samples, vol);
+		__m128i *dest = (__m128i *)(acc + 2 * i);
+		_mm_storeu_si128(dest, _mm_add_epi32(_mm_loadu_si128(dest), divideVolume(_mm_unpacklo_epi16(lo, hi))));
+		_mm_storeu_si128(dest + 1, _mm_add_epi32(_mm_loadu_si128(dest + 1), divideVolume(_mm_unpackhi_epi16(lo, hi))));
+	}
+
+	accumulate(acc + 2 * i, src + 2 * i, len - i, volL, volR);
+}
+
+static void packSSE2(int16 *dest, const int32 *acc, uint len) {
+	uint i = 0;
+	for (; i + 4 <= len; i += 4) {
+		__m128i samples = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(acc + 2 * i)),
+		                                  _mm_loadu_si128((const __m128i *)(acc + 2 * i + 4)));
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		samples = _mm_xor_si128(samples, _mm_set1_epi16((int16)0x8000));
+#endif
+		_mm_storeu_si128((__m128i *)(dest + 2 * i), samples);
+	}
+
+	pack(dest + 2 * i, acc + 2 * i, len - i);
+}
+
+#endif
+
+bool initMixerDSP(MixerDSP &dsp, bool simd) {
+#ifdef MIXER_SIMD_KERNELS
+	if (simd) {
+		dsp.accumulate = accumulateSSE2;
+		dsp.pack       = packSSE2;
+		return true;
+	}
+#endif
+
+	dsp.accumulate = accumulate;
+	dsp.pack       = pack;
+	return false;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,58 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_MIXER_DSP_H
+#define AUDIO_MIXER_DSP_H
+
+#include "common/scummsys.h"
+
+#if defined(__SSE2__)
+#define MIXER_SIMD_KERNELS
+#endif
+
+namespace Audio {
+
+/**
+ * The sample kernels of the mixer. Channels are accumulated into a 32-bit
+ * buffer of interleaved stereo samples, which is clamped to 16 bits once
+ * all of them have been mixed.
+ */
+struct MixerDSP {
+	/**
+	 * Scale len sample pairs by the left and right volumes (0 - kMaxMixerVolume)
+	 * and add them to the accumulation buffer. The scaling rounds towards zero,
+	 * like the rate converters do.
+	 */
+	void (*accumulate)(int32 *acc, const int16 *src, uint len, int volL, int volR);
+	/** Clamp len sample pairs of the accumulation buffer to the output format. */
+	void (*pack)(int16 *dest, const int32 *acc, uint len);
+};
+
+/**
+ * Fill in the kernels, using the SIMD versions when requested and built in.
+ * @return whether the SIMD kernels are used
+ */
+bool initMixerDSP(MixerDSP &dsp, bool simd);
+
+} // End of namespace Audio
+
+#endif // AUDIO_MIXER_DSP_H
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/mixer_dsp.h" // ResidualVM specific
 
 namespace Audio {
 
@@ -56,6 +57,25 @@ private:
 
 	Common::Mutex _mutex;
 
+	// ResidualVM specific start
+	/**
+	 * Held by the mixer callback while it mixes the channels. _mutex only
+	 * guards the channel table, so that controlling channels doesn't have
+	 * to wait for the streams to be decoded. Stopping sounds takes this
+	 * one too, as callers may free a stream as soon as it is stopped.
+	 * When both are needed, _mixMutex is locked first.
+	 */
+	Common::Mutex _mixMutex;
+
+	MixerDSP _dsp;
+	int32 *_accumBuffer;
+	int16 *_channelBuffer;
+	uint _mixBufferSize;
+	MixStatistics _mixStatistics;
+	/** Whether the channels use the polyphase rate converter, from the audio_resampler setting */
+	bool _polyphaseResampler;
+	// ResidualVM specific end
+
 	const uint _sampleRate;
 	bool _mixerReady;
 	uint32 _handleSeed;
@@ -118,6 +138,11 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	// ResidualVM specific start
+	virtual MixStatistics getMixStatistics();
+	virtual void resetMixStatistics();
+	// ResidualVM specific end
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
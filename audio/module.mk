@@ -4,7 +4,9 @@ MODULE_OBJS := \
 	audiostream.o \
 	mididrv.o \
 	mixer.o \
+	mixer_dsp.o \
 	musicplugin.o \
+	rate_polyphase.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
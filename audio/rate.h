@@ -80,6 +80,17 @@ public:
 
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
 
+// ResidualVM specific start
+/**
+ * Create a rate converter using a polyphase FIR filter. It is slower than
+ * the default linear interpolation but has much less aliasing and
+ * imaging, especially when upsampling low rate sounds.
+ *
+ * @param simd whether to use the SIMD kernels, when built in
+ */
+RateConverter *makePolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, bool simd = false);
+// ResidualVM specific end
+
 } // End of namespace Audio
 
 #endif
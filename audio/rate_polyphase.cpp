@@ -0,0 +1,307 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/math.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#if defined(__SSE2__)
+#define RATE_SIMD_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace Audio {
+
+enum {
+	/** Number of filter taps, an even number of samples around the output position. */
+	POLYPHASE_TAPS = 16,
+	/** Maximum number of filter phases. Rate ratios with more phases use the nearest one. */
+	POLYPHASE_MAX_PHASES = 256,
+	/** Fractional bits of the filter coefficients. */
+	POLYPHASE_COEF_BITS = 14,
+	/** Input samples buffered per channel, including the filter history. */
+	POLYPHASE_BUFFER_SIZE = 512
+};
+
+static int scalarProduct(const int16 *samples, const int16 *coefs) {
+	int sum = 0;
+	for (int i = 0; i < POLYPHASE_TAPS; i++)
+		sum += samples[i] * coefs[i];
+	return sum;
+}
+
+#ifdef RATE_SIMD_KERNELS
+static inline int scalarProductSSE2(const int16 *samples, const int16 *coefs) {
+	__m128i sum = _mm_add_epi32(
+		_mm_madd_epi16(_mm_loadu_si128((const __m128i *)samples), _mm_loadu_si128((const __m128i *)coefs)),
+		_mm_madd_epi16(_mm_loadu_si128((const __m128i *)(samples + 8)), _mm_loadu_si128((const __m128i *)(coefs + 8))));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+/** Both scalar products of a stereo output, sharing the horizontal additions. */
+static inline void scalarProductStereoSSE2(const int16 *left, const int16 *right, const int16 *coefs, int &out0, int &out1) {
+	const __m128i coefs0 = _mm_loadu_si128((const __m128i *)coefs);
+	const __m128i coefs1 = _mm_loadu_si128((const __m128i *)(coefs + 8));
+	__m128i sum0 = _mm_add_epi32(
+		_mm_madd_epi16(_mm_loadu_si128((const __m128i *)left), coefs0),
+		_mm_madd_epi16(_mm_loadu_si128((const __m128i *)(left + 8)), coefs1));
+	__m128i sum1 = _mm_add_epi32(
+		_mm_madd_epi16(_mm_loadu_si128((const __m128i *)right), coefs0),
+		_mm_madd_epi16(_mm_loadu_si128((const __m128i *)(right + 8)), coefs1));
+	// (l0 + l2, r0 + r2, l1 + l3, r1 + r3)
+	__m128i sum = _mm_add_epi32(_mm_unpacklo_epi32(sum0, sum1), _mm_unpackhi_epi32(sum0, sum1));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	out0 = _mm_cvtsi128_si32(sum);
+	out1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 1, 1, 1)));
+}
+#endif
+
+/**
+ * Audio rate converter based on a windowed sinc FIR filter, split into
+ * one set of coefficients per output phase.
+ *
+ * The ratio of the rates is kept exactly as outrate / inrate reduced to
+ * L / M: each output sample advances the input by M / L samples, and its
+ * fractional position selects one of the L filter phases. Input is read
+ * in blocks and kept per channel, so every output sample is one scalar
+ * product over contiguous memory.
+ *
+ * The filter looks ahead half its length, so the last few samples of a
+ * stream are not played.
+ */
+template<bool stereo, bool reverseStereo>
+class PolyphaseRateConverter : public RateConverter {
+protected:
+	/** Input samples of each channel, the first one at input position _inPos - POLYPHASE_TAPS / 2 + 1 */
+	int16 _buffer[stereo ? 2 : 1][POLYPHASE_BUFFER_SIZE];
+	/** Interleaved samples as read from the stream */
+	int16 _readBuffer[stereo ? 2 * POLYPHASE_BUFFER_SIZE : POLYPHASE_BUFFER_SIZE];
+	/** Number of valid samples in each channel of _buffer */
+	int _bufferLen;
+	/** Index in _buffer of the first sample of the window of the next output */
+	int _windowPos;
+
+	/** L and M, the rate ratio reduced to lowest terms */
+	uint32 _outStep, _inStep;
+	/** Fractional position of the next output, in units of 1 / L input samples */
+	uint32 _phase;
+	uint32 _phaseCount;
+
+	int16 *_coefs;
+	bool _simd;
+
+	void makeFilter(st_rate_t inrate, st_rate_t outrate);
+	bool refill(AudioStream &input);
+
+public:
+	PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, bool simd);
+	~PolyphaseRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, bool simd) {
+	assert(inrate > 0 && outrate > 0);
+	if (inrate / outrate >= POLYPHASE_BUFFER_SIZE - POLYPHASE_TAPS)
+		error("rate effect can only downsample by less than %d", POLYPHASE_BUFFER_SIZE - POLYPHASE_TAPS);
+
+	st_rate_t divisor = Common::gcd(inrate, outrate);
+	_outStep = outrate / divisor;
+	_inStep = inrate / divisor;
+	_phaseCount = MIN<uint32>(_outStep, POLYPHASE_MAX_PHASES);
+	_phase = 0;
+
+#ifdef RATE_SIMD_KERNELS
+	_simd = simd;
+#else
+	_simd = false;
+#endif
+
+	makeFilter(inrate, outrate);
+
+	// Start with silence before the first sample, so that the first output
+	// is centered on it
+	_bufferLen = POLYPHASE_TAPS / 2 - 1;
+	_windowPos = 0;
+	memset(_buffer, 0, sizeof(_buffer));
+}
+
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::~PolyphaseRateConverter() {
+	delete[] _coefs;
+}
+
+template<bool stereo, bool reverseStereo>
+void PolyphaseRateConverter<stereo, reverseStereo>::makeFilter(st_rate_t inrate, st_rate_t outrate) {
+	// Cut off a bit below the lower of the two Nyquist frequencies
+	const double cutoff = 0.9 * MIN<double>(1.0, (double)outrate / inrate);
+
+	_coefs = new int16[_phaseCount * POLYPHASE_TAPS];
+	for (uint32 phase = 0; phase < _phaseCount; phase++) {
+		double coefs[POLYPHASE_TAPS];
+		double sum = 0.0;
+		for (int i = 0; i < POLYPHASE_TAPS; i++) {
+			// Distance of the tap from the output position, in input samples
+			double x = (i - (POLYPHASE_TAPS / 2 - 1)) - (double)phase / _phaseCount;
+			double sinc = x == 0.0 ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			double window = 0.42 + 0.5 * cos(2.0 * M_PI * x / POLYPHASE_TAPS) + 0.08 * cos(4.0 * M_PI * x / POLYPHASE_TAPS);
+			coefs[i] = sinc * window;
+			sum += coefs[i];
+		}
+
+		// Normalize each phase for unity gain, putting the rounding error
+		// on the largest tap
+		int16 *dest = _coefs + phase * POLYPHASE_TAPS;
+		int total = 0;
+		int largest = 0;
+		for (int i = 0; i < POLYPHASE_TAPS; i++) {
+			dest[i] = (int16)floor(coefs[i] / sum * (1 << POLYPHASE_COEF_BITS) + 0.5);
+			total += dest[i];
+			if (dest[i] > dest[largest])
+				largest = i;
+		}
+		dest[largest] += (1 << POLYPHASE_COEF_BITS) - total;
+	}
+}
+
+/**
+ * Drop the samples that are no longer needed and read more.
+ * @return whether any samples were read
+ */
+template<bool stereo, bool reverseStereo>
+bool PolyphaseRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	const int channels = stereo ? 2 : 1;
+
+	// When downsampling, the window may already be past the buffered samples
+	int drop = MIN(_windowPos, _bufferLen);
+	_bufferLen -= drop;
+	_windowPos -= drop;
+	for (int c = 0; c < channels; c++)
+		memmove(_buffer[c], _buffer[c] + drop, _bufferLen * sizeof(int16));
+
+	int len = input.readBuffer(_readBuffer, (POLYPHASE_BUFFER_SIZE - _bufferLen) * channels) / channels;
+	if (len <= 0)
+		return false;
+
+	const int16 *src = _readBuffer;
+	int16 *dest0 = _buffer[0] + _bufferLen;
+	int16 *dest1 = _buffer[channels - 1] + _bufferLen;
+	for (int i = 0; i < len; i++) {
+		dest0[i] = *src++;
+		if (stereo)
+			dest1[i] = *src++;
+	}
+	_bufferLen += len;
+	return true;
+}
+
+template<bool stereo, bool reverseStereo>
+int PolyphaseRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart = obuf;
+	st_sample_t *oend = obuf + osamp * 2;
+
+	const uint32 inAdvance = _inStep / _outStep;
+	const uint32 phaseAdvance = _inStep % _outStep;
+
+	while (obuf < oend) {
+		// Filter as far as the buffered input goes
+		while (obuf < oend) {
+			// Use the nearest phase. Rounding up to _phaseCount is phase 0
+			// of the next input sample.
+			uint32 phase = _phase;
+			int windowPos = _windowPos;
+			if (_phaseCount != _outStep) {
+				phase = (_phase * _phaseCount + _outStep / 2) / _outStep;
+				if (phase == _phaseCount) {
+					phase = 0;
+					windowPos++;
+				}
+			}
+			if (windowPos + POLYPHASE_TAPS > _bufferLen)
+				break;
+			const int16 *coefs = _coefs + phase * POLYPHASE_TAPS;
+
+			int out0, out1;
+#ifdef RATE_SIMD_KERNELS
+			if (_simd) {
+				if (stereo) {
+					scalarProductStereoSSE2(_buffer[0] + windowPos, _buffer[stereo ? 1 : 0] + windowPos, coefs, out0, out1);
+				} else {
+					out0 = out1 = scalarProductSSE2(_buffer[0] + windowPos, coefs);
+				}
+			} else
+#endif
+			{
+				out0 = scalarProduct(_buffer[0] + windowPos, coefs);
+				out1 = stereo ? scalarProduct(_buffer[stereo ? 1 : 0] + windowPos, coefs) : out0;
+			}
+			out0 = CLIP<int>((out0 + (1 << (POLYPHASE_COEF_BITS - 1))) >> POLYPHASE_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+			out1 = CLIP<int>((out1 + (1 << (POLYPHASE_COEF_BITS - 1))) >> POLYPHASE_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+
+			// output left channel
+			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+			// output right channel
+			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+			obuf += 2;
+
+			// Increment input position
+			_windowPos += inAdvance;
+			_phase += phaseAdvance;
+			if (_phase >= _outStep) {
+				_phase -= _outStep;
+				_windowPos++;
+			}
+		}
+
+		if (obuf < oend && !refill(input))
+			break;
+	}
+	return (obuf - ostart) / 2;
+}
+
+template<bool stereo, bool reverseStereo>
+static RateConverter *makePolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, bool simd) {
+	return new PolyphaseRateConverter<stereo, reverseStereo>(inrate, outrate, simd);
+}
+
+RateConverter *makePolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, bool simd) {
+	if (stereo) {
+		if (reverseStereo)
+			return makePolyphaseRateConverter<true, true>(inrate, outrate, simd);
+		else
+			return makePolyphaseRateConverter<true, false>(inrate, outrate, simd);
+	} else
+		return makePolyphaseRateConverter<false, false>(inrate, outrate, simd);
+}
+
+} // End of namespace Audio
@@ -192,6 +192,24 @@ public:
 	 */
 	virtual Common::WriteStream *createWriteStream() = 0;
 
+	// ResidualVM specific start
+	/**
+	 * Maps the file referred by this node into memory. Filesystems
+	 * without mapping support keep this default.
+	 *
+	 * @return pointer to the mapping, 0 if not supported or in case of a failure
+	 */
+	virtual Common::FileMapping *createReadMapping() { return nullptr; }
+
+	/**
+	 * Returns the last modification time of the file, in seconds since the
+	 * epoch. Filesystems without this information keep this default.
+	 *
+	 * @return the modification time, 0 if not supported or in case of a failure
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+	// ResidualVM specific end
+
 	/**
 	* Creates a directory referred by this node.
 	*
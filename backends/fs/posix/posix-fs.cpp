@@ -51,6 +51,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#ifdef POSIX
+#include <sys/mman.h> // ResidualVM specific
+#endif
 
 #ifdef __OS2__
 #define INCL_DOS
@@ -315,6 +318,56 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+// ResidualVM specific start
+#ifdef POSIX
+namespace {
+
+class PosixFileMapping : public Common::FileMapping {
+public:
+	PosixFileMapping(void *data, size_t size) : _data(data), _size(size) {}
+	~PosixFileMapping() { munmap(_data, _size); }
+
+	const byte *getData() const { return static_cast<const byte *>(_data); }
+	uint32 getSize() const { return _size; }
+
+private:
+	void *_data;
+	size_t _size;
+};
+
+} // End of anonymous namespace
+#endif
+
+Common::FileMapping *POSIXFilesystemNode::createReadMapping() {
+#ifdef POSIX
+	int fd = open(_path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	void *data = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size > 0 && (uint64)st.st_size <= 0xFFFFFFFF)
+		data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping keeps its own reference to the file
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return nullptr;
+	return new PosixFileMapping(data, st.st_size);
+#else
+	return nullptr;
+#endif
+}
+
+uint32 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0)
+		return 0;
+
+	return st.st_mtime;
+}
+// ResidualVM specific end
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
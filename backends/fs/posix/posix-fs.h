@@ -68,6 +68,8 @@ public:
 
 	virtual Common::SeekableReadStream *createReadStream();
 	virtual Common::WriteStream *createWriteStream();
+	virtual Common::FileMapping *createReadMapping(); // ResidualVM specific
+	virtual uint32 getModificationTime() const; // ResidualVM specific
 	virtual bool createDirectory();
 
 protected:
@@ -25,6 +25,7 @@
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/resvm-graphics.h" // ResidualVM specific
 #include "backends/mutex/mutex.h"
+#include "backends/threads/threads.h" // ResidualVM specific
 #include "gui/EventRecorder.h"
 
 #include "audio/mixer.h"
@@ -34,6 +35,7 @@
 ModularBackend::ModularBackend()
 	:
 	_mutexManager(0),
+	_threadManager(0), // ResidualVM specific
 	_graphicsManager(0),
 	_mixer(0) {
 
@@ -44,6 +46,8 @@ ModularBackend::~ModularBackend() {
 	_graphicsManager = 0;
 	delete _mixer;
 	_mixer = 0;
+	delete _threadManager; // ResidualVM specific
+	_threadManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
 }
@@ -289,6 +293,46 @@ void ModularBackend::deleteMutex(MutexRef mutex) {
 	_mutexManager->deleteMutex(mutex);
 }
 
+// ResidualVM specific start
+OSystem::ThreadRef ModularBackend::createThread(ThreadProc proc, void *param) {
+	if (!_threadManager)
+		return 0;
+	return _threadManager->createThread(proc, param);
+}
+
+void ModularBackend::joinThread(ThreadRef thread) {
+	assert(_threadManager);
+	_threadManager->joinThread(thread);
+}
+
+uint ModularBackend::getCPUCount() {
+	if (!_threadManager)
+		return 1;
+	return _threadManager->getCPUCount();
+}
+
+OSystem::ConditionRef ModularBackend::createCondition() {
+	if (!_threadManager)
+		return 0;
+	return _threadManager->createCondition();
+}
+
+void ModularBackend::waitCondition(ConditionRef cond, MutexRef mutex) {
+	assert(_threadManager);
+	_threadManager->waitCondition(cond, mutex);
+}
+
+void ModularBackend::broadcastCondition(ConditionRef cond) {
+	assert(_threadManager);
+	_threadManager->broadcastCondition(cond);
+}
+
+void ModularBackend::deleteCondition(ConditionRef cond) {
+	assert(_threadManager);
+	_threadManager->deleteCondition(cond);
+}
+// ResidualVM specific end
+
 Audio::Mixer *ModularBackend::getMixer() {
 	assert(_mixer);
 	return (Audio::Mixer *)_mixer;
@@ -28,6 +28,7 @@
 class GraphicsManager;
 class ResVmGraphicsManager; // ResidualVM specific
 class MutexManager;
+class ThreadManager; // ResidualVM specific
 
 /**
  * Base class for modular backends.
@@ -130,6 +131,20 @@ public:
 
 	//@}
 
+	/** @name Thread handling */
+	// ResidualVM specific
+	//@{
+
+	virtual ThreadRef createThread(ThreadProc proc, void *param) override;
+	virtual void joinThread(ThreadRef thread) override;
+	virtual uint getCPUCount() override;
+	virtual ConditionRef createCondition() override;
+	virtual void waitCondition(ConditionRef cond, MutexRef mutex) override;
+	virtual void broadcastCondition(ConditionRef cond) override;
+	virtual void deleteCondition(ConditionRef cond) override;
+
+	//@}
+
 	/** @name Sound */
 	//@{
 
@@ -150,6 +165,7 @@ protected:
 	//@{
 
 	MutexManager *_mutexManager;
+	ThreadManager *_threadManager; // ResidualVM specific
 	ResVmGraphicsManager *_graphicsManager; // ResidualVM: was GraphicsManager
 	Audio::Mixer *_mixer;
 
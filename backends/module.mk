@@ -125,6 +125,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
 	plugins/sdl/sdl-provider.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 # SDL 2 removed audio CD support
@@ -196,7 +197,8 @@ endif
 
 ifeq ($(BACKEND),android)
 MODULE_OBJS += \
-	mutex/pthread/pthread-mutex.o
+	mutex/pthread/pthread-mutex.o \
+	threads/pthread/pthread-threads.o
 endif
 
 ifeq ($(BACKEND),androidsdl)
@@ -55,6 +55,7 @@
 
 #include "backends/keymapper/keymapper.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h" // ResidualVM specific
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -155,6 +156,8 @@ OSystem_Android::~OSystem_Android() {
 
 	deleteMutex(_event_queue_lock);
 
+	delete _threadManager; // ResidualVM specific
+	_threadManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
 }
@@ -342,6 +345,7 @@ void OSystem_Android::initBackend() {
 	// (via ConfMan.registerDefault)
 	_savefileManager = new DefaultSaveFileManager(ConfMan.get("savepath"));
 	_mutexManager = new PthreadMutexManager();
+	_threadManager = new PthreadThreadManager(); // ResidualVM specific
 	_timerManager = new DefaultTimerManager();
 
 	_event_queue_lock = createMutex();
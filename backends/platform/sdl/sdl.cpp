@@ -47,6 +47,7 @@
 #include "backends/events/sdl/resvm-sdl-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/threads/sdl/sdl-threads.h" // ResidualVM specific
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 
@@ -132,6 +133,8 @@ OSystem_SDL::~OSystem_SDL() {
 #endif
 
 	_timerManager = 0;
+	delete _threadManager; // ResidualVM specific
+	_threadManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
 
@@ -162,6 +165,10 @@ void OSystem_SDL::init() {
 	if (_mutexManager == 0)
 		_mutexManager = new SdlMutexManager();
 
+	// ResidualVM specific
+	if (_threadManager == 0)
+		_threadManager = new SdlThreadManager();
+
 	if (_window == 0)
 		_window = new SdlWindow();
 
@@ -179,6 +186,11 @@ bool OSystem_SDL::hasFeature(Feature f) {
 	if (f == kFeatureJoystickDeadzone || f == kFeatureKbdMouseSpeed) {
 		return _eventSource->isJoystickConnected();
 	}
+	// ResidualVM specific start
+	if (f == kFeatureCpuSSE2) {
+		return SDL_HasSSE2();
+	}
+	// ResidualVM specific end
 	return ModularBackend::hasFeature(f);
 }
 
@@ -663,6 +675,18 @@ uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	return millis;
 }
 
+// ResidualVM specific start
+uint64 OSystem_SDL::getMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	uint64 counter = SDL_GetPerformanceCounter();
+	uint64 frequency = SDL_GetPerformanceFrequency();
+	return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+#else
+	return OSystem::getMicros();
+#endif
+}
+// ResidualVM specific end
+
 void OSystem_SDL::delayMillis(uint msecs) {
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processDelayMillis())
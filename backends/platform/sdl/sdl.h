@@ -86,6 +86,7 @@ public:
 	virtual void setWindowCaption(const char *caption) override;
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	virtual uint32 getMillis(bool skipRecord = false) override;
+	virtual uint64 getMicros() override; // ResidualVM specific
 	virtual void delayMillis(uint msecs) override;
 	virtual void getTimeAndDate(TimeDate &td) const override;
 	virtual Audio::Mixer *getMixer() override;
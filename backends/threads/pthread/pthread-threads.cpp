@@ -0,0 +1,113 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(__ANDROID__) || defined(IPHONE)
+
+#include "backends/threads/pthread/pthread-threads.h"
+
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+struct PthreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+static void *threadHandler(void *data) {
+	PthreadStart *start = (PthreadStart *)data;
+	OSystem::ThreadProc proc = start->proc;
+	void *param = start->param;
+	delete start;
+
+	proc(param);
+	return nullptr;
+}
+
+OSystem::ThreadRef PthreadThreadManager::createThread(OSystem::ThreadProc proc, void *param) {
+	PthreadStart *start = new PthreadStart();
+	start->proc = proc;
+	start->param = param;
+
+	pthread_t *thread = new pthread_t;
+
+	if (pthread_create(thread, nullptr, threadHandler, start) != 0) {
+		warning("pthread_create() failed");
+		delete start;
+		delete thread;
+		return nullptr;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void PthreadThreadManager::joinThread(OSystem::ThreadRef thread) {
+	pthread_t *t = (pthread_t *)thread;
+
+	if (pthread_join(*t, nullptr) != 0)
+		warning("pthread_join() failed");
+	delete t;
+}
+
+uint PthreadThreadManager::getCPUCount() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (uint)count : 1;
+}
+
+OSystem::ConditionRef PthreadThreadManager::createCondition() {
+	pthread_cond_t *cond = new pthread_cond_t;
+
+	if (pthread_cond_init(cond, nullptr) != 0) {
+		warning("pthread_cond_init() failed");
+		delete cond;
+		return nullptr;
+	}
+
+	return (OSystem::ConditionRef)cond;
+}
+
+void PthreadThreadManager::waitCondition(OSystem::ConditionRef cond, OSystem::MutexRef mutex) {
+	if (pthread_cond_wait((pthread_cond_t *)cond, (pthread_mutex_t *)mutex) != 0)
+		warning("pthread_cond_wait() failed");
+}
+
+void PthreadThreadManager::broadcastCondition(OSystem::ConditionRef cond) {
+	if (pthread_cond_broadcast((pthread_cond_t *)cond) != 0)
+		warning("pthread_cond_broadcast() failed");
+}
+
+void PthreadThreadManager::deleteCondition(OSystem::ConditionRef cond) {
+	pthread_cond_t *c = (pthread_cond_t *)cond;
+
+	if (pthread_cond_destroy(c) != 0)
+		warning("pthread_cond_destroy() failed");
+	else
+		delete c;
+}
+
+#endif
@@ -0,0 +1,94 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threads.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+#include "common/textconsole.h"
+
+struct SdlThreadStart {
+	OSystem::ThreadProc proc;
+	void *param;
+};
+
+static int SDLCALL threadHandler(void *data) {
+	SdlThreadStart *start = (SdlThreadStart *)data;
+	OSystem::ThreadProc proc = start->proc;
+	void *param = start->param;
+	delete start;
+
+	proc(param);
+	return 0;
+}
+
+OSystem::ThreadRef SdlThreadManager::createThread(OSystem::ThreadProc proc, void *param) {
+	SdlThreadStart *start = new SdlThreadStart();
+	start->proc = proc;
+	start->param = param;
+
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	SDL_Thread *thread = SDL_CreateThread(threadHandler, "ResidualVM worker", start);
+#else
+	SDL_Thread *thread = SDL_CreateThread(threadHandler, start);
+#endif
+	if (!thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		delete start;
+	}
+
+	return (OSystem::ThreadRef)thread;
+}
+
+void SdlThreadManager::joinThread(OSystem::ThreadRef thread) {
+	SDL_WaitThread((SDL_Thread *)thread, nullptr);
+}
+
+uint SdlThreadManager::getCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	int count = SDL_GetCPUCount();
+	return count > 0 ? count : 1;
+#else
+	return 1;
+#endif
+}
+
+OSystem::ConditionRef SdlThreadManager::createCondition() {
+	return (OSystem::ConditionRef)SDL_CreateCond();
+}
+
+void SdlThreadManager::waitCondition(OSystem::ConditionRef cond, OSystem::MutexRef mutex) {
+	SDL_CondWait((SDL_cond *)cond, (SDL_mutex *)mutex);
+}
+
+void SdlThreadManager::broadcastCondition(OSystem::ConditionRef cond) {
+	SDL_CondBroadcast((SDL_cond *)cond);
+}
+
+void SdlThreadManager::deleteCondition(OSystem::ConditionRef cond) {
+	SDL_DestroyCond((SDL_cond *)cond);
+}
+
+#endif
@@ -0,0 +1,44 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_THREADS_SDL_H
+#define BACKENDS_THREADS_SDL_H
+
+#include "backends/threads/threads.h"
+
+/**
+ * SDL thread manager. The conditions expect mutexes
+ * created by the SDL mutex manager.
+ */
+class SdlThreadManager : public ThreadManager {
+public:
+	virtual OSystem::ThreadRef createThread(OSystem::ThreadProc proc, void *param);
+	virtual void joinThread(OSystem::ThreadRef thread);
+	virtual uint getCPUCount();
+
+	virtual OSystem::ConditionRef createCondition();
+	virtual void waitCondition(OSystem::ConditionRef cond, OSystem::MutexRef mutex);
+	virtual void broadcastCondition(OSystem::ConditionRef cond);
+	virtual void deleteCondition(OSystem::ConditionRef cond);
+};
+
+#endif
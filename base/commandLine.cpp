@@ -164,6 +164,8 @@ static const char HELP_STRING[] =
 	"                           (default: 0) (only supported by software renderer)\n"
 	"  --[no-]dirtyrects        Enable dirty rectangles optimisation in software renderer\n"
 	"                           (default: enabled)\n"
+	"  --renderthreads=NUM      Number of threads used by the software renderer, 0 to\n"
+	"                           disable, -1 (auto-detect) (default: 0)\n"
 #endif
 	"  --aspect-ratio           Enable aspect ratio correction\n"
 #if 0 // ResidulVM - not used
@@ -259,6 +261,7 @@ void registerDefaults() {
 // ResidualVM specific start
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("dirtyrects", true);
+	ConfMan.registerDefault("renderthreads", 0);
 	ConfMan.registerDefault("bpp", 0);
 	ConfMan.registerDefault("vsync", true);
 // ResidualVM specific end
@@ -273,6 +276,8 @@ void registerDefaults() {
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
 
+	ConfMan.registerDefault("audio_resampler", "linear"); // ResidualVM specific
+
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
 /* ResidualVM - not used
@@ -737,6 +742,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("dirtyrects")
 			END_OPTION
 
+			DO_LONG_OPTION_INT("renderthreads")
+			END_OPTION
+
 			DO_LONG_OPTION("gamma")
 			END_OPTION
 // ResidualVM specific start
@@ -48,6 +48,11 @@ DCT::~DCT() {
 	delete[] _csc2;
 }
 
+// ResidualVM-specific function
+bool DCT::enableSIMDKernels(bool enable) {
+	return _rdft->enableSIMDKernels(enable);
+}
+
 void DCT::calc(float *data) {
 	switch (_trans) {
 	case DCT_I:
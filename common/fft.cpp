@@ -30,6 +30,13 @@
 #include "common/fft.h"
 #include "common/util.h"
 #include "common/textconsole.h"
+// ResidualVM specific start
+#include "common/system.h"
+
+#ifdef COMMON_FFT_SIMD_KERNELS
+#include <emmintrin.h>
+#endif
+// ResidualVM specific end
 
 namespace Common {
 
@@ -45,6 +52,10 @@ FFT::FFT(int bits, int inverse) : _bits(bits), _inverse(inverse) {
 
 	_splitRadix = 1;
 
+	// ResidualVM specific
+	_simdKernels = false;
+	enableSIMDKernels(g_system && g_system->hasFeature(OSystem::kFeatureCpuSSE2));
+
 	for (int i = 0; i < n; i++)
 		_revTab[-splitRadixPermutation(i, n, _inverse) & (n - 1)] = i;
 
@@ -68,6 +79,16 @@ FFT::~FFT() {
 	delete[] _tmpBuf;
 }
 
+// ResidualVM-specific function
+bool FFT::enableSIMDKernels(bool enable) {
+#ifdef COMMON_FFT_SIMD_KERNELS
+	_simdKernels = enable;
+#else
+	_simdKernels = false;
+#endif
+	return _simdKernels;
+}
+
 const uint16 *FFT::getRevTab() const {
 	return _revTab;
 }
@@ -181,6 +202,62 @@ PASS(pass)
 #define BUTTERFLIES BUTTERFLIES_BIG
 PASS(pass_big)
 
+// ResidualVM specific start
+#ifdef COMMON_FFT_SIMD_KERNELS
+
+/* The same pass, two transforms at a time. Every lane does the same
+ * operations in the same order as the scalar code, so the results are
+ * identical. The first two transforms stay scalar to keep the signs of
+ * zeros produced by TRANSFORM_ZERO. All inputs are loaded before any
+ * store, like in BUTTERFLIES_BIG.
+ */
+static void passSSE2(Complex *z, const float *wre, unsigned int n) {
+	float t1, t2, t3, t4, t5, t6;
+	int o1 = 2 * n;
+	int o2 = 4 * n;
+	int o3 = 6 * n;
+	const float *wim = wre + o1;
+
+	TRANSFORM_ZERO(z[0], z[o1], z[o2], z[o3]);
+	TRANSFORM(z[1], z[o1 + 1], z[o2 + 1], z[o3 + 1], wre[1], wim[-1]);
+
+	const __m128 negOdd = _mm_castsi128_ps(_mm_set_epi32(0x80000000, 0, 0x80000000, 0));
+	const __m128 negEven = _mm_castsi128_ps(_mm_set_epi32(0, 0x80000000, 0, 0x80000000));
+
+	for (unsigned int k = 2; k < 2 * n; k += 2) {
+		float *p = &z[k].re;
+		__m128 a0 = _mm_loadu_ps(p);
+		__m128 a1 = _mm_loadu_ps(p + 2 * o1);
+		__m128 a2 = _mm_loadu_ps(p + 2 * o2);
+		__m128 a3 = _mm_loadu_ps(p + 2 * o3);
+
+		// (wre[k], wre[k], wre[k + 1], wre[k + 1]) and (wim[-k], wim[-k], wim[-k - 1], wim[-k - 1])
+		__m128 w = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(wre + k));
+		__m128 wr = _mm_shuffle_ps(w, w, _MM_SHUFFLE(1, 1, 0, 0));
+		w = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(wim - k - 1));
+		__m128 wi = _mm_shuffle_ps(w, w, _MM_SHUFFLE(0, 0, 1, 1));
+
+		// (t1, t2) and (t5, t6) of both transforms
+		__m128 t12 = _mm_add_ps(_mm_mul_ps(a2, wr),
+		                        _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(a2, a2, _MM_SHUFFLE(2, 3, 0, 1)), wi), negOdd));
+		__m128 t56 = _mm_add_ps(_mm_mul_ps(a3, wr),
+		                        _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(a3, a3, _MM_SHUFFLE(2, 3, 0, 1)), wi), negEven));
+
+		__m128 sum = _mm_add_ps(t56, t12);
+		// (t3, t4), swapped to (t4, t3)
+		__m128 diff = _mm_xor_ps(_mm_sub_ps(t56, t12), negOdd);
+		diff = _mm_shuffle_ps(diff, diff, _MM_SHUFFLE(2, 3, 0, 1));
+
+		_mm_storeu_ps(p, _mm_add_ps(a0, sum));
+		_mm_storeu_ps(p + 2 * o2, _mm_sub_ps(a0, sum));
+		_mm_storeu_ps(p + 2 * o1, _mm_add_ps(a1, diff));
+		_mm_storeu_ps(p + 2 * o3, _mm_sub_ps(a1, diff));
+	}
+}
+
+#endif
+// ResidualVM specific end
+
 void FFT::fft4(Complex *z) {
 	float t1, t2, t3, t4, t5, t6, t7, t8;
 
@@ -245,6 +322,14 @@ void FFT::fft(int n, int logn, Complex *z) {
 		fft((n / 4), logn - 2, z + (n / 4) * 2);
 		fft((n / 4), logn - 2, z + (n / 4) * 3);
 		assert(_cosTables[logn - 4]);
+// ResidualVM specific start
+#ifdef COMMON_FFT_SIMD_KERNELS
+		if (_simdKernels) {
+			passSSE2(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
+			break;
+		}
+#endif
+// ResidualVM specific end
 		if (n > 1024)
 			pass_big(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
 		else
@@ -32,6 +32,12 @@
 #include "common/scummsys.h"
 #include "common/math.h"
 
+// ResidualVM specific start
+#if defined(__SSE2__)
+#define COMMON_FFT_SIMD_KERNELS
+#endif
+// ResidualVM specific end
+
 namespace Common {
 
 class CosineTable;
@@ -49,6 +55,16 @@ public:
 
 	const uint16 *getRevTab() const;
 
+	// ResidualVM specific start
+	/**
+	 * Use the SIMD kernels, if they are built in. They give the same
+	 * results as the scalar code. They are enabled by default when the
+	 * CPU supports them.
+	 * @return whether the SIMD kernels are used
+	 */
+	bool enableSIMDKernels(bool enable);
+	// ResidualVM specific end
+
 	/** Do the permutation needed BEFORE calling calc(). */
 	void permute(Complex *z);
 
@@ -70,6 +86,8 @@ private:
 
 	int _splitRadix;
 
+	bool _simdKernels; // ResidualVM specific
+
 	static int splitRadixPermutation(int i, int n, int inverse);
 
 	CosineTable *_cosTables[13];
@@ -140,6 +140,22 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+// ResidualVM specific start
+FileMapping *FSNode::createReadMapping() const {
+	if (_realNode == nullptr || !_realNode->exists() || _realNode->isDirectory())
+		return nullptr;
+
+	return _realNode->createReadMapping();
+}
+
+uint32 FSNode::getModificationTime() const {
+	if (_realNode == nullptr || !_realNode->exists())
+		return 0;
+
+	return _realNode->getModificationTime();
+}
+// ResidualVM specific end
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
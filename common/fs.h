@@ -27,6 +27,7 @@
 #include "common/archive.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
+#include "common/noncopyable.h"
 #include "common/ptr.h"
 #include "common/str.h"
 
@@ -45,6 +46,21 @@ class WriteStream;
  */
 class FSList : public Array<FSNode> {};
 
+// ResidualVM specific start
+/**
+ * Read-only view of the whole contents of a file, mapped into memory.
+ * Created by FSNode::createReadMapping(). The data stays valid until
+ * the mapping object is deleted.
+ */
+class FileMapping : NonCopyable {
+public:
+	virtual ~FileMapping() {}
+
+	virtual const byte *getData() const = 0;
+	virtual uint32 getSize() const = 0;
+};
+// ResidualVM specific end
+
 /**
  * FSNode, short for "File System Node", provides an abstraction for file
  * paths, allowing for portable file system browsing. This means for example,
@@ -231,6 +247,25 @@ public:
 	 */
 	WriteStream *createWriteStream() const;
 
+	// ResidualVM specific start
+	/**
+	 * Maps the file referred by this node into memory, for read-only
+	 * access without copying. Not every filesystem supports this, callers
+	 * must be prepared to fall back to createReadStream().
+	 *
+	 * @return pointer to the mapping, 0 if the file could not be mapped
+	 */
+	FileMapping *createReadMapping() const;
+
+	/**
+	 * Returns the last modification time of the file referred by this node,
+	 * in seconds since the epoch. Not every filesystem supports this.
+	 *
+	 * @return the modification time, 0 if it is not known
+	 */
+	uint32 getModificationTime() const;
+	// ResidualVM specific end
+
 	/**
 	 * Creates a directory referred by this node. This assumes that this
 	 * node refers to non-existing directory. If this is not the case,
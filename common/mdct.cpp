@@ -62,6 +62,11 @@ MDCT::~MDCT() {
 	delete _fft;
 }
 
+// ResidualVM-specific function
+bool MDCT::enableSIMDKernels(bool enable) {
+	return _fft->enableSIMDKernels(enable);
+}
+
 #define CMUL(dre, dim, are, aim, bre, bim) do { \
 		(dre) = (are) * (bre) - (aim) * (bim);  \
 		(dim) = (are) * (bim) + (aim) * (bre);  \
@@ -46,6 +46,11 @@ public:
 	/** Compute inverse MDCT of size N = 2^nbits. */
 	void calcIMDCT(float *output, const float *input);
 
+	// ResidualVM specific start
+	/** Use the SIMD kernels of the underlying FFT, see FFT::enableSIMDKernels(). */
+	bool enableSIMDKernels(bool enable);
+	// ResidualVM specific end
+
 private:
 	int _bits;
 	int _size;
@@ -46,6 +46,11 @@ RDFT::~RDFT() {
 	delete _fft;
 }
 
+// ResidualVM-specific function
+bool RDFT::enableSIMDKernels(bool enable) {
+	return _fft->enableSIMDKernels(enable);
+}
+
 void RDFT::calc(float *data) {
 	const int n = 1 << _bits;
 
@@ -94,6 +94,11 @@ public:
 
 	void calc(float *data);
 
+	// ResidualVM specific start
+	/** Use the SIMD kernels of the underlying FFT, see FFT::enableSIMDKernels(). */
+	bool enableSIMDKernels(bool enable);
+	// ResidualVM specific end
+
 private:
 	int _bits;
 	int _inverse;
@@ -452,7 +452,15 @@ public:
 		/**
 		* For platforms that should not have a Quit button
 		*/
-		kFeatureNoQuit
+		kFeatureNoQuit,
+
+		// ResidualVM specific start
+		/**
+		* The CPU supports SSE2 instructions. Only meaningful for code
+		* built with SSE2 support.
+		*/
+		kFeatureCpuSSE2
+		// ResidualVM specific end
 
 	};
 
@@ -1270,6 +1278,18 @@ public:
 	*/
 	virtual uint32 getMillis(bool skipRecord = false) = 0;
 
+	/**
+	 * !!! ResidualVM specific method !!!
+	 *
+	 * Get a number of microseconds, counted from an arbitrary point.
+	 * Meant for measuring short durations, it is not recorded by the
+	 * event recorder. The default implementation only has the
+	 * resolution of getMillis().
+	 */
+	virtual uint64 getMicros() {
+		return (uint64)getMillis(true) * 1000;
+	}
+
 	/** Delay/sleep for the specified amount of milliseconds. */
 	virtual void delayMillis(uint msecs) = 0;
 
@@ -1381,6 +1401,75 @@ public:
 
 
 
+	/**
+	 * @name Thread handling
+	 * ResidualVM specific
+	 *
+	 * Worker threads for CPU heavy tasks which can be split into independent
+	 * jobs, like software rendering or video decoding. Engines should not use
+	 * these directly but go through Common::WorkerPool.
+	 *
+	 * Support is optional: the default implementation cannot create threads,
+	 * in which case all the work is done on the calling thread. Worker threads
+	 * must not call any OSystem method other than the mutex, condition and
+	 * getMillis() ones.
+	 */
+	//@{
+
+	typedef struct OpaqueThread *ThreadRef;
+	typedef struct OpaqueCondition *ConditionRef;
+	typedef void (*ThreadProc)(void *param);
+
+	/**
+	 * Start a new thread running proc(param).
+	 * @return the newly created thread, or 0 if threads are not supported
+	 * or an error occurred.
+	 */
+	virtual ThreadRef createThread(ThreadProc proc, void *param) { return 0; }
+
+	/**
+	 * Wait for the given thread to return from its thread procedure and
+	 * release it.
+	 * @param thread	the thread to join.
+	 */
+	virtual void joinThread(ThreadRef thread) {}
+
+	/**
+	 * Return the number of logical CPUs available for worker threads.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/**
+	 * Create a new condition variable.
+	 * @return the newly created condition, or 0 if an error occurred.
+	 */
+	virtual ConditionRef createCondition() { return 0; }
+
+	/**
+	 * Atomically unlock the mutex and wait for the condition to be
+	 * broadcasted, then lock the mutex again. The mutex must be locked
+	 * exactly once by the calling thread.
+	 * @param cond	the condition to wait for.
+	 * @param mutex	the mutex protecting the state tied to the condition.
+	 */
+	virtual void waitCondition(ConditionRef cond, MutexRef mutex) {}
+
+	/**
+	 * Wake up all the threads waiting for the given condition.
+	 * @param cond	the condition to broadcast.
+	 */
+	virtual void broadcastCondition(ConditionRef cond) {}
+
+	/**
+	 * Delete the given condition. No thread may be waiting for it.
+	 * @param cond	the condition to delete.
+	 */
+	virtual void deleteCondition(ConditionRef cond) {}
+
+	//@}
+
+
+
 	/** @name Sound */
 	//@{
 
@@ -0,0 +1,168 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/workerpool.h"
+
+namespace Common {
+
+WorkerPool::WorkerPool(uint threadCount) : _queueCondition(0), _doneCondition(0), _runningJobs(0), _quit(false) {
+	assert(g_system);
+	_mutex = g_system->createMutex();
+
+	if (threadCount == 0)
+		return;
+
+	_queueCondition = g_system->createCondition();
+	_doneCondition = g_system->createCondition();
+	if (!_queueCondition || !_doneCondition)
+		return;
+
+	for (uint i = 0; i < threadCount; i++) {
+		OSystem::ThreadRef thread = g_system->createThread(workerProc, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	waitAll();
+
+	g_system->lockMutex(_mutex);
+	_quit = true;
+	if (_queueCondition)
+		g_system->broadcastCondition(_queueCondition);
+	g_system->unlockMutex(_mutex);
+
+	for (uint i = 0; i < _threads.size(); i++) {
+		g_system->joinThread(_threads[i]);
+	}
+
+	if (_queueCondition)
+		g_system->deleteCondition(_queueCondition);
+	if (_doneCondition)
+		g_system->deleteCondition(_doneCondition);
+	g_system->deleteMutex(_mutex);
+}
+
+uint WorkerPool::getDefaultThreadCount() {
+	uint cpus = g_system->getCPUCount();
+	return cpus > 1 ? cpus - 1 : 0;
+}
+
+void WorkerPool::workerProc(void *param) {
+	WorkerPool *pool = (WorkerPool *)param;
+
+	g_system->lockMutex(pool->_mutex);
+	while (true) {
+		while (pool->_queue.empty() && !pool->_quit) {
+			g_system->waitCondition(pool->_queueCondition, pool->_mutex);
+		}
+
+		if (pool->_queue.empty())
+			break;
+
+		WorkerJob *job = pool->_queue.front();
+		pool->_queue.pop_front();
+		pool->runJob(job);
+	}
+	g_system->unlockMutex(pool->_mutex);
+}
+
+void WorkerPool::runJob(WorkerJob *job) {
+	// Called with the mutex locked, which is released while the job executes
+	job->_state = WorkerJob::kJobRunning;
+	_runningJobs++;
+
+	g_system->unlockMutex(_mutex);
+	job->execute();
+	g_system->lockMutex(_mutex);
+
+	job->_state = WorkerJob::kJobDone;
+	_runningJobs--;
+	if (_doneCondition)
+		g_system->broadcastCondition(_doneCondition);
+}
+
+void WorkerPool::queue(WorkerJob *job) {
+	g_system->lockMutex(_mutex);
+	assert(job->_state != WorkerJob::kJobQueued && job->_state != WorkerJob::kJobRunning);
+
+	if (_threads.empty()) {
+		runJob(job);
+	} else {
+		job->_state = WorkerJob::kJobQueued;
+		_queue.push_back(job);
+		g_system->broadcastCondition(_queueCondition);
+	}
+	g_system->unlockMutex(_mutex);
+}
+
+bool WorkerPool::isDone(WorkerJob *job) {
+	g_system->lockMutex(_mutex);
+	bool done = job->_state == WorkerJob::kJobDone;
+	g_system->unlockMutex(_mutex);
+	return done;
+}
+
+void WorkerPool::wait(WorkerJob *job) {
+	g_system->lockMutex(_mutex);
+	if (job->_state == WorkerJob::kJobQueued) {
+		_queue.remove(job);
+		runJob(job);
+	}
+	while (job->_state == WorkerJob::kJobRunning) {
+		g_system->waitCondition(_doneCondition, _mutex);
+	}
+	g_system->unlockMutex(_mutex);
+}
+
+bool WorkerPool::cancel(WorkerJob *job) {
+	g_system->lockMutex(_mutex);
+	bool cancelled = false;
+	if (job->_state == WorkerJob::kJobQueued) {
+		_queue.remove(job);
+		job->_state = WorkerJob::kJobIdle;
+		cancelled = true;
+	}
+	while (job->_state == WorkerJob::kJobRunning) {
+		g_system->waitCondition(_doneCondition, _mutex);
+	}
+	g_system->unlockMutex(_mutex);
+	return cancelled;
+}
+
+void WorkerPool::waitAll() {
+	g_system->lockMutex(_mutex);
+	while (!_queue.empty()) {
+		WorkerJob *job = _queue.front();
+		_queue.pop_front();
+		runJob(job);
+	}
+	while (_runningJobs > 0) {
+		g_system->waitCondition(_doneCondition, _mutex);
+	}
+	g_system->unlockMutex(_mutex);
+}
+
+} // End of namespace Common
@@ -0,0 +1,143 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef COMMON_WORKERPOOL_H
+#define COMMON_WORKERPOOL_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/list.h"
+#include "common/noncopyable.h"
+#include "common/system.h"
+
+namespace Common {
+
+class WorkerPool;
+
+/**
+ * A unit of work which can be run on a WorkerPool thread.
+ * The job object is owned by the caller and must stay alive
+ * until the pool is done with it.
+ */
+class WorkerJob {
+public:
+	WorkerJob() : _state(kJobIdle) {}
+	virtual ~WorkerJob() {}
+
+	/**
+	 * Do the work. Called on a worker thread, or on the calling thread
+	 * if no worker picked up the job in time.
+	 */
+	virtual void execute() = 0;
+
+private:
+	friend class WorkerPool;
+
+	enum JobState {
+		kJobIdle,
+		kJobQueued,
+		kJobRunning,
+		kJobDone
+	};
+
+	JobState _state;
+};
+
+/**
+ * A fixed set of worker threads executing queued jobs in FIFO order.
+ *
+ * When the backend does not support threads (see OSystem::createThread()),
+ * or the pool was created without threads, queue() executes the job
+ * immediately on the calling thread, so callers don't need a separate
+ * sequential code path.
+ */
+class WorkerPool : NonCopyable {
+public:
+	/**
+	 * Start the worker threads.
+	 * @param threadCount	number of threads to start, 0 to run all the jobs
+	 *						on the calling thread.
+	 */
+	explicit WorkerPool(uint threadCount);
+
+	/**
+	 * Wait for all the queued jobs, then stop the worker threads.
+	 */
+	~WorkerPool();
+
+	/**
+	 * Return the number of worker threads actually running.
+	 */
+	uint getThreadCount() const { return _threads.size(); }
+
+	/**
+	 * Queue a job. The job must not be queued or running already.
+	 */
+	void queue(WorkerJob *job);
+
+	/**
+	 * Check whether the job has finished executing.
+	 */
+	bool isDone(WorkerJob *job);
+
+	/**
+	 * Wait for the job to finish. A job no worker has started yet is
+	 * executed on the calling thread.
+	 */
+	void wait(WorkerJob *job);
+
+	/**
+	 * Remove a job from the queue if no worker has started it yet,
+	 * otherwise wait for it to finish.
+	 * @return true if the job was removed without being executed.
+	 */
+	bool cancel(WorkerJob *job);
+
+	/**
+	 * Wait for all the queued jobs to finish, helping the workers
+	 * with the ones not started yet.
+	 */
+	void waitAll();
+
+	/**
+	 * Return the number of threads worth starting for CPU bound jobs
+	 * on this system, the calling thread not included.
+	 */
+	static uint getDefaultThreadCount();
+
+private:
+	static void workerProc(void *param);
+	void runJob(WorkerJob *job);
+
+	OSystem::MutexRef _mutex;
+	OSystem::ConditionRef _queueCondition;
+	OSystem::ConditionRef _doneCondition;
+	List<WorkerJob *> _queue;
+	Array<OSystem::ThreadRef> _threads;
+	uint _runningJobs;
+	bool _quit;
+};
+
+} // End of namespace Common
+
+#endif
@@ -22,10 +22,16 @@
 
 #include "common/config-manager.h"
 #include "graphics/renderer.h"
+#include "graphics/tinygl/zdirtyrect.h"
+#include "graphics/tinygl/ztile.h"
 
 #include "engines/grim/debugger.h"
+#include "engines/grim/gfx_base.h"
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
+#include "engines/grim/resource.h"
+#include "engines/grim/lua/lgc.h"
+#include "engines/grim/lua/lmem.h"
 
 namespace Grim {
 
@@ -38,6 +44,11 @@ Debugger::Debugger() :
 	registerCmd("set_renderer", WRAP_METHOD(Debugger, cmd_set_renderer));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("tinygl_tiles", WRAP_METHOD(Debugger, cmd_tinygl_tiles));
+	registerCmd("tinygl_dirtyrects", WRAP_METHOD(Debugger, cmd_tinygl_dirtyrects));
+	registerCmd("resource_cache", WRAP_METHOD(Debugger, cmd_resource_cache));
+	registerCmd("lua_gc", WRAP_METHOD(Debugger, cmd_lua_gc));
+	registerCmd("lua_mem", WRAP_METHOD(Debugger, cmd_lua_mem));
 }
 
 Debugger::~Debugger() {
@@ -127,4 +138,99 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_tinygl_tiles(int argc, const char **argv) {
+	Common::Array<TinyGL::TileStatistics> stats;
+	TinyGL::tglGetTileStatistics(stats);
+	if (stats.empty()) {
+		debugPrintf("Tile rendering is disabled, see the 'renderthreads' option\n");
+		return true;
+	}
+
+	uint drawCalls = 0;
+	uint32 frameTime = 0;
+	for (uint i = 0; i < stats.size(); i++) {
+		const TinyGL::TileStatistics &tile = stats[i];
+		debugPrintf("(%d, %d)-(%d, %d): %u draw calls, %u ms, %u ms total\n",
+		            tile.rect.left, tile.rect.top, tile.rect.right, tile.rect.bottom,
+		            tile.drawCalls, tile.frameTime, tile.totalTime);
+		drawCalls += tile.drawCalls;
+		frameTime += tile.frameTime;
+	}
+	debugPrintf("%u tiles: %u draw calls, %u ms\n", stats.size(), drawCalls, frameTime);
+	return true;
+}
+
+bool Debugger::cmd_tinygl_dirtyrects(int argc, const char **argv) {
+	if (g_driver->isHardwareAccelerated() || !ConfMan.getBool("dirtyrects")) {
+		debugPrintf("Dirty rectangles are only used by the software renderer, see the 'dirtyrects' option\n");
+		return true;
+	}
+
+	TinyGL::DirtyRectStatistics stats;
+	TinyGL::tglGetDirtyRectStatistics(stats);
+	debugPrintf("Last frame: %u rectangles merged into %u, %u bin lookups, %u draw call executions\n",
+	            stats.sourceRectangles, stats.rectangles, stats.binLookups, stats.drawCallExecutions);
+	debugPrintf("%u frames, %u ms spent merging\n", stats.frames, stats.totalTime);
+	return true;
+}
+
+bool Debugger::cmd_lua_gc(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!strcmp(argv[1], "incremental") || !strcmp(argv[1], "full")) {
+			luaC_setincremental(!strcmp(argv[1], "incremental"));
+		} else if (!strcmp(argv[1], "reset")) {
+			luaC_resetstatistics();
+		} else {
+			debugPrintf("Usage: lua_gc [incremental|full|reset]\n");
+		}
+		return true;
+	}
+
+	const GCStatistics &stats = luaC_getstatistics();
+	debugPrintf("%s collector: %u cycles, %u incremental steps\n", luaC_isincremental() ? "Incremental" : "Full",
+	            stats.cycles, stats.steps);
+	for (int i = 0; i < GCStatistics::kPauseBuckets; i++) {
+		if (i == GCStatistics::kPauseBuckets - 1)
+			debugPrintf("  >= %5d us: %u\n", GCStatistics::kFirstPauseBucket << (i - 1), stats.pauses[i]);
+		else
+			debugPrintf("  <  %5d us: %u\n", GCStatistics::kFirstPauseBucket << i, stats.pauses[i]);
+	}
+	debugPrintf("Longest pause %u us, most objects traversed in a pause %u\n", stats.maxPause, stats.maxWork);
+	return true;
+}
+
+bool Debugger::cmd_lua_mem(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!strcmp(argv[1], "trim")) {
+			luaM_trimpools();
+		} else if (!strcmp(argv[1], "reset")) {
+			luaM_resetstatistics();
+		} else {
+			debugPrintf("Usage: lua_mem [trim|reset]\n");
+		}
+		return true;
+	}
+
+	const MemStatistics &stats = luaM_getstatistics();
+	debugPrintf("Lua pools: %u blocks, %u of %u KB in use\n", stats.blocksInUse, stats.bytesInUse / 1024,
+	            stats.bytesReserved / 1024);
+	debugPrintf("%u allocations, %u frees, %u too large for a pool\n", stats.allocs, stats.frees, stats.largeAllocs);
+	debugPrintf("%u chunks allocated, %u released\n", stats.chunkAllocs, stats.chunkFrees);
+	return true;
+}
+
+bool Debugger::cmd_resource_cache(int argc, const char **argv) {
+	if (!g_resourceloader) {
+		debugPrintf("The resource loader is not running\n");
+		return true;
+	}
+
+	ResourceLoader::CacheStatistics stats = g_resourceloader->getCacheStatistics();
+	uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("Resource cache: %u files, %u of %u KB resident\n", stats.entries, stats.residentBytes / 1024, stats.budget / 1024);
+	debugPrintf("%u hits, %u misses (%.1f%% hit rate), %u evictions\n", stats.hits, stats.misses,
+	            lookups ? 100.0f * stats.hits / lookups : 0.0f, stats.evictions);
+	return true;
+}
+
 }
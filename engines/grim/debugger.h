@@ -40,6 +40,11 @@ public:
 	bool cmd_set_renderer(int argc, const char **argv);
 	bool cmd_save(int argc, const char **argv);
 	bool cmd_load(int argc, const char **argv);
+	bool cmd_tinygl_tiles(int argc, const char **argv);
+	bool cmd_tinygl_dirtyrects(int argc, const char **argv);
+	bool cmd_resource_cache(int argc, const char **argv);
+	bool cmd_lua_gc(int argc, const char **argv);
+	bool cmd_lua_mem(int argc, const char **argv);
 };
 
 }
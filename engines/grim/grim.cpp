@@ -105,6 +105,8 @@ GrimEngine::GrimEngine(OSystem *syst, uint32 gameFlags, GrimGameType gameType, C
 
 	//Set default settings
 	ConfMan.registerDefault("use_arb_shaders", true);
+	ConfMan.registerDefault("resource_cache_size", 65536);
+	ConfMan.registerDefault("lua_incremental_gc", true);
 
 	_showFps = ConfMan.getBool("show_fps");
 
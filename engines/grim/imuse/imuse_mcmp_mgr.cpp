@@ -31,19 +31,26 @@ namespace Grim {
 
 uint16 imuseDestTable[5786];
 
-McmpMgr::McmpMgr() {
+void McmpMgr::DecodedBlock::execute() {
+	decompressVima(_input, (int16 *)_output, _size, imuseDestTable);
+}
+
+McmpMgr::McmpMgr(Common::WorkerPool *decodePool) {
 	_compTable = nullptr;
 	_numCompItems = 0;
 	_curSample = -1;
-	_compInput = nullptr;
-	_outputSize = 0;
 	_file = nullptr;
-	_lastBlock = -1;
+	_useCounter = 0;
+	_decodePool = decodePool;
 }
 
 McmpMgr::~McmpMgr() {
+	// The look-ahead jobs must be off the worker before the blocks go away
+	for (int i = 0; i < kCachedBlocks; i++) {
+		if (_cache[i]._pending)
+			_decodePool->cancel(&_cache[i]);
+	}
 	delete[] _compTable;
-	delete[] _compInput;
 }
 
 bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData) {
@@ -82,7 +89,9 @@ bool McmpMgr::openSound(const char *filename, Common::SeekableReadStream *data,
 	}
 	_file->seek(sizeCodecs, SEEK_CUR);
 	// hack: two more bytes at the end of input buffer
-	_compInput = new byte[maxSize + 2];
+	for (i = 0; i < kCachedBlocks; i++) {
+		_cache[i]._input = new byte[maxSize + 2];
+	}
 	offsetData = headerSize;
 
 	return true;
@@ -110,21 +119,9 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 	final_size = 0;
 
 	for (i = first_block; i <= last_block; i++) {
-		if (_lastBlock != i) {
-			// hack: two more zero bytes at the end of input buffer
-			_compInput[_compTable[i].compSize] = 0;
-			_compInput[_compTable[i].compSize + 1] = 0;
-			_file->seek(_compTable[i].offset, SEEK_SET);
-			_file->read(_compInput, _compTable[i].compSize);
-			decompressVima(_compInput, (int16 *)_compOutput, _compTable[i].decompSize, imuseDestTable);
-			_outputSize = _compTable[i].decompSize;
-			if (_outputSize > 0x2000) {
-				error("McmpMgr::decompressSample() _outputSize: %d", _outputSize);
-			}
-			_lastBlock = i;
-		}
+		const DecodedBlock *block = getBlock(i);
 
-		output_size = _outputSize - skip;
+		output_size = block->_size - skip;
 
 		if ((output_size + skip) > 0x2000) // workaround
 			output_size -= (output_size + skip) - 0x2000;
@@ -134,7 +131,7 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 
 		assert(final_size + output_size <= blocks_final_size);
 
-		memcpy(*comp_final + final_size, _compOutput + skip, output_size);
+		memcpy(*comp_final + final_size, block->_output + skip, output_size);
 		final_size += output_size;
 
 		size -= output_size;
@@ -148,4 +145,90 @@ int32 McmpMgr::decompressSample(int32 offset, int32 size, byte **comp_final) {
 	return final_size;
 }
 
+const McmpMgr::DecodedBlock *McmpMgr::getBlock(int block) {
+	DecodedBlock *entry = nullptr;
+	for (int i = 0; i < kCachedBlocks; i++) {
+		if (_cache[i]._block == block) {
+			entry = &_cache[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		entry = allocBlock(nullptr);
+		readBlock(entry, block);
+		entry->execute();
+	} else if (entry->_pending) {
+		// Usually done already, otherwise this finishes the decode here
+		_decodePool->wait(entry);
+		entry->_pending = false;
+	}
+	entry->_lastUse = ++_useCounter;
+
+	if (_decodePool) {
+		for (int i = 1; i <= kLookAheadBlocks; i++) {
+			prefetchBlock(block + i, entry);
+		}
+	}
+
+	return entry;
+}
+
+McmpMgr::DecodedBlock *McmpMgr::allocBlock(const DecodedBlock *keep) {
+	// Reuse the least recently used block which is not being decoded
+	DecodedBlock *entry = nullptr;
+	for (int i = 0; i < kCachedBlocks; i++) {
+		if (_cache[i]._pending && _decodePool->isDone(&_cache[i]))
+			_cache[i]._pending = false;
+		if (&_cache[i] != keep && !_cache[i]._pending && (!entry || _cache[i]._lastUse < entry->_lastUse))
+			entry = &_cache[i];
+	}
+
+	// Only when the worker falls far behind: drop the oldest look-ahead
+	if (!entry) {
+		for (int i = 0; i < kCachedBlocks; i++) {
+			if (&_cache[i] != keep && (!entry || _cache[i]._lastUse < entry->_lastUse))
+				entry = &_cache[i];
+		}
+		_decodePool->cancel(entry);
+		entry->_pending = false;
+	}
+
+	entry->_block = -1;
+	return entry;
+}
+
+void McmpMgr::readBlock(DecodedBlock *entry, int block) {
+	const CompTable &item = _compTable[block];
+	if (item.decompSize > 0x2000) {
+		error("McmpMgr::readBlock() decompSize: %d", item.decompSize);
+	}
+
+	// hack: two more zero bytes at the end of input buffer
+	entry->_input[item.compSize] = 0;
+	entry->_input[item.compSize + 1] = 0;
+	_file->seek(item.offset, SEEK_SET);
+	_file->read(entry->_input, item.compSize);
+
+	entry->_block = block;
+	entry->_size = item.decompSize;
+}
+
+void McmpMgr::prefetchBlock(int block, const DecodedBlock *keep) {
+	if (block >= _numCompItems)
+		return;
+
+	for (int i = 0; i < kCachedBlocks; i++) {
+		if (_cache[i]._block == block)
+			return;
+	}
+
+	// Read on this thread, only the decoding runs on the worker
+	DecodedBlock *entry = allocBlock(keep);
+	readBlock(entry, block);
+	entry->_lastUse = _useCounter;
+	entry->_pending = true;
+	_decodePool->queue(entry);
+}
+
 } // end of namespace Grim
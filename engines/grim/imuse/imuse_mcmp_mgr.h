@@ -23,6 +23,8 @@
 #ifndef GRIM_MCMP_MGR_H
 #define GRIM_MCMP_MGR_H
 
+#include "common/workerpool.h"
+
 namespace Grim {
 
 class McmpMgr {
@@ -35,18 +37,51 @@ private:
 		int32 offset;
 	};
 
+	// Decoded blocks kept per sound, so loops over the same region don't decode again
+	enum {
+		kCachedBlocks = 6,
+		kLookAheadBlocks = 2
+	};
+
+	/**
+	 * A decoded block. The job decodes the compressed data already read into
+	 * _input, so a worker never touches the sound's stream.
+	 */
+	class DecodedBlock : public Common::WorkerJob {
+	public:
+		DecodedBlock() : _block(-1), _size(0), _input(nullptr), _pending(false), _lastUse(0) {}
+		~DecodedBlock() { delete[] _input; }
+
+		void execute() override;
+
+		int _block;
+		int32 _size;
+		byte *_input;
+		bool _pending;
+		uint32 _lastUse;
+		byte _output[0x2000];
+	};
+
 	CompTable *_compTable;
 	int16 _numCompItems;
 	int _curSample;
 	Common::SeekableReadStream *_file;
-	byte _compOutput[0x2000];
-	byte *_compInput;
-	int _outputSize;
-	int _lastBlock;
+	DecodedBlock _cache[kCachedBlocks];
+	uint32 _useCounter;
+	Common::WorkerPool *_decodePool;
+
+	const DecodedBlock *getBlock(int block);
+	DecodedBlock *allocBlock(const DecodedBlock *keep);
+	void readBlock(DecodedBlock *entry, int block);
+	void prefetchBlock(int block, const DecodedBlock *keep);
 
 public:
 
-	McmpMgr();
+	/**
+	 * @param decodePool	pool decoding the blocks ahead of playback,
+	 *						nullptr to decode them only when needed
+	 */
+	McmpMgr(Common::WorkerPool *decodePool = nullptr);
 	~McmpMgr();
 
 	bool openSound(const char *filename, Common::SeekableReadStream *data, int &offsetData);
@@ -22,6 +22,7 @@
 
 #include "common/endian.h"
 #include "common/stream.h"
+#include "common/workerpool.h"
 
 #include "engines/grim/resource.h"
 
@@ -35,12 +36,24 @@ ImuseSndMgr::ImuseSndMgr(bool demo) {
 	for (int l = 0; l < MAX_IMUSE_SOUNDS; l++) {
 		memset(&_sounds[l], 0, sizeof(SoundDesc));
 	}
+
+	// A single thread keeps well ahead of playback. Without threads the
+	// blocks are decoded when needed, as there is nothing to gain.
+	_decodePool = nullptr;
+	if (Common::WorkerPool::getDefaultThreadCount() > 0) {
+		_decodePool = new Common::WorkerPool(1);
+		if (_decodePool->getThreadCount() == 0) {
+			delete _decodePool;
+			_decodePool = nullptr;
+		}
+	}
 }
 
 ImuseSndMgr::~ImuseSndMgr() {
 	for (int l = 0; l < MAX_IMUSE_SOUNDS; l++) {
 		closeSound(&_sounds[l]);
 	}
+	delete _decodePool;
 }
 
 void ImuseSndMgr::countElements(SoundDesc *sound) {
@@ -198,7 +211,7 @@ ImuseSndMgr::SoundDesc *ImuseSndMgr::openSound(const char *soundName, int volGro
 		sound->headerSize = headerSize;
 	} else if (scumm_stricmp(extension, "wav") == 0 || scumm_stricmp(extension, "imc") == 0 ||
 			(_demo && scumm_stricmp(extension, "imu") == 0)) {
-		sound->mcmpMgr = new McmpMgr();
+		sound->mcmpMgr = new McmpMgr(_decodePool);
 		if (!sound->mcmpMgr->openSound(soundName, sound->inStream, headerSize)) {
 			closeSound(sound);
 			return nullptr;
@@ -26,6 +26,10 @@
 #include "audio/mixer.h"
 #include "audio/audiostream.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Grim {
 
 class McmpMgr;
@@ -83,6 +87,8 @@ private:
 
 	SoundDesc _sounds[MAX_IMUSE_SOUNDS];
 	bool _demo;
+	// Decodes compressed sound blocks ahead of playback, shared by all the sounds
+	Common::WorkerPool *_decodePool;
 
 	bool checkForProperHandle(SoundDesc *soundDesc);
 	SoundDesc *allocSlot();
@@ -21,6 +21,7 @@
  */
 
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/substream.h"
 #include "common/memstream.h"
 
@@ -29,6 +30,19 @@
 
 namespace Grim {
 
+/**
+ * Reads a member straight out of the mapped LAB file, and keeps the
+ * mapping alive for as long as the stream exists.
+ */
+class LabMappedStream : public Common::MemoryReadStream {
+public:
+	LabMappedStream(const Common::SharedPtr<Common::FileMapping> &mapping, uint32 offset, uint32 len) :
+			Common::MemoryReadStream(mapping->getData() + offset, len), _mapping(mapping) {}
+
+private:
+	Common::SharedPtr<Common::FileMapping> _mapping;
+};
+
 LabEntry::LabEntry(const Common::String &name, uint32 offset, uint32 len, Lab *parent) :
 		_offset(offset), _len(len), _parent(parent), _name(name) {
 	_name.toLowercase();
@@ -62,7 +76,9 @@ bool Lab::open(const Common::String &filename, bool keepStream) {
 		else
 			parseMonkey4FileTable(file);
 	}
-	if (result && keepStream) {
+	if (result)
+		mapFile(filename);
+	if (result && keepStream && !_mapping) {
 		file->seek(0, SEEK_SET);
 		byte *data = static_cast<byte*>(malloc(sizeof(byte) * file->size()));
 		file->read(data, file->size());
@@ -73,6 +89,18 @@ bool Lab::open(const Common::String &filename, bool keepStream) {
 	return result;
 }
 
+void Lab::mapFile(const Common::String &filename) {
+	// Only LABs that live directly on a filesystem can be mapped
+	Common::ArchiveMemberPtr member = SearchMan.getMember(filename);
+	const Common::FSNode *node = dynamic_cast<const Common::FSNode *>(member.get());
+	if (!node)
+		return;
+
+	Common::FileMapping *mapping = node->createReadMapping();
+	if (mapping)
+		_mapping = Common::SharedPtr<Common::FileMapping>(mapping);
+}
+
 void Lab::parseGrimFileTable(Common::File *file) {
 	uint32 entryCount = file->readUint32LE();
 	uint32 stringTableSize = file->readUint32LE();
@@ -180,6 +208,14 @@ Common::SeekableReadStream *Lab::createReadStreamForMember(const Common::String
 	fname.toLowercase();
 	LabEntryPtr i = _entries[fname];
 
+	if (_mapping) {
+		if (i->_offset <= _mapping->getSize() && i->_len <= _mapping->getSize() - i->_offset)
+			return new LabMappedStream(_mapping, i->_offset, i->_len);
+
+		// Reading past the end of a mapping crashes, the file stream just returns a short read
+		warning("Lab::createReadStreamForMember(): %s is out of the bounds of %s", filename.c_str(), _labFileName.c_str());
+	}
+
 	if (!_stream) {
 		Common::File *file = new Common::File();
 		file->open(_labFileName);
@@ -27,6 +27,7 @@
 
 namespace Common {
 	class File;
+	class FileMapping;
 }
 
 namespace Grim {
@@ -58,12 +59,15 @@ public:
 private:
 	void parseGrimFileTable(Common::File *_f);
 	void parseMonkey4FileTable(Common::File *_f);
+	void mapFile(const Common::String &filename);
 
 	Common::String _labFileName;
 	typedef Common::SharedPtr<LabEntry> LabEntryPtr;
 	typedef Common::HashMap<Common::String, LabEntryPtr, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> LabMap;
 	LabMap _entries;
 	Common::SeekableReadStream *_stream;
+	// Whole LAB file mapped into memory, shared with the member streams
+	Common::SharedPtr<Common::FileMapping> _mapping;
 };
 
 } // end of namespace Grim
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/endian.h"
 #include "common/foreach.h"
 #include "common/system.h"
@@ -44,6 +45,7 @@
 #include "engines/grim/primitives.h"
 
 #include "engines/grim/lua/lauxlib.h"
+#include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/luadebug.h"
 #include "engines/grim/lua/lualib.h"
 
@@ -110,6 +112,8 @@ LuaBase::LuaBase() :
 		_translationMode(0), _frameTimeCollection(0) {
 	s_instance = this;
 
+	luaC_setincremental(ConfMan.getBool("lua_incremental_gc"));
+
 	lua_iolibopen();
 	lua_strlibopen();
 	lua_mathlibopen();
@@ -264,7 +268,9 @@ void LuaBase::update(int frameTime, int movieTime) {
 	_frameTimeCollection += frameTime;
 	if (_frameTimeCollection > 10000) {
 		_frameTimeCollection = 0;
-		lua_collectgarbage(0);
+		// In incremental mode this only starts a cycle, which the
+		// following frames finish
+		luaC_startcycle();
 	}
 
 	lua_beginblock();
@@ -18,7 +18,7 @@ namespace Grim {
 
 
 Closure *luaF_newclosure(int32 nelems) {
-	Closure *c = (Closure *)luaM_malloc(sizeof(Closure) + nelems * sizeof(TObject));
+	Closure *c = (Closure *)luaM_poolalloc(sizeof(Closure) + nelems * sizeof(TObject));
 	luaO_insertlist(&rootcl, (GCnode *)c);
 	nblocks += gcsizeclosure(c);
 	c->nelems = nelems;
@@ -26,7 +26,7 @@ Closure *luaF_newclosure(int32 nelems) {
 }
 
 TProtoFunc *luaF_newproto() {
-	TProtoFunc *f = luaM_new(TProtoFunc);
+	TProtoFunc *f = luaM_newobject(TProtoFunc);
 	f->code = nullptr;
 	f->lineDefined = 0;
 	f->fileName = nullptr;
@@ -42,7 +42,7 @@ static void freefunc(TProtoFunc *f) {
 	luaM_free(f->code);
 	luaM_free(f->locvars);
 	luaM_free(f->consts);
-	luaM_free(f);
+	luaM_freeobject(f, TProtoFunc);
 }
 
 void luaF_freeproto(TProtoFunc *l) {
@@ -59,7 +59,7 @@ void luaF_freeclosure(Closure *l) {
 	while (l) {
 		Closure *next = (Closure *)l->head.next;
 		nblocks -= gcsizeclosure(l);
-		luaM_free(l);
+		luaM_poolfree(l, sizeof(Closure) + l->nelems * sizeof(TObject));
 		l = next;
 	}
 }
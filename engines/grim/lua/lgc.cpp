@@ -6,6 +6,8 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
 #define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
 
+#include "common/system.h"
+
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lfunc.h"
 #include "engines/grim/lua/lgc.h"
@@ -21,6 +23,61 @@ namespace Grim {
 
 static int32 markobject (TObject *o);
 
+/*
+** =======================================================
+** Incremental collection
+** =======================================================
+** Tables, closures and prototypes are white (marked == 0) until they
+** are reached, gray (GC_GRAY) while they wait on the gray stack to be
+** traversed, and black (marked == 1) afterwards. Strings have no
+** references, so they go straight to black. In incremental mode the
+** gray stack is drained a bounded amount of work at a time; a black
+** table that gets a new entry is turned back to gray (see luaH_set)
+** and kept aside to be traversed again when the cycle finishes, so that
+** a table written all the time does not eat every step. A value stored
+** in a global is grayed right away. The other roots (stacks, locked
+** refs, tag methods) change without any barrier, so they are scanned
+** again in that last step too. The sweep is also done there, with the
+** mutator stopped, like in a full collection.
+*/
+
+#define GC_GRAY 2
+
+/* Objects traversed per incremental step */
+#define GC_STEP_WORK 2000
+
+enum GCPhase {
+	GCpause,   // no cycle running
+	GCmark     // the gray stack is being drained
+};
+
+static bool gcincremental = false;
+static GCPhase gcphase = GCpause;
+static TObject *graystack = nullptr;
+static int32 graysize = 0;
+static int32 graytop = 0;
+static Hash **grayagain = nullptr;  // black tables written during the cycle
+static int32 grayagainsize = 0;
+static int32 grayagaintop = 0;
+static int32 gcwork = 0;  // objects traversed in the current pause
+static GCStatistics gcstats;
+
+static void pushgray(TObject *o) {
+	if (graytop == graysize) {
+		graysize = graysize ? 2 * graysize : 256;
+		graystack = luaM_reallocvector(graystack, graysize, TObject);
+	}
+	graystack[graytop++] = *o;
+}
+
+static void graynode(GCnode *node, lua_Type type) {
+	TObject o;
+	node->marked = GC_GRAY;
+	ttype(&o) = type;
+	o.value.ts = (TaggedString *)node;  // all the pointers of Value share their storage
+	pushgray(&o);
+}
+
 /*
 ** =======================================================
 ** REF mechanism
@@ -150,43 +207,64 @@ static void strmark(TaggedString *s) {
 		s->head.marked = 1;
 }
 
-static void protomark(TProtoFunc *f) {
-	if (!f->head.marked) {
-		LocVar *v = f->locvars;
-		int32 i;
-		f->head.marked = 1;
-		if (f->fileName)
+static void prototraverse(TProtoFunc *f) {
+	LocVar *v = f->locvars;
+	int32 i;
+	f->head.marked = 1;
+	gcwork += f->nconsts + 1;
+	if (f->fileName)
 			strmark(f->fileName);
-		for (i = 0; i < f->nconsts; i++)
-			markobject(&f->consts[i]);
-		if (v) {
-			for (; v->line != -1; v++) {
-				if (v->varname)
-					strmark(v->varname);
-			}
+	for (i = 0; i < f->nconsts; i++)
+		markobject(&f->consts[i]);
+	if (v) {
+		for (; v->line != -1; v++) {
+			if (v->varname)
+				strmark(v->varname);
 		}
 	}
 }
 
-static void closuremark(Closure *f) {
-	if (!f->head.marked) {
-		int32 i;
-		f->head.marked = 1;
-		for (i = f->nelems; i >= 0; i--)
-			markobject(&f->consts[i]);
+static void closuretraverse(Closure *f) {
+	int32 i;
+	f->head.marked = 1;
+	gcwork += f->nelems + 1;
+	for (i = f->nelems; i >= 0; i--)
+		markobject(&f->consts[i]);
+}
+
+static void hashtraverse(Hash *h) {
+	int32 i;
+	h->head.marked = 1;
+	gcwork += nhash(h);
+	for (i = 0; i < nhash(h); i++) {
+		Node *n = node(h, i);
+		if (ttype(ref(n)) != LUA_T_NIL) {
+			markobject(&n->ref);
+			markobject(&n->val);
+		}
 	}
 }
 
-static void hashmark(Hash *h) {
-	if (!h->head.marked) {
-		int32 i;
-		h->head.marked = 1;
-		for (i = 0; i < nhash(h); i++) {
-			Node *n = node(h, i);
-			if (ttype(ref(n)) != LUA_T_NIL) {
-				markobject(&n->ref);
-				markobject(&n->val);
-			}
+/*
+** Traverse gray objects until the stack is empty or the work done in
+** this pause reaches the limit
+*/
+static void propagate(int32 limit) {
+	while (graytop > 0 && gcwork < limit) {
+		TObject *o = &graystack[--graytop];
+		switch (ttype(o)) {
+		case LUA_T_ARRAY:
+			hashtraverse(avalue(o));
+			break;
+		case LUA_T_CLOSURE:
+			closuretraverse(clvalue(o));
+			break;
+		case LUA_T_PROTO:
+			prototraverse(tfvalue(o));
+			break;
+		default:
+			LUA_INTERNALERROR("internal error");
+			break;
 		}
 	}
 }
@@ -207,15 +285,18 @@ static int32 markobject(TObject *o) {
 		strmark(tsvalue(o));
 		break;
 	case LUA_T_ARRAY:
-		hashmark(avalue(o));
+		if (!avalue(o)->head.marked)
+			graynode(&avalue(o)->head, LUA_T_ARRAY);
 		break;
 	case LUA_T_CLOSURE:
 	case LUA_T_CLMARK:
-		closuremark(o->value.cl);
+		if (!o->value.cl->head.marked)
+			graynode(&o->value.cl->head, LUA_T_CLOSURE);
 		break;
 	case LUA_T_PROTO:
 	case LUA_T_PMARK:
-		protomark(o->value.tf);
+		if (!o->value.tf->head.marked)
+			graynode(&o->value.tf->head, LUA_T_PROTO);
 		break;
 	default:
 		break;  // numbers, cprotos, etc
@@ -230,13 +311,22 @@ static void markall() {
 	luaT_travtagmethods(markobject);  // mark fallbacks
 }
 
-int32 lua_collectgarbage(int32 limit) {
+/*
+** Finish the current cycle, or do a whole one if none is running: mark
+** the roots again, drain the gray stack and sweep.
+*/
+static int32 finishcycle(int32 limit) {
 	int32 recovered = nblocks;  // to subtract nblocks after gc
 	Hash *freetable;
 	TaggedString *freestr;
 	TProtoFunc *freefunc;
 	Closure *freeclos;
 	markall();
+	for (int32 i = 0; i < grayagaintop; i++)
+		hashtraverse(grayagain[i]);
+	grayagaintop = 0;
+	propagate(MAX_INT);
+	gcphase = GCpause;
 	invalidaterefs();
 	freestr = luaS_collector();
 	freetable = (Hash *)listcollect(&roottable);
@@ -250,14 +340,141 @@ int32 lua_collectgarbage(int32 limit) {
 	luaS_free(freestr);
 	luaF_freeproto(freefunc);
 	luaF_freeclosure(freeclos);
+	luaM_trimpools();
 	recovered = recovered - nblocks;
 	GCthreshold = (limit == 0) ? 2 * nblocks : nblocks + limit;
+	gcstats.cycles++;
+	return recovered;
+}
+
+static void startcycle() {
+	gcphase = GCmark;
+	markall();
+	// Let the allocations made during the cycle trigger steps too, so
+	// that marking keeps up with scripts that allocate quickly
+	GCthreshold = nblocks + GARBAGE_BLOCK;
+}
+
+static void step() {
+	propagate(gcwork + GC_STEP_WORK);
+	if (graytop == 0)
+		finishcycle(0);
+	else
+		GCthreshold = nblocks + GARBAGE_BLOCK;
+	gcstats.steps++;
+}
+
+static void beginpause() {
+	gcwork = 0;
+}
+
+static void endpause(uint64 startTime) {
+	uint32 time = (uint32)(g_system->getMicros() - startTime);
+	int32 bucket = 0;
+	while (bucket < GCStatistics::kPauseBuckets - 1 && time >= ((uint32)GCStatistics::kFirstPauseBucket << bucket))
+		bucket++;
+	gcstats.pauses[bucket]++;
+	gcstats.maxPause = MAX(gcstats.maxPause, time);
+	gcstats.maxWork = MAX<uint32>(gcstats.maxWork, gcwork);
+}
+
+int32 lua_collectgarbage(int32 limit) {
+	uint64 startTime = g_system->getMicros();
+	beginpause();
+	int32 recovered = finishcycle(limit);
+	endpause(startTime);
 	return recovered;
 }
 
 void luaC_checkGC() {
-	if (nblocks >= GCthreshold)
+	if (nblocks < GCthreshold)
+		return;
+	if (!gcincremental) {
+		lua_collectgarbage(0);
+		return;
+	}
+
+	uint64 startTime = g_system->getMicros();
+	beginpause();
+	if (gcphase == GCpause)
+		startcycle();
+	else
+		step();
+	endpause(startTime);
+}
+
+void luaC_step() {
+	if (gcphase != GCmark)
+		return;
+
+	uint64 startTime = g_system->getMicros();
+	beginpause();
+	step();
+	endpause(startTime);
+}
+
+void luaC_startcycle() {
+	if (!gcincremental) {
+		lua_collectgarbage(0);
+		return;
+	}
+	if (gcphase != GCpause)
+		return;
+
+	uint64 startTime = g_system->getMicros();
+	beginpause();
+	startcycle();
+	endpause(startTime);
+}
+
+void luaC_barrierback(Hash *t) {
+	if (gcphase != GCmark)
+		return;
+	if (grayagaintop == grayagainsize) {
+		grayagainsize = grayagainsize ? 2 * grayagainsize : 64;
+		grayagain = luaM_reallocvector(grayagain, grayagainsize, Hash *);
+	}
+	t->head.marked = GC_GRAY;
+	grayagain[grayagaintop++] = t;
+}
+
+void luaC_barrierglobal(TObject *o) {
+	if (gcphase == GCmark)
+		markobject(o);
+}
+
+void luaC_setincremental(bool incremental) {
+	if (!incremental && gcphase != GCpause)
 		lua_collectgarbage(0);
+	gcincremental = incremental;
+}
+
+bool luaC_isincremental() {
+	return gcincremental;
+}
+
+void luaC_resetgc() {
+	gcphase = GCpause;
+	graytop = 0;
+	grayagaintop = 0;
+}
+
+void luaC_freegc() {
+	luaC_resetgc();
+	luaM_free(graystack);
+	graystack = nullptr;
+	graysize = 0;
+	luaM_free(grayagain);
+	grayagain = nullptr;
+	grayagainsize = 0;
+}
+
+const GCStatistics &luaC_getstatistics() {
+	return gcstats;
+}
+
+void luaC_resetstatistics() {
+	gcstats = GCStatistics();
 }
 
 } // end of namespace Grim
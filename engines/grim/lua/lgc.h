@@ -11,7 +11,40 @@
 
 namespace Grim {
 
+/* Timing of the collector pauses, see luaC_getstatistics() */
+struct GCStatistics {
+	enum {
+		kPauseBuckets = 10,
+		kFirstPauseBucket = 64  // upper bound of the first bucket, in microseconds
+	};
+
+	GCStatistics() : cycles(0), steps(0), maxPause(0), maxWork(0) {
+		for (int i = 0; i < kPauseBuckets; i++)
+			pauses[i] = 0;
+	}
+
+	uint32 cycles;  // completed collections
+	uint32 steps;   // incremental steps
+	// Pauses by duration: under 64, 128, 256... microseconds, and 16384 microseconds or more
+	uint32 pauses[kPauseBuckets];
+	uint32 maxPause;  // longest pause, in microseconds
+	uint32 maxWork;   // most objects traversed in a pause
+};
+
 void luaC_checkGC();
+void luaC_step();
+void luaC_startcycle();
+void luaC_barrierback(Hash *t);
+void luaC_barrierglobal(TObject *o);
+void luaC_setincremental(bool incremental);
+bool luaC_isincremental();
+void luaC_resetgc();
+void luaC_freegc();
+const GCStatistics &luaC_getstatistics();
+void luaC_resetstatistics();
+
+/* A black table that gets a new entry has to be traversed again */
+#define luaC_tablebarrier(t)	{ if ((t)->head.marked == 1) luaC_barrierback(t); }
 TObject* luaC_getref(int32 r);
 int32 luaC_ref(TObject *o, int32 lock);
 void luaC_hashcallIM(Hash *l);
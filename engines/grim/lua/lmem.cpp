@@ -6,6 +6,8 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_setjmp
 #define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
 
+#include "common/algorithm.h"
+
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/lstate.h"
 #include "engines/grim/lua/lua.h"
@@ -22,6 +24,211 @@ int32 luaM_growaux(void **block, int32 nelems, int32 size, const char *errormsg,
 	return (int32)nelems;
 }
 
+/*
+** =======================================================
+** Pooled allocation
+** =======================================================
+** Blocks up to POOL_MAXSIZE bytes are rounded up to a multiple of
+** POOL_GRANULE and carved out of POOL_CHUNKSIZE chunks, one set of
+** chunks per size. Freed blocks go to a free list of their size. After
+** the collector has swept, luaM_trimpools() gives back to the system
+** the chunks whose blocks are all free.
+*/
+
+#define POOL_GRANULE	8
+#define POOL_MAXSIZE	512
+#define POOL_CLASSES	(POOL_MAXSIZE / POOL_GRANULE)
+#define POOL_CHUNKSIZE	16384
+
+struct PoolBlock {
+	PoolBlock *next;
+};
+
+struct PoolChunk {
+	PoolChunk *next;
+	double align;  // keep the blocks that follow aligned
+};
+
+struct PoolClass {
+	PoolBlock *freelist;
+	PoolChunk *chunks;
+	int32 nchunks;
+	int32 nfree;  // blocks in the free list
+};
+
+#define chunkblocks(c)	((int32)((POOL_CHUNKSIZE - sizeof(PoolChunk)) / (((c) + 1) * POOL_GRANULE)))
+
+static PoolClass pools[POOL_CLASSES];
+static MemStatistics memstats;
+
+static int32 sizeclass(int32 size) {
+	return (size + POOL_GRANULE - 1) / POOL_GRANULE - 1;
+}
+
+static void newchunk(int32 c) {
+	PoolClass *pool = &pools[c];
+	int32 blocksize = (c + 1) * POOL_GRANULE;
+	int32 n = chunkblocks(c);
+	PoolChunk *chunk = (PoolChunk *)malloc(POOL_CHUNKSIZE);
+	if (!chunk)
+		lua_error(memEM);
+	chunk->next = pool->chunks;
+	pool->chunks = chunk;
+	pool->nchunks++;
+	// thread the new blocks in address order
+	byte *b = (byte *)(chunk + 1) + (n - 1) * blocksize;
+	for (int32 i = 0; i < n; i++, b -= blocksize) {
+		((PoolBlock *)b)->next = pool->freelist;
+		pool->freelist = (PoolBlock *)b;
+	}
+	pool->nfree += n;
+	memstats.chunkAllocs++;
+	memstats.bytesReserved += POOL_CHUNKSIZE;
+}
+
+void *luaM_poolalloc(int32 size) {
+	if (size > POOL_MAXSIZE) {
+		memstats.largeAllocs++;
+		return luaM_realloc(nullptr, size);
+	}
+	int32 c = sizeclass(size);
+	PoolClass *pool = &pools[c];
+	if (!pool->freelist)
+		newchunk(c);
+	PoolBlock *b = pool->freelist;
+	pool->freelist = b->next;
+	pool->nfree--;
+	memstats.allocs++;
+	memstats.blocksInUse++;
+	memstats.bytesInUse += (c + 1) * POOL_GRANULE;
+	return b;
+}
+
+void luaM_poolfree(void *block, int32 size) {
+	if (!block)
+		return;
+	if (size > POOL_MAXSIZE) {
+		luaM_free(block);
+		return;
+	}
+	int32 c = sizeclass(size);
+	PoolClass *pool = &pools[c];
+	PoolBlock *b = (PoolBlock *)block;
+	b->next = pool->freelist;
+	pool->freelist = b;
+	pool->nfree++;
+	memstats.frees++;
+	memstats.blocksInUse--;
+	memstats.bytesInUse -= (c + 1) * POOL_GRANULE;
+}
+
+static int32 findchunk(PoolChunk **chunks, int32 n, void *block) {
+	// last chunk starting at or before the block
+	int32 lo = 0, hi = n - 1;
+	while (lo < hi) {
+		int32 mid = (lo + hi + 1) / 2;
+		if ((byte *)chunks[mid] <= (byte *)block)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return lo;
+}
+
+static void trimclass(int32 c) {
+	PoolClass *pool = &pools[c];
+	int32 perchunk = chunkblocks(c);
+	int32 n = pool->nchunks;
+	// Only bother when most of the pool is free
+	if (pool->nfree < 2 * perchunk || pool->nfree * 3 < n * perchunk * 2)
+		return;
+
+	PoolChunk **chunks = luaM_newvector(n, PoolChunk *);
+	int32 *nfree = luaM_newvector(n, int32);
+	int32 i = 0;
+	for (PoolChunk *chunk = pool->chunks; chunk; chunk = chunk->next)
+		chunks[i++] = chunk;
+	Common::sort(chunks, chunks + n);
+	for (i = 0; i < n; i++)
+		nfree[i] = 0;
+	for (PoolBlock *b = pool->freelist; b; b = b->next)
+		nfree[findchunk(chunks, n, b)]++;
+
+	// Release empty chunks, but keep as many free blocks as there are
+	// used ones, so that the next cycle does not allocate them again
+	int32 inuse = n * perchunk - pool->nfree;
+	int32 keep = pool->nfree;
+	for (i = 0; i < n; i++) {
+		if (nfree[i] == perchunk && keep - perchunk >= inuse) {
+			nfree[i] = -1;
+			keep -= perchunk;
+		}
+	}
+
+	// Rebuild the free list without the blocks of the released chunks
+	PoolBlock **last = &pool->freelist;
+	for (PoolBlock *b = pool->freelist; b; b = b->next) {
+		if (nfree[findchunk(chunks, n, b)] != -1) {
+			*last = b;
+			last = &b->next;
+		}
+	}
+	*last = nullptr;
+
+	PoolChunk **lastchunk = &pool->chunks;
+	for (i = 0; i < n; i++) {
+		if (nfree[i] == -1) {
+			free(chunks[i]);
+			pool->nchunks--;
+			pool->nfree -= perchunk;
+			memstats.chunkFrees++;
+			memstats.bytesReserved -= POOL_CHUNKSIZE;
+		} else {
+			*lastchunk = chunks[i];
+			lastchunk = &chunks[i]->next;
+		}
+	}
+	*lastchunk = nullptr;
+
+	luaM_free(chunks);
+	luaM_free(nfree);
+}
+
+void luaM_trimpools() {
+	for (int32 c = 0; c < POOL_CLASSES; c++)
+		trimclass(c);
+}
+
+void luaM_freepools() {
+	for (int32 c = 0; c < POOL_CLASSES; c++) {
+		PoolClass *pool = &pools[c];
+		while (pool->chunks) {
+			PoolChunk *next = pool->chunks->next;
+			free(pool->chunks);
+			pool->chunks = next;
+			memstats.chunkFrees++;
+		}
+		pool->freelist = nullptr;
+		pool->nchunks = 0;
+		pool->nfree = 0;
+	}
+	memstats.blocksInUse = 0;
+	memstats.bytesInUse = 0;
+	memstats.bytesReserved = 0;
+}
+
+const MemStatistics &luaM_getstatistics() {
+	return memstats;
+}
+
+void luaM_resetstatistics() {
+	memstats.allocs = 0;
+	memstats.frees = 0;
+	memstats.largeAllocs = 0;
+	memstats.chunkAllocs = 0;
+	memstats.chunkFrees = 0;
+}
+
 #ifndef LUA_DEBUG
 
 /*
@@ -27,6 +27,37 @@ int32 luaM_growaux (void **block, int32 nelems, int32 size, const char *errormsg
 #define luaM_growvector(old, n, t, e, l)	(luaM_growaux((void**)old, n, sizeof(t), e, l))
 #define luaM_reallocvector(v, n, t)			((t *)realloc(v,(n) * sizeof(t)))
 
+/*
+** Pooled allocation, for the small objects the collector creates and
+** frees all the time. The size given to luaM_poolfree must be the one
+** the block was allocated with.
+*/
+void *luaM_poolalloc(int32 size);
+void luaM_poolfree(void *block, int32 size);
+void luaM_trimpools();
+void luaM_freepools();
+
+#define luaM_newobject(t)					((t *)luaM_poolalloc(sizeof(t)))
+#define luaM_freeobject(b, t)				luaM_poolfree((b), sizeof(t))
+
+/* Counters of the pooled allocator, see luaM_getstatistics() */
+struct MemStatistics {
+	MemStatistics() : allocs(0), frees(0), largeAllocs(0), chunkAllocs(0), chunkFrees(0),
+		blocksInUse(0), bytesInUse(0), bytesReserved(0) {}
+
+	uint32 allocs;         // blocks taken from the pools
+	uint32 frees;          // blocks given back to the pools
+	uint32 largeAllocs;    // blocks too big for a pool, passed to malloc
+	uint32 chunkAllocs;    // chunks allocated from the system
+	uint32 chunkFrees;     // chunks released to the system
+	uint32 blocksInUse;
+	uint32 bytesInUse;
+	uint32 bytesReserved;  // size of all the chunks held
+};
+
+const MemStatistics &luaM_getstatistics();
+void luaM_resetstatistics();
+
 #ifdef LUA_DEBUG
 extern int32 numblocks;
 extern int32 totalmem;
@@ -259,7 +259,7 @@ void lua_Restore(SaveGame *savedState) {
 	for (i = 0; i < arrayClosuresCount; i++) {
 		arraysObj->idObj.id = savedState->readLEUint64();
 		int32 countElements = savedState->readLESint32();
-		tempClosure = (Closure *)luaM_malloc((countElements * sizeof(TObject)) + sizeof(Closure));
+		tempClosure = (Closure *)luaM_poolalloc((countElements * sizeof(TObject)) + sizeof(Closure));
 		luaO_insertlist(prevClosure, (GCnode *)tempClosure);
 		prevClosure = (GCnode *)tempClosure;
 
@@ -277,7 +277,7 @@ void lua_Restore(SaveGame *savedState) {
 	arrayHashTables = arraysObj;
 	for (i = 0; i < arrayHashTablesCount; i++) {
 		arraysObj->idObj.id = savedState->readLEUint64();
-		tempHash = luaM_new(Hash);
+		tempHash = luaM_newobject(Hash);
 		tempHash->nhash = savedState->readLESint32();
 		tempHash->nuse = savedState->readLESint32();
 		tempHash->htag = savedState->readLESint32();
@@ -299,7 +299,7 @@ void lua_Restore(SaveGame *savedState) {
 	arraysObj = arrayProtoFuncs;
 	for (i = 0; i < arrayProtoFuncsCount; i++) {
 		arraysObj->idObj.id = savedState->readLEUint64();
-		tempProtoFunc = luaM_new(TProtoFunc);
+		tempProtoFunc = luaM_newobject(TProtoFunc);
 		luaO_insertlist(oldProto, (GCnode *)tempProtoFunc);
 		oldProto = (GCnode *)tempProtoFunc;
 		PointerId ptr;
@@ -384,7 +384,7 @@ void lua_Restore(SaveGame *savedState) {
 				*node(tempHash, present(tempHash, &newNode->ref)) = *newNode;
 			}
 		}
-		luaM_free(oldNode);
+		hashnodefree(oldNode, tempHash->nhash);
 		tempHash = (Hash *)tempHash->head.next;
 	}
 
@@ -132,6 +132,7 @@ void lua_resetglobals() {
 	refSize = 0;
 	GCthreshold = GARBAGE_BLOCK;
 	nblocks = 0;
+	luaC_resetgc();
 
 	luaD_init();
 	luaS_init();
@@ -221,9 +222,11 @@ void lua_close() {
 	luaF_freeclosure((Closure *)rootcl.next);
 	luaS_free(alludata);
 	luaS_freeall();
+	luaM_freepools();
 	luaM_free(IMtable);
 	luaM_free(refArray);
 	luaM_free(Mbuffer);
+	luaC_freegc();
 
 	LState *tmpState, *state;
 	for (state = lua_rootState; state != nullptr;) {
@@ -8,6 +8,7 @@
 
 #include "common/util.h"
 
+#include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/lobject.h"
 #include "engines/grim/lua/lstate.h"
@@ -69,13 +70,13 @@ static TaggedString *newone(const char *buff, int32 tag, uint32 h) {
 	TaggedString *ts;
 	if (tag == LUA_T_STRING) {
 		int l = strlen(buff);
-		ts = (TaggedString *)luaM_malloc(sizeof(TaggedString) + l);
+		ts = (TaggedString *)luaM_poolalloc(sizeof(TaggedString) + l);
 		strcpy(ts->str, buff);
 		ts->globalval.ttype = LUA_T_NIL;  /* initialize global value */
 		ts->constindex = 0;
 		nblocks += gcsizestring(l);
 	} else {
-		ts = (TaggedString *)luaM_malloc(sizeof(TaggedString));
+		ts = luaM_newobject(TaggedString);
 		ts->globalval.value.ts = (TaggedString *)const_cast<char *>(buff);
 		ts->globalval.ttype = (lua_Type)(tag == LUA_ANYTAG ? 0 : tag);
 		ts->constindex = -1;  /* tag -> this is a userdata */
@@ -131,11 +132,18 @@ TaggedString *luaS_newfixedstring(const char *str) {
 	return ts;
 }
 
+static void freeone(TaggedString *ts) {
+	if (ts->constindex == -1)
+		luaM_freeobject(ts, TaggedString);
+	else
+		luaM_poolfree(ts, sizeof(TaggedString) + strlen(ts->str));
+}
+
 void luaS_free(TaggedString *l) {
 	while (l) {
 		TaggedString *next = (TaggedString *)l->head.next;
 		nblocks -= (l->constindex == -1) ? 1 : gcsizestring(strlen(l->str));
-		luaM_free(l);
+		freeone(l);
 		l = next;
 	}
 }
@@ -202,9 +210,9 @@ void luaS_freeall() {
 		int32 j;
 		for (j = 0; j < tb->size; j++) {
 			TaggedString *t = tb->hash[j];
-			if (t == &EMPTY)
+			if (!t || t == &EMPTY)
 				continue;
-			luaM_free(t);
+			freeone(t);
 		}
 		luaM_free(tb->hash);
 	}
@@ -212,6 +220,7 @@ void luaS_freeall() {
 }
 
 void luaS_rawsetglobal(TaggedString *ts, TObject *newval) {
+	luaC_barrierglobal(newval);
 	ts->globalval = *newval;
 	if (ts->head.next == (GCnode *)ts) {  // is not in list?
 		ts->head.next = rootglobal.next;
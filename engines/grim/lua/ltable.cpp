@@ -7,6 +7,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_longjmp
 
 #include "engines/grim/lua/lauxlib.h"
+#include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/lobject.h"
 #include "engines/grim/lua/lstate.h"
@@ -78,19 +79,23 @@ int32 present(Hash *t, TObject *key) {
 ** Alloc a vector node
 */
 Node *hashnodecreate(int32 nhash) {
-	Node *v = luaM_newvector(nhash, Node);
+	Node *v = (Node *)luaM_poolalloc(nhash * sizeof(Node));
 	int32 i;
 	for (i = 0; i < nhash; i++)
 		ttype(ref(&v[i])) = LUA_T_NIL;
 	return v;
 }
 
+void hashnodefree(Node *v, int32 nhash) {
+	luaM_poolfree(v, nhash * sizeof(Node));
+}
+
 /*
 ** Delete a hash
 */
 static void hashdelete(Hash *t) {
-	luaM_free(nodevector(t));
-	luaM_free(t);
+	hashnodefree(nodevector(t), nhash(t));
+	luaM_freeobject(t, Hash);
 }
 
 void luaH_free(Hash *frees) {
@@ -103,7 +108,7 @@ void luaH_free(Hash *frees) {
 }
 
 Hash *luaH_new(int32 nhash) {
-	Hash *t = luaM_new(Hash);
+	Hash *t = luaM_newobject(Hash);
 	nhash = luaO_redimension((int32)((float)nhash / REHASH_LIMIT));
 	nodevector(t) = hashnodecreate(nhash);
 	nhash(t) = nhash;
@@ -143,7 +148,7 @@ static void rehash(Hash *t) {
 			*node(t, present(t, ref(n))) = *n;  // copy old node to luaM_new hash
 	}
 	nblocks += gcsize(t->nhash) - gcsize(nold);
-	luaM_free(vold);
+	hashnodefree(vold, nold);
 }
 
 /*
@@ -163,6 +168,7 @@ TObject *luaH_get(Hash *t, TObject *r) {
 ** node for the given reference and also return its pointer.
 */
 TObject *luaH_set(Hash *t, TObject *r) {
+	luaC_tablebarrier(t);
 	Node *n = node(t, present(t, r));
 	if (ttype(ref(n)) == LUA_T_NIL) {
 		nuse(t)++;
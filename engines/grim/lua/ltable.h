@@ -21,6 +21,7 @@ TObject *luaH_get(Hash *t, TObject *r);
 TObject *luaH_set(Hash *t, TObject *r);
 Node *luaH_next(TObject *o, TObject *r);
 Node *hashnodecreate(int32 nhash);
+void hashnodefree(Node *v, int32 nhash);
 int32 present(Hash *t, TObject *key);
 
 } // end of namespace Grim
@@ -8,6 +8,7 @@
 #include "engines/grim/lua/ltask.h"
 #include "engines/grim/lua/lapi.h"
 #include "engines/grim/lua/lauxlib.h"
+#include "engines/grim/lua/lgc.h"
 #include "engines/grim/lua/lmem.h"
 #include "engines/grim/lua/ldo.h"
 #include "engines/grim/lua/lvm.h"
@@ -319,7 +320,14 @@ void sleep_for() {
 }
 
 void lua_runtasks() {
-	if (!lua_state || !lua_state->next) {
+	if (!lua_state) {
+		return;
+	}
+
+	// Give an incremental garbage collection its share of the frame
+	luaC_step();
+
+	if (!lua_state->next) {
 		return;
 	}
 
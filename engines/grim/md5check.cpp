@@ -20,9 +20,15 @@
  *
  */
 
+#include "common/archive.h"
+#include "common/bufferedstream.h"
+#include "common/config-manager.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/md5.h"
+#include "common/tokenizer.h"
 #include "common/translation.h"
+#include "common/workerpool.h"
 
 #include "gui/error.h"
 
@@ -369,9 +375,44 @@ const char *emi_installer[] = {
 	"a42f8aa079a6d23c285fceba191e67a4", // English (Monkey Island 4 Installer)
 };
 
+// Hashing is bound by the disk more than by the CPU past a few threads
+#define MD5CHECK_MAXTHREADS  3
+#define MD5CHECK_READSIZE  (1024 * 1024)
+
+/**
+ * Hash one file. The stream is opened on the main thread, since the search
+ * manager is not thread safe; the job only reads from it.
+ */
+class MD5Check::MD5Job : public Common::WorkerJob {
+public:
+	MD5Job(Common::SeekableReadStream *stream, const Common::String &path, uint32 mtime) :
+			_stream(stream), _size(stream ? stream->size() : 0), _path(path), _mtime(mtime), _fromCache(false) {}
+	~MD5Job() { delete _stream; }
+
+	void execute() override {
+		if (!_stream || _fromCache)
+			return;
+
+		Common::ReadStream *buffered = Common::wrapBufferedReadStream(_stream, MD5CHECK_READSIZE, DisposeAfterUse::NO);
+		_md5 = Common::computeStreamMD5AsString(*buffered);
+		delete buffered;
+	}
+
+	Common::SeekableReadStream *_stream;  // nullptr if the file could not be opened
+	uint32 _size;
+	Common::String _path;  // full path of the file, empty if its sum can't be cached
+	uint32 _mtime;
+	Common::String _md5;
+	bool _fromCache;
+};
+
 bool MD5Check::_initted = false;
 Common::Array<MD5Check::MD5Sum> *MD5Check::_files = nullptr;
 int MD5Check::_iterator = -1;
+Common::WorkerPool *MD5Check::_pool = nullptr;
+Common::Array<MD5Check::MD5Job *> *MD5Check::_jobs = nullptr;
+MD5Check::CacheMap *MD5Check::_cache = nullptr;
+bool MD5Check::_cacheChanged = false;
 
 void MD5Check::init() {
 	if (_initted) {
@@ -494,8 +535,11 @@ void MD5Check::init() {
 }
 
 void MD5Check::clear() {
+	stopCheck();
 	delete _files;
 	_files = nullptr;
+	delete _cache;
+	_cache = nullptr;
 	_initted = false;
 }
 
@@ -510,46 +554,110 @@ bool MD5Check::checkMD5(const MD5Sum &sums, const char *md5) {
 
 bool MD5Check::checkFiles() {
 	startCheckFiles();
-	bool ok = true;
-	while (_iterator != -1) {
-		ok = advanceCheck() && ok;
-	}
-
-	return ok;
+	return advance(true, nullptr, nullptr);
 }
 
 void MD5Check::startCheckFiles() {
+	stopCheck();
 	init();
+	loadCache();
+
+	uint threads = MIN<uint>(Common::WorkerPool::getDefaultThreadCount(), MD5CHECK_MAXTHREADS);
+	_pool = new Common::WorkerPool(threads);
+	_jobs = new Common::Array<MD5Job *>();
+	for (uint i = 0; i < _files->size(); i++) {
+		const char *filename = (*_files)[i].filename;
+		Common::File *file = new Common::File();
+		if (!file->open(filename)) {
+			delete file;
+			file = nullptr;
+		}
+
+		// The sums are cached by full path, size and modification time. Files
+		// whose modification time is not known are always hashed.
+		Common::String path;
+		uint32 mtime = 0;
+		Common::ArchiveMemberPtr member = SearchMan.getMember(filename);
+		const Common::FSNode *node = dynamic_cast<const Common::FSNode *>(member.get());
+		if (file && node && !strchr(node->getPath().c_str(), ';')) {
+			mtime = node->getModificationTime();
+			if (mtime)
+				path = node->getPath();
+		}
+
+		MD5Job *job = new MD5Job(file, path, mtime);
+		if (!path.empty()) {
+			CacheMap::const_iterator cached = _cache->find(path);
+			Common::String prefix = Common::String::format("%u|%u|", job->_size, mtime);
+			if (cached != _cache->end() && cached->_value.hasPrefix(prefix)) {
+				job->_md5 = Common::String(cached->_value.c_str() + prefix.size());
+				job->_fromCache = true;
+			}
+		}
+		_jobs->push_back(job);
+		// Without threads, queuing would hash the file right away
+		if (_pool->getThreadCount() > 0)
+			_pool->queue(job);
+	}
 	_iterator = 0;
 }
 
 bool MD5Check::advanceCheck(int *pos, int *total) {
+	return advance(false, pos, total);
+}
+
+bool MD5Check::advance(bool wait, int *pos, int *total) {
 	if (_iterator < 0) {
 		return false;
 	}
 
-	const MD5Sum &sum = (*_files)[_iterator++];
+	bool ok = true;
+	bool hashed = false;
+	while ((uint)_iterator < _jobs->size()) {
+		MD5Job *job = (*_jobs)[_iterator];
+		if (_pool->getThreadCount() == 0) {
+			// Hash the files here, one per call unless asked to wait
+			if (hashed && !wait)
+				break;
+			_pool->queue(job);
+			hashed = true;
+		} else if (!_pool->isDone(job)) {
+			if (!wait)
+				break;
+			_pool->wait(job);
+		}
+		ok = reportFile((*_files)[_iterator], job) && ok;
+		_iterator++;
+	}
+
+	// Count the work done in KB, with the files hashed ahead of the one
+	// being waited for
+	int done = 0, all = 0;
+	for (uint i = 0; i < _jobs->size(); i++) {
+		MD5Job *job = (*_jobs)[i];
+		int weight = job->_size / 1024 + 1;
+		all += weight;
+		if (i < (uint)_iterator || (_pool->getThreadCount() > 0 && _pool->isDone(job)))
+			done += weight;
+	}
+	if ((uint)_iterator == _jobs->size()) {
+		saveCache();
+		stopCheck();
+	} else if (done == all) {
+		done--;
+	}
+
 	if (pos) {
-		*pos = _iterator;
+		*pos = done;
 	}
 	if (total) {
-		*total = _files->size();
-	}
-	if ((uint32)_iterator == _files->size()) {
-		_iterator = -1;
+		*total = all;
 	}
+	return ok;
+}
 
-	Common::File file;
-	if (file.open(sum.filename)) {
-		Common::String md5 = Common::computeStreamMD5AsString(file);
-		if (!checkMD5(sum, md5.c_str())) {
-			warning(_("'%s' may be corrupted. MD5: '%s'"), sum.filename, md5.c_str());
-			GUI::displayErrorDialog(Common::String::format(_("The game data file %s may be corrupted.\nIf you are sure it is "
-									"not please provide the ResidualVM team the following code, along with the file name, the language and a "
-									"description of your game version (i.e. dvd-box or jewelcase):\n%s"), sum.filename, md5.c_str()).c_str());
-			return false;
-		}
-	} else {
+bool MD5Check::reportFile(const MD5Sum &sum, MD5Job *job) {
+	if (!job->_stream) {
 		warning(_("Could not open %s for checking"), sum.filename);
 		GUI::displayErrorDialog(Common::String::format(_("Could not open the file %s for checking.\nIt may be missing or "
 								"you may not have the rights to open it.\nGo to http://wiki.residualvm.org/index.php/Datafiles to see a list "
@@ -557,7 +665,69 @@ bool MD5Check::advanceCheck(int *pos, int *total) {
 		return false;
 	}
 
+	if (!job->_fromCache && !job->_path.empty()) {
+		(*_cache)[job->_path] = Common::String::format("%u|%u|%s", job->_size, job->_mtime, job->_md5.c_str());
+		_cacheChanged = true;
+	}
+
+	const char *md5 = job->_md5.c_str();
+	if (!checkMD5(sum, md5)) {
+		warning(_("'%s' may be corrupted. MD5: '%s'"), sum.filename, md5);
+		GUI::displayErrorDialog(Common::String::format(_("The game data file %s may be corrupted.\nIf you are sure it is "
+								"not please provide the ResidualVM team the following code, along with the file name, the language and a "
+								"description of your game version (i.e. dvd-box or jewelcase):\n%s"), sum.filename, md5).c_str());
+		return false;
+	}
+
 	return true;
 }
 
+void MD5Check::stopCheck() {
+	// Deleting the pool waits for the jobs still running
+	delete _pool;
+	_pool = nullptr;
+	if (_jobs) {
+		for (uint i = 0; i < _jobs->size(); i++) {
+			delete (*_jobs)[i];
+		}
+		delete _jobs;
+		_jobs = nullptr;
+	}
+	_iterator = -1;
+}
+
+void MD5Check::loadCache() {
+	if (_cache)
+		return;
+	_cache = new CacheMap();
+	_cacheChanged = false;
+
+	// "path|size|mtime|md5" entries, separated by ';'. The path may
+	// contain '|', so the fields are split from the end.
+	Common::StringTokenizer entries(ConfMan.get("gamedata_md5_cache"), ";");
+	while (!entries.empty()) {
+		Common::String entry = entries.nextToken();
+		int separators = 0;
+		int i = entry.size();
+		while (--i > 0 && (entry[i] != '|' || ++separators < 3))
+			;
+		if (i > 0)
+			(*_cache)[Common::String(entry.c_str(), i)] = Common::String(entry.c_str() + i + 1);
+	}
+}
+
+void MD5Check::saveCache() {
+	if (!_cacheChanged)
+		return;
+
+	Common::String value;
+	for (CacheMap::const_iterator i = _cache->begin(); i != _cache->end(); ++i) {
+		if (!value.empty())
+			value += ';';
+		value += i->_key + '|' + i->_value;
+	}
+	ConfMan.set("gamedata_md5_cache", value);
+	_cacheChanged = false;
+}
+
 }
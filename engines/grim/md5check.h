@@ -24,13 +24,33 @@
 #define GRIM_MD5CHECK_H
 
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace Common {
+class WorkerPool;
+}
 
 namespace Grim {
 
+/**
+ * Check the game data files against their known MD5 sums.
+ *
+ * The files are hashed on worker threads. advanceCheck() only reports the
+ * files whose hashing has finished, so it can be polled from the GUI. The
+ * sums are cached in the game configuration, with the full path, size and
+ * modification time of each file, so that checking again is instant.
+ */
 class MD5Check {
 public:
 	static bool checkFiles();
 	static void startCheckFiles();
+	/**
+	 * Report the files hashed since the last call. pos and total are the
+	 * progress, in an arbitrary unit, pos being equal to total once done.
+	 * @return false if any of the files reported is corrupted or missing.
+	 */
 	static bool advanceCheck(int *pos, int *total);
 	inline static bool advanceCheck() { return advanceCheck(NULL, NULL); }
 	static void clear();
@@ -46,9 +66,22 @@ private:
 	};
 	static bool checkMD5(const MD5Sum &sums, const char *md5);
 
+	class MD5Job;
+	typedef Common::HashMap<Common::String, Common::String> CacheMap;
+
+	static bool advance(bool wait, int *pos, int *total);
+	static bool reportFile(const MD5Sum &sum, MD5Job *job);
+	static void stopCheck();
+	static void loadCache();
+	static void saveCache();
+
 	static bool _initted;
 	static Common::Array<MD5Sum> *_files;
 	static int _iterator;
+	static Common::WorkerPool *_pool;
+	static Common::Array<MD5Job *> *_jobs;
+	static CacheMap *_cache;
+	static bool _cacheChanged;
 };
 
 }
@@ -71,9 +71,26 @@ public:
 	}
 };
 
+/**
+ * Reads a file from the resource cache. The cache entry is pinned until
+ * the stream is deleted, so it can't be evicted while in use.
+ */
+class CachedResourceStream : public Common::MemoryReadStream {
+public:
+	CachedResourceStream(const ResourceLoader *loader, ResourceLoader::ResourceCache *entry) :
+			Common::MemoryReadStream(entry->resPtr, entry->len), _loader(loader), _entry(entry) {}
+	~CachedResourceStream() { _loader->releaseCacheEntry(_entry); }
+
+private:
+	const ResourceLoader *_loader;
+	ResourceLoader::ResourceCache *_entry;
+};
+
 ResourceLoader::ResourceLoader() {
-	_cacheDirty = false;
+	_cacheHead = _cacheTail = nullptr;
 	_cacheMemorySize = 0;
+	_cacheBudget = MAX(ConfMan.getInt("resource_cache_size"), 0) * 1024;
+	_cacheHits = _cacheMisses = _cacheEvictions = 0;
 
 	Lab *l;
 	Common::ArchiveMemberList files, updFiles;
@@ -221,10 +238,9 @@ void clearList(Common::List<T> &list) {
 }
 
 ResourceLoader::~ResourceLoader() {
-	for (Common::Array<ResourceCache>::iterator i = _cache.begin(); i != _cache.end(); ++i) {
-		ResourceCache &r = *i;
-		delete[] r.fname;
-		delete[] r.resPtr;
+	// The sound systems, which hold the only long lived cached streams, are gone by now
+	for (CacheMap::iterator i = _cache.begin(); i != _cache.end(); ++i) {
+		freeCacheEntry(i->_value);
 	}
 	clearList(_models);
 	clearList(_colormaps);
@@ -233,32 +249,33 @@ ResourceLoader::~ResourceLoader() {
 	MD5Check::clear();
 }
 
-static int sortCallback(const void *entry1, const void *entry2) {
-	return scumm_stricmp(((const ResourceLoader::ResourceCache *)entry1)->fname, ((const ResourceLoader::ResourceCache *)entry2)->fname);
-}
-
 Common::SeekableReadStream *ResourceLoader::getFileFromCache(const Common::String &filename) const {
-	ResourceLoader::ResourceCache *entry = getEntryFromCache(filename);
-	if (!entry)
-		return nullptr;
+	Common::StackLock lock(_cacheMutex);
 
-	return new Common::MemoryReadStream(entry->resPtr, entry->len);
-
-}
-
-ResourceLoader::ResourceCache *ResourceLoader::getEntryFromCache(const Common::String &filename) const {
-	if (_cache.empty())
+	CacheMap::iterator i = _cache.find(filename);
+	if (i == _cache.end()) {
+		++_cacheMisses;
 		return nullptr;
-
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
 	}
 
-	ResourceCache key;
-	key.fname = const_cast<char *>(filename.c_str());
+	++_cacheHits;
+	ResourceCache *entry = i->_value;
+	++entry->refCount;
+	touchCacheEntry(entry);
+	return new CachedResourceStream(this, entry);
+}
 
-	return (ResourceLoader::ResourceCache *)bsearch(&key, _cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
+ResourceLoader::CacheStatistics ResourceLoader::getCacheStatistics() const {
+	Common::StackLock lock(_cacheMutex);
+
+	CacheStatistics stats;
+	stats.hits = _cacheHits;
+	stats.misses = _cacheMisses;
+	stats.evictions = _cacheEvictions;
+	stats.entries = _cache.size();
+	stats.residentBytes = _cacheMemorySize;
+	stats.budget = _cacheBudget;
+	return stats;
 }
 
 Common::SeekableReadStream *ResourceLoader::loadFile(const Common::String &filename) const {
@@ -286,9 +303,8 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 			uint32 size = s->size();
 			byte *buf = new byte[size];
 			s->read(buf, size);
-			putIntoCache(fname, buf, size);
 			delete s;
-			s = new Common::MemoryReadStream(buf, size);
+			s = putIntoCache(fname, buf, size);
 		}
 	} else {
 		s = loadFile(fname);
@@ -297,15 +313,80 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 	return Common::wrapCompressedReadStream(s);
 }
 
-void ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
-	ResourceCache entry;
-	entry.resPtr = res;
-	entry.len = len;
-	entry.fname = new char[fname.size() + 1];
-	strcpy(entry.fname, fname.c_str());
+Common::SeekableReadStream *ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
+	Common::StackLock lock(_cacheMutex);
+
+	ResourceCache *entry = new ResourceCache();
+	entry->fname = fname;
+	entry->resPtr = res;
+	entry->len = len;
+	entry->refCount = 1;
+	entry->prev = entry->next = nullptr;
+
+	_cache[fname] = entry;
+	touchCacheEntry(entry);
 	_cacheMemorySize += len;
-	_cache.push_back(entry);
-	_cacheDirty = true;
+
+	trimCache();
+
+	return new CachedResourceStream(this, entry);
+}
+
+void ResourceLoader::releaseCacheEntry(ResourceCache *entry) const {
+	Common::StackLock lock(_cacheMutex);
+
+	--entry->refCount;
+	// Entries uncached while pinned are no longer in the cache, drop them now
+	if (entry->refCount == 0 && entry->fname.empty())
+		freeCacheEntry(entry);
+}
+
+void ResourceLoader::touchCacheEntry(ResourceCache *entry) const {
+	if (_cacheHead == entry)
+		return;
+	if (entry->prev)
+		unlinkCacheEntry(entry);
+
+	entry->prev = nullptr;
+	entry->next = _cacheHead;
+	if (_cacheHead)
+		_cacheHead->prev = entry;
+	_cacheHead = entry;
+	if (!_cacheTail)
+		_cacheTail = entry;
+}
+
+void ResourceLoader::unlinkCacheEntry(ResourceCache *entry) const {
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else if (_cacheHead == entry)
+		_cacheHead = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else if (_cacheTail == entry)
+		_cacheTail = entry->prev;
+	entry->prev = entry->next = nullptr;
+}
+
+void ResourceLoader::freeCacheEntry(ResourceCache *entry) const {
+	_cacheMemorySize -= entry->len;
+	delete[] entry->resPtr;
+	delete entry;
+}
+
+void ResourceLoader::trimCache() const {
+	// Evict from the least recently used end, skipping the entries still being read
+	ResourceCache *entry = _cacheTail;
+	while (_cacheMemorySize > _cacheBudget && entry) {
+		ResourceCache *prev = entry->prev;
+		if (entry->refCount == 0) {
+			unlinkCacheEntry(entry);
+			_cache.erase(entry->fname);
+			freeCacheEntry(entry);
+			++_cacheEvictions;
+		}
+		entry = prev;
+	}
 }
 
 CMap *ResourceLoader::loadColormap(const Common::String &filename) {
@@ -516,23 +597,19 @@ AnimationEmi *ResourceLoader::loadAnimationEmi(const Common::String &filename) {
 }
 
 void ResourceLoader::uncache(const char *filename) const {
-	Common::String fname = filename;
-	fname.toLowercase();
+	Common::StackLock lock(_cacheMutex);
 
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
-	}
+	CacheMap::iterator i = _cache.find(filename);
+	if (i == _cache.end())
+		return;
 
-	for (unsigned int i = 0; i < _cache.size(); i++) {
-		if (fname.compareTo(_cache[i].fname) == 0) {
-			delete[] _cache[i].fname;
-			_cacheMemorySize -= _cache[i].len;
-			delete[] _cache[i].resPtr;
-			_cache.remove_at(i);
-			_cacheDirty = true;
-		}
-	}
+	ResourceCache *entry = i->_value;
+	_cache.erase(i);
+	unlinkCacheEntry(entry);
+	if (entry->refCount == 0)
+		freeCacheEntry(entry);
+	else
+		entry->fname.clear();
 }
 
 void ResourceLoader::uncacheModel(Model *m) {
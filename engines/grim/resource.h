@@ -25,6 +25,9 @@
 
 #include "common/archive.h"
 #include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/mutex.h"
 
 #include "engines/grim/object.h"
 
@@ -85,23 +88,53 @@ public:
 	void uncacheAnimationEmi(AnimationEmi *a);
 
 	struct ResourceCache {
-		char *fname;
+		Common::String fname;
 		byte *resPtr;
 		uint32 len;
+		// Streams still reading from resPtr; such entries are never evicted
+		uint32 refCount;
+		// Neighbours in the recency list, most recently used first
+		ResourceCache *prev;
+		ResourceCache *next;
 	};
 
+	struct CacheStatistics {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+		uint32 entries;
+		uint32 residentBytes;
+		uint32 budget;
+	};
+
+	CacheStatistics getCacheStatistics() const;
+
 	static Common::String fixFilename(const Common::String &filename, bool append = true);
 
 private:
+	friend class CachedResourceStream;
+
 	Common::SeekableReadStream *loadFile(const Common::String &filename) const;
 	Common::SeekableReadStream *getFileFromCache(const Common::String &filename) const;
-	ResourceLoader::ResourceCache *getEntryFromCache(const Common::String &filename) const;
-	void putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
+	Common::SeekableReadStream *putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
 	void uncache(const char *fname) const;
-
-	mutable Common::Array<ResourceCache> _cache;
-	mutable bool _cacheDirty;
-	mutable int32 _cacheMemorySize;
+	void releaseCacheEntry(ResourceCache *entry) const;
+	void touchCacheEntry(ResourceCache *entry) const;
+	void unlinkCacheEntry(ResourceCache *entry) const;
+	void freeCacheEntry(ResourceCache *entry) const;
+	void trimCache() const;
+
+	typedef Common::HashMap<Common::String, ResourceCache *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> CacheMap;
+	mutable CacheMap _cache;
+	mutable ResourceCache *_cacheHead;
+	mutable ResourceCache *_cacheTail;
+	mutable uint32 _cacheMemorySize;
+	uint32 _cacheBudget;
+	mutable uint32 _cacheHits;
+	mutable uint32 _cacheMisses;
+	mutable uint32 _cacheEvictions;
+	// Cached streams may be released from the audio thread
+	mutable Common::Mutex _cacheMutex;
 
 	Common::List<EMIModel *> _emiModels;
 	Common::List<Model *> _models;
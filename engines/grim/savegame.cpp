@@ -21,8 +21,10 @@
  */
 
 #include "common/endian.h"
+#include "common/memstream.h"
 #include "common/savefile.h"
 #include "common/system.h"
+#include "common/zlib.h"
 
 #include "math/vector3d.h"
 
@@ -33,9 +35,17 @@ namespace Grim {
 
 #define SAVEGAME_HEADERTAG  'RSAV'
 #define SAVEGAME_FOOTERTAG  'ESAV'
+#define SAVEGAME_DIRECTORYTAG  'SDIR'
+
+// Section flags in the directory
+#define SECTION_COMPRESSED  (1 << 0)
+
+// Smaller sections are not worth compressing
+#define SECTION_MINCOMPRESSSIZE  4096
 
 uint SaveGame::SAVEGAME_MAJOR_VERSION = 22;
-uint SaveGame::SAVEGAME_MINOR_VERSION = 27;
+uint SaveGame::SAVEGAME_MINOR_VERSION = 28;
+uint SaveGame::SAVEGAME_DIRECTORY_VERSION = 28;
 
 SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 	Common::InSaveFile *inSaveFile = g_system->getSavefileManager()->openForLoading(filename);
@@ -57,11 +67,20 @@ SaveGame *SaveGame::openForLoading(const Common::String &filename) {
 	save->_majorVersion = inSaveFile->readUint32BE();
 	save->_minorVersion = inSaveFile->readUint32BE();
 
+	if (save->_majorVersion == SAVEGAME_MAJOR_VERSION && save->_minorVersion >= SAVEGAME_DIRECTORY_VERSION &&
+	        !save->readDirectory()) {
+		warning("SaveGame::openForLoading() Savegame file %s is corrupt", filename.c_str());
+		delete save;
+		return nullptr;
+	}
+
 	return save;
 }
 
-SaveGame *SaveGame::openForSaving(const Common::String &filename) {
-	Common::OutSaveFile *outSaveFile =  g_system->getSavefileManager()->openForSaving(filename);
+SaveGame *SaveGame::openForSaving(const Common::String &filename, bool compressSections) {
+	// The sections are compressed one by one instead of the whole file, so
+	// that they can be seeked to directly when loading
+	Common::OutSaveFile *outSaveFile =  g_system->getSavefileManager()->openForSaving(filename, false);
 	if (!outSaveFile) {
 		warning("SaveGame::openForSaving() Error creating savegame file %s", filename.c_str());
 		return nullptr;
@@ -71,6 +90,7 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 
 	save->_saving = true;
 	save->_outSaveFile = outSaveFile;
+	save->_compressSections = compressSections;
 
 	outSaveFile->writeUint32BE(SAVEGAME_HEADERTAG);
 	outSaveFile->writeUint32BE(SAVEGAME_MAJOR_VERSION);
@@ -85,12 +105,13 @@ SaveGame *SaveGame::openForSaving(const Common::String &filename) {
 SaveGame::SaveGame() :
 		_currentSection(0), _sectionBuffer(nullptr), _majorVersion(0),
 		_minorVersion(0), _saving(false), _inSaveFile(nullptr), _outSaveFile(nullptr),
-		_sectionSize(0), _sectionAlloc(0), _sectionPtr(0) {
+		_sectionSize(0), _sectionAlloc(0), _sectionPtr(0), _compressSections(false) {
 
 }
 
 SaveGame::~SaveGame() {
 	if (_saving) {
+		writeDirectory();
 		_outSaveFile->writeUint32BE(SAVEGAME_FOOTERTAG);
 		_outSaveFile->finalize();
 		if (_outSaveFile->err())
@@ -122,28 +143,10 @@ uint32 SaveGame::beginSection(uint32 sectionTag) {
 	_currentSection = sectionTag;
 	_sectionSize = 0;
 	if (!_saving) {
-		uint32 tag = 0;
-
-		while (tag != sectionTag) {
-			tag = _inSaveFile->readUint32BE();
-			if (tag == SAVEGAME_FOOTERTAG)
-				error("Unable to find requested section of savegame");
-			_sectionSize = _inSaveFile->readUint32BE();
-			_inSaveFile->seek(_sectionSize, SEEK_CUR);
-		}
-		if (!_sectionBuffer || _sectionAlloc < _sectionSize) {
-			_sectionAlloc = _sectionSize;
-			byte *buff = (byte *)realloc(_sectionBuffer, _sectionAlloc);
-			if (buff == nullptr) {
-				free(_sectionBuffer);
-				error("Could not allocate memory for save game");
-			}
-			_sectionBuffer = buff;
-		}
-
-		_inSaveFile->seek(-(int32)_sectionSize, SEEK_CUR);
-		_inSaveFile->read(_sectionBuffer, _sectionSize);
-
+		if (_minorVersion >= SAVEGAME_DIRECTORY_VERSION)
+			readSection(sectionTag);
+		else
+			readLegacySection(sectionTag);
 	} else {
 		if (!_sectionBuffer) {
 			_sectionAlloc = _allocAmmount;
@@ -157,14 +160,148 @@ uint32 SaveGame::beginSection(uint32 sectionTag) {
 void SaveGame::endSection() {
 	if (_currentSection == 0)
 		error("Tried to end a save game section without starting a section");
-	if (_saving) {
-		_outSaveFile->writeUint32BE(_currentSection);
-		_outSaveFile->writeUint32BE(_sectionSize);
-		_outSaveFile->write(_sectionBuffer, _sectionSize);
-	}
+	if (_saving)
+		writeSection();
 	_currentSection = 0;
 }
 
+bool SaveGame::readDirectory() {
+	// The directory is followed by its offset and the footer
+	if (!_inSaveFile->seek(-8, SEEK_END))
+		return false;
+	uint32 offset = _inSaveFile->readUint32BE();
+	if (_inSaveFile->readUint32BE() != SAVEGAME_FOOTERTAG)
+		return false;
+	if (!_inSaveFile->seek(offset) || _inSaveFile->readUint32BE() != SAVEGAME_DIRECTORYTAG)
+		return false;
+
+	// Each entry takes 20 bytes, and the sections are stored before the directory
+	uint32 count = _inSaveFile->readUint32BE();
+	if (count > (uint32)(_inSaveFile->size() - _inSaveFile->pos()) / 20)
+		return false;
+
+	_sections.resize(count);
+	for (uint i = 0; i < count; i++) {
+		SectionEntry &entry = _sections[i];
+		entry.tag = _inSaveFile->readUint32BE();
+		entry.offset = _inSaveFile->readUint32BE();
+		entry.storedSize = _inSaveFile->readUint32BE();
+		entry.size = _inSaveFile->readUint32BE();
+		entry.flags = _inSaveFile->readUint32BE();
+		if (entry.offset > offset || entry.storedSize > offset - entry.offset)
+			return false;
+		if (!(entry.flags & SECTION_COMPRESSED) && entry.storedSize != entry.size)
+			return false;
+		_sectionIndex[entry.tag] = i;
+	}
+	return !_inSaveFile->err() && !_inSaveFile->eos();
+}
+
+void SaveGame::writeDirectory() {
+	uint32 offset = _outSaveFile->pos();
+	_outSaveFile->writeUint32BE(SAVEGAME_DIRECTORYTAG);
+	_outSaveFile->writeUint32BE(_sections.size());
+	for (uint i = 0; i < _sections.size(); i++) {
+		const SectionEntry &entry = _sections[i];
+		_outSaveFile->writeUint32BE(entry.tag);
+		_outSaveFile->writeUint32BE(entry.offset);
+		_outSaveFile->writeUint32BE(entry.storedSize);
+		_outSaveFile->writeUint32BE(entry.size);
+		_outSaveFile->writeUint32BE(entry.flags);
+	}
+	_outSaveFile->writeUint32BE(offset);
+}
+
+void SaveGame::readSection(uint32 sectionTag) {
+	if (!_sectionIndex.contains(sectionTag))
+		error("Unable to find requested section of savegame");
+	const SectionEntry &entry = _sections[_sectionIndex[sectionTag]];
+	_sectionSize = entry.size;
+	reserveSection(_sectionSize);
+
+	if (!_inSaveFile->seek(entry.offset))
+		error("Savegame section is corrupt");
+	if (entry.flags & SECTION_COMPRESSED) {
+#ifdef USE_ZLIB
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(_inSaveFile->readStream(entry.storedSize), entry.size);
+		uint32 size = stream->read(_sectionBuffer, _sectionSize);
+		delete stream;
+		if (size != _sectionSize)
+			error("Savegame section is corrupt");
+#else
+		error("Savegame section is compressed, but zlib support is not compiled in");
+#endif
+	} else if (_inSaveFile->read(_sectionBuffer, _sectionSize) != _sectionSize) {
+		error("Savegame section is corrupt");
+	}
+}
+
+void SaveGame::readLegacySection(uint32 sectionTag) {
+	// Older savegames have no directory, go through the sections in order
+	uint32 tag = 0;
+	while (tag != sectionTag) {
+		tag = _inSaveFile->readUint32BE();
+		if (tag == SAVEGAME_FOOTERTAG)
+			error("Unable to find requested section of savegame");
+		_sectionSize = _inSaveFile->readUint32BE();
+		if (tag != sectionTag)
+			_inSaveFile->skip(_sectionSize);
+	}
+	reserveSection(_sectionSize);
+	if (_inSaveFile->read(_sectionBuffer, _sectionSize) != _sectionSize)
+		error("Savegame section is corrupt");
+}
+
+void SaveGame::writeSection() {
+	SectionEntry entry;
+	entry.tag = _currentSection;
+	entry.size = _sectionSize;
+	entry.storedSize = _sectionSize;
+	entry.flags = 0;
+
+	const byte *data = _sectionBuffer;
+	byte *compressed = nullptr;
+#ifdef USE_ZLIB
+	if (_compressSections && _sectionSize >= SECTION_MINCOMPRESSSIZE) {
+		Common::MemoryWriteStreamDynamic *buffer = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *stream = Common::wrapCompressedWriteStream(buffer);
+		stream->write(_sectionBuffer, _sectionSize);
+		stream->finalize();
+		bool failed = stream->err();
+		compressed = buffer->getData();
+		uint32 compressedSize = buffer->size();
+		delete stream;
+		// Keep the data as is if it does not shrink
+		if (!failed && compressedSize < _sectionSize) {
+			data = compressed;
+			entry.storedSize = compressedSize;
+			entry.flags |= SECTION_COMPRESSED;
+		}
+	}
+#endif
+
+	_outSaveFile->writeUint32BE(entry.tag);
+	_outSaveFile->writeUint32BE(entry.storedSize);
+	entry.offset = _outSaveFile->pos();
+	_outSaveFile->write(data, entry.storedSize);
+	free(compressed);
+
+	_sectionIndex[entry.tag] = _sections.size();
+	_sections.push_back(entry);
+}
+
+void SaveGame::reserveSection(uint32 size) {
+	if (!_sectionBuffer || _sectionAlloc < size) {
+		_sectionAlloc = size;
+		byte *buff = (byte *)realloc(_sectionBuffer, _sectionAlloc);
+		if (buff == nullptr) {
+			free(_sectionBuffer);
+			error("Could not allocate memory for save game");
+		}
+		_sectionBuffer = buff;
+	}
+}
+
 void SaveGame::read(void *data, int size) {
 	if (_saving)
 		error("SaveGame::readBlock called when storing a savegame");
@@ -230,8 +367,9 @@ bool SaveGame::readBool() {
 
 void SaveGame::checkAlloc(int size) {
 	if (_sectionSize + size > _sectionAlloc) {
+		// Grow geometrically, big sections would be copied over and over otherwise
 		while (_sectionSize + size > _sectionAlloc)
-			_sectionAlloc += _allocAmmount;
+			_sectionAlloc = MAX<uint32>(2 * _sectionAlloc, _allocAmmount);
 		_sectionBuffer = (byte *)realloc(_sectionBuffer, _sectionAlloc);
 		if (!_sectionBuffer)
 			error("Failed to allocate space for buffer");
@@ -23,6 +23,8 @@
 #ifndef GRIM_SAVEGAME_H
 #define GRIM_SAVEGAME_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
 #include "common/savefile.h"
 
 #include "math/mathfwd.h"
@@ -34,7 +36,11 @@ class Color;
 class SaveGame {
 public:
 	static SaveGame *openForLoading(const Common::String &filename);
-	static SaveGame *openForSaving(const Common::String &filename);
+	/**
+	 * Create a savegame. Unless compressSections is false, each section is
+	 * compressed on its own when zlib is available.
+	 */
+	static SaveGame *openForSaving(const Common::String &filename, bool compressSections = true);
 	~SaveGame();
 
 	/**
@@ -50,6 +56,11 @@ public:
 	 * the current loading code.
 	 */
 	static uint SAVEGAME_MINOR_VERSION;
+	/**
+	 * First minor version with a directory of the sections at the end of the
+	 * file, and with sections that may be compressed.
+	 */
+	static uint SAVEGAME_DIRECTORY_VERSION;
 
 	bool isCompatible() const;
 
@@ -86,6 +97,21 @@ public:
 protected:
 	SaveGame();
 
+	struct SectionEntry {
+		uint32 tag;
+		uint32 offset;      // of the section data in the file
+		uint32 storedSize;  // size of the data in the file
+		uint32 size;        // size of the data once uncompressed
+		uint32 flags;
+	};
+
+	bool readDirectory();
+	void writeDirectory();
+	void readSection(uint32 sectionTag);
+	void readLegacySection(uint32 sectionTag);
+	void writeSection();
+	void reserveSection(uint32 size);
+
 	uint _majorVersion;
 	uint _minorVersion;
 	bool _saving;
@@ -96,8 +122,12 @@ protected:
 	uint32 _sectionAlloc;
 	uint32 _sectionPtr;
 	byte *_sectionBuffer;
+	bool _compressSections;
+	Common::Array<SectionEntry> _sections;
+	Common::HashMap<uint32, uint> _sectionIndex;
 
-	static const int _allocAmmount = 1048576;
+	// Initial size of the section buffer when saving, doubled as needed
+	static const int _allocAmmount = 65536;
 };
 
 } // end of namespace Grim
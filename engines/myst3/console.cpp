@@ -25,6 +25,7 @@
 #include "engines/myst3/archive.h"
 #include "engines/myst3/database.h"
 #include "engines/myst3/effects.h"
+#include "engines/myst3/facecache.h"
 #include "engines/myst3/inventory.h"
 #include "engines/myst3/script.h"
 #include "engines/myst3/state.h"
@@ -44,6 +45,8 @@ Console::Console(Myst3Engine *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("fillInventory",			WRAP_METHOD(Console, Cmd_FillInventory));
 	registerCmd("dumpArchive",			WRAP_METHOD(Console, Cmd_DumpArchive));
 	registerCmd("dumpMasks",			WRAP_METHOD(Console, Cmd_DumpMasks));
+	registerCmd("profileOpcodes",			WRAP_METHOD(Console, Cmd_ProfileOpcodes));
+	registerCmd("faceCache",			WRAP_METHOD(Console, Cmd_FaceCache));
 }
 
 Console::~Console() {
@@ -327,6 +330,60 @@ bool Console::Cmd_FillInventory(int argc, const char **argv) {
 	return false;
 }
 
+bool Console::Cmd_ProfileOpcodes(int argc, const char **argv) {
+	Script *script = _vm->_scriptEngine;
+
+	if (argc >= 2) {
+		Common::String command = argv[1];
+
+		if (command == "on") {
+			script->setProfiling(true);
+		} else if (command == "off") {
+			script->setProfiling(false);
+		} else if (command == "reset") {
+			script->resetProfile();
+		} else {
+			debugPrintf("Usage :\n");
+			debugPrintf("profileOpcodes [on|off|reset] : Count the opcodes run and the time spent in them\n");
+			return true;
+		}
+	}
+
+	debugPrintf("Opcode profiling is %s\n", script->isProfiling() ? "on" : "off");
+
+	Common::Array<Script::OpcodeStats> profile = script->getProfile();
+	for (uint i = 0; i < profile.size(); i++) {
+		const Script::OpcodeStats &stats = profile[i];
+		debugPrintf("%3d %-40s %8d runs %12llu us\n", stats.op, stats.name, stats.count, (unsigned long long)stats.time);
+	}
+
+	return true;
+}
+
+bool Console::Cmd_FaceCache(int argc, const char **argv) {
+	FaceCache *cache = _vm->_faceCache;
+
+	if (argc >= 2) {
+		Common::String command = argv[1];
+
+		if (command == "reset") {
+			cache->resetStatistics();
+		} else {
+			debugPrintf("Usage :\n");
+			debugPrintf("faceCache [reset] : Show how often the cube faces were decoded ahead of time\n");
+			return true;
+		}
+	}
+
+	uint hits = cache->getHitCount();
+	uint misses = cache->getMissCount();
+	debugPrintf("Faces decoded %s\n", cache->isAsync() ? "on worker threads" : "on the main thread");
+	debugPrintf("%u faces prefetched, %u decoded on demand (%.1f%% hit rate)\n", hits, misses,
+	            hits + misses ? 100.0f * hits / (hits + misses) : 0.0f);
+
+	return true;
+}
+
 class DumpingArchiveVisitor : public ArchiveVisitor {
 public:
 	DumpingArchiveVisitor() :
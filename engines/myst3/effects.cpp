@@ -27,10 +27,118 @@
 #include "engines/myst3/state.h"
 #include "engines/myst3/sound.h"
 
+#include "common/endian.h"
+#include "common/workerpool.h"
+
 #include "graphics/surface.h"
 
+#if defined(__SSE2__) && !defined(SCUMM_BIG_ENDIAN)
+#include <emmintrin.h>
+#define MYST3_EFFECTS_SSE2
+#endif
+
 namespace Myst3 {
 
+// Average two pixels like the original engine does, the result is opaque
+static inline uint32 averagePixels(uint32 p1, uint32 p2) {
+#ifdef SCUMM_BIG_ENDIAN
+	return 0x000000FF | ((0x7F7F7F00 & (p1 >> 1)) + (0x7F7F7F00 & (p2 >> 1)));
+#else
+	return 0xFF000000 | ((0x007F7F7F & (p1 >> 1)) + (0x007F7F7F & (p2 >> 1)));
+#endif
+}
+
+/**
+ * Average the displaced pixels with the source pixels,
+ * only where the mask is not zero
+ */
+static void averageRowMasked(uint32 *dst, const uint32 *displaced, const uint32 *src, const byte *mask, uint count) {
+	uint i = 0;
+
+#ifdef MYST3_EFFECTS_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i low = _mm_set1_epi32(0x007F7F7F);
+	const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+	for (; i + 4 <= count; i += 4) {
+		uint32 maskValues = READ_UINT32(mask + i);
+		if (!maskValues)
+			continue;
+
+		__m128i m = _mm_cvtsi32_si128(maskValues);
+		m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, zero), zero);
+		__m128i keep = _mm_cmpeq_epi32(m, zero);
+
+		__m128i p1 = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128((const __m128i *)(displaced + i)), 1), low);
+		__m128i p2 = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128((const __m128i *)(src + i)), 1), low);
+		__m128i average = _mm_or_si128(_mm_add_epi32(p1, p2), alpha);
+
+		__m128i old = _mm_loadu_si128((const __m128i *)(dst + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_and_si128(keep, old), _mm_andnot_si128(keep, average)));
+	}
+#endif
+
+	for (; i < count; i++) {
+		if (mask[i])
+			dst[i] = averagePixels(displaced[i], src[i]);
+	}
+}
+
+/**
+ * Copy the displaced pixels, only where the mask is not zero
+ */
+static void copyRowMasked(uint32 *dst, const uint32 *displaced, const byte *mask, uint count) {
+	uint i = 0;
+
+#ifdef MYST3_EFFECTS_SSE2
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 4 <= count; i += 4) {
+		uint32 maskValues = READ_UINT32(mask + i);
+		if (!maskValues)
+			continue;
+
+		__m128i m = _mm_cvtsi32_si128(maskValues);
+		m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, zero), zero);
+		__m128i keep = _mm_cmpeq_epi32(m, zero);
+
+		__m128i pixels = _mm_loadu_si128((const __m128i *)(displaced + i));
+		__m128i old = _mm_loadu_si128((const __m128i *)(dst + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_and_si128(keep, old), _mm_andnot_si128(keep, pixels)));
+	}
+#endif
+
+	for (; i < count; i++) {
+		if (mask[i])
+			dst[i] = displaced[i];
+	}
+}
+
+/**
+ * Applies an effect to the active blocks of a row of blocks
+ */
+class BlockRowJob : public Common::WorkerJob {
+public:
+	BlockRowJob() : _effect(nullptr), _mask(nullptr), _src(nullptr), _dst(nullptr), _blockY(0) {}
+
+	void init(Effect *effect, const Effect::FaceMask *mask, const Graphics::Surface *src, Graphics::Surface *dst, uint blockY) {
+		_effect = effect;
+		_mask = mask;
+		_src = src;
+		_dst = dst;
+		_blockY = blockY;
+	}
+
+	void execute() override;
+
+private:
+	Effect *_effect;
+	const Effect::FaceMask *_mask;
+	const Graphics::Surface *_src;
+	Graphics::Surface *_dst;
+	uint _blockY;
+};
+
 Effect::FaceMask::FaceMask() :
 		surface(nullptr) {
 
@@ -82,6 +190,13 @@ bool Effect::loadMasks(const Common::String &room, uint32 id, Archive::ResourceT
 			// Frame masks are vertically flipped for some reason
 			if (isFrame) {
 				_vm->_gfx->flipVertical(_facesMasks[i]->surface);
+
+				// Keep the active blocks in sync with the mask
+				for (uint x = 0; x < 10; x++) {
+					for (uint y = 0; y < 5; y++) {
+						SWAP(_facesMasks[i]->block[x][y], _facesMasks[i]->block[x][9 - y]);
+					}
+				}
 			}
 
 			delete data;
@@ -136,6 +251,52 @@ Effect::FaceMask *Effect::loadMask(Common::SeekableReadStream *maskStream) {
 	return mask;
 }
 
+void Effect::applyToActiveBlocks(FaceMask *mask, Graphics::Surface *src, Graphics::Surface *dst) {
+	Common::WorkerPool *pool = _vm->_effectPool;
+
+	BlockRowJob jobs[10];
+	uint jobCount = 0;
+
+	for (uint y = 0; y < 10 && y * 64 < (uint)dst->h; y++) {
+		bool active = false;
+		for (uint x = 0; x < 10; x++) {
+			active |= mask->block[x][y];
+		}
+
+		if (!active)
+			continue;
+
+		jobs[jobCount].init(this, mask, src, dst, y);
+		pool->queue(&jobs[jobCount]);
+		jobCount++;
+	}
+
+	for (uint i = 0; i < jobCount; i++) {
+		pool->wait(&jobs[i]);
+	}
+}
+
+void BlockRowJob::execute() {
+	uint x = 0;
+	while (x < 10) {
+		if (!_mask->block[x][_blockY]) {
+			x++;
+			continue;
+		}
+
+		// Merge the consecutive active blocks
+		Common::Rect rect = Effect::FaceMask::getBlockRect(x, _blockY);
+		while (x < 10 && _mask->block[x][_blockY]) {
+			rect.extend(Effect::FaceMask::getBlockRect(x, _blockY));
+			x++;
+		}
+
+		rect.clip(Common::Rect(_dst->w, _dst->h));
+		if (!rect.isEmpty())
+			_effect->applyToRect(_mask->surface, _src, _dst, rect);
+	}
+}
+
 Common::Rect Effect::getUpdateRectForFace(uint face) {
 	FaceMask *mask = _facesMasks.getVal(face);
 	if (!mask)
@@ -162,7 +323,10 @@ Common::Rect Effect::getUpdateRectForFace(uint face) {
 WaterEffect::WaterEffect(Myst3Engine *vm) :
 		Effect(vm),
 		_lastUpdate(0),
-		_step(0) {
+		_step(0),
+		_bottomFace(false),
+		_attenuation(1),
+		_amplOffset(0) {
 }
 
 WaterEffect::~WaterEffect() {
@@ -261,76 +425,77 @@ void WaterEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surf
 	if (!mask)
 		error("No mask for face %d", face);
 
-	apply(src, dst, mask->surface, face == 1, _vm->_state->getWaterEffectAmpl());
-}
+	_bottomFace = face == 1;
+	_attenuation = _vm->_state->getWaterEffectAttenuation();
+	_amplOffset = _vm->_state->getWaterEffectAmplOffset();
 
-void WaterEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, bool bottomFace, int32 waterEffectAmpl) {
-	int32 waterEffectAttenuation = _vm->_state->getWaterEffectAttenuation();
-	int32 waterEffectAmplOffset = _vm->_state->getWaterEffectAmplOffset();
+	applyToActiveBlocks(mask, src, dst);
+}
 
-	int8 *hDisplacement = nullptr;
-	int8 *vDisplacement = nullptr;
+void WaterEffect::applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+		const Common::Rect &rect) {
+	const int8 *hDisplacement = nullptr;
+	const int8 *vDisplacement = nullptr;
 
-	if (bottomFace) {
+	if (_bottomFace) {
 		hDisplacement = _bottomDisplacement;
 		vDisplacement = _bottomDisplacement;
 	} else {
 		vDisplacement = _verticalDisplacement;
 	}
 
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->getPixels();
+	int32 srcPitch = src->pitch / 4;
+	uint32 displaced[640];
 
-	for (uint y = 0; y < dst->h; y++) {
-		if (!bottomFace) {
-			uint32 strength = (320 * (9 - y / 64)) / waterEffectAttenuation;
+	for (int y = rect.top; y < rect.bottom; y++) {
+		if (!_bottomFace) {
+			uint32 strength = (320 * (9 - y / 64)) / _attenuation;
 			if (strength > 4)
 				strength = 4;
 			hDisplacement = _horizontalDisplacements[strength];
 		}
 
-		for (uint x = 0; x < dst->w; x++) {
-			int8 maskValue = *maskPtr;
+		const int8 *maskRow = (const int8 *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
 
-			if (maskValue != 0) {
-				int8 xOffset = hDisplacement[x];
-				int8 yOffset = vDisplacement[y];
+		for (int x = rect.left; x < rect.right; x++) {
+			int8 maskValue = maskRow[x];
+			if (maskValue == 0) {
+				// Left untouched by averageRowMasked
+				displaced[x - rect.left] = srcRow[x];
+				continue;
+			}
 
-				if (maskValue < 8) {
-					maskValue -= waterEffectAmplOffset;
-					if (maskValue < 0) {
-						maskValue = 0;
-					}
+			int8 xOffset = hDisplacement[x];
+			int8 yOffset = vDisplacement[y];
 
-					if (xOffset >= 0) {
-						if (xOffset > maskValue)
-							xOffset = maskValue;
-					} else {
-						if (-xOffset > maskValue)
-							xOffset = -maskValue;
-					}
-					if (yOffset >= 0) {
-						if (yOffset > maskValue)
-							yOffset = maskValue;
-					} else {
-						if (-yOffset > maskValue)
-							yOffset = -maskValue;
-					}
+			if (maskValue < 8) {
+				maskValue -= _amplOffset;
+				if (maskValue < 0) {
+					maskValue = 0;
 				}
 
-				uint32 srcValue1 = *(uint32 *) src->getBasePtr(x + xOffset, y + yOffset);
-				uint32 srcValue2 = *(uint32 *) src->getBasePtr(x, y);
-
-#ifdef SCUMM_BIG_ENDIAN
-				*dstPtr = 0x000000FF | ((0x7F7F7F00 & (srcValue1 >> 1)) + (0x7F7F7F00 & (srcValue2 >> 1)));
-#else
-				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
-#endif
+				if (xOffset >= 0) {
+					if (xOffset > maskValue)
+						xOffset = maskValue;
+				} else {
+					if (-xOffset > maskValue)
+						xOffset = -maskValue;
+				}
+				if (yOffset >= 0) {
+					if (yOffset > maskValue)
+						yOffset = maskValue;
+				} else {
+					if (-yOffset > maskValue)
+						yOffset = -maskValue;
+				}
 			}
 
-			maskPtr++;
-			dstPtr++;
+			displaced[x - rect.left] = srcRow[yOffset * srcPitch + x + xOffset];
 		}
+
+		averageRowMasked(dstRow + rect.left, displaced, srcRow + rect.left, (const byte *)maskRow + rect.left, rect.width());
 	}
 }
 
@@ -392,38 +557,43 @@ void LavaEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Surfa
 	if (!mask)
 		error("No mask for face %d", face);
 
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->surface->getPixels();
+	applyToActiveBlocks(mask, src, dst);
+}
 
-	for (uint y = 0; y < dst->h; y++) {
-		for (uint x = 0; x < dst->w; x++) {
-			uint8 maskValue = *maskPtr;
+void LavaEffect::applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+		const Common::Rect &rect) {
+	int32 srcPitch = src->pitch / 4;
+	uint32 displaced[640];
 
-			if (maskValue != 0) {
-				int32 xOffset= _displacement[(maskValue + y) % 256];
-				int32 yOffset = _displacement[maskValue % 256];
-				int32 maxOffset = (maskValue >> 6) & 0x3;
+	for (int y = rect.top; y < rect.bottom; y++) {
+		const byte *maskRow = (const byte *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
 
-				if (yOffset > maxOffset) {
-					yOffset = maxOffset;
-				}
-				if (xOffset > maxOffset) {
-					xOffset = maxOffset;
-				}
+		for (int x = rect.left; x < rect.right; x++) {
+			uint8 maskValue = maskRow[x];
+			if (maskValue == 0) {
+				displaced[x - rect.left] = srcRow[x];
+				continue;
+			}
 
-//				uint32 srcValue1 = *(uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
-//				uint32 srcValue2 = *(uint32 *)src->getBasePtr(x, y);
-//
-//				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
+			int32 xOffset = _displacement[(maskValue + y) % 256];
+			int32 yOffset = _displacement[maskValue % 256];
+			int32 maxOffset = (maskValue >> 6) & 0x3;
 
-				// TODO: The original does "blending" as above, but strangely
-				// this looks more like the original rendering
-				*dstPtr = *(uint32 *)src->getBasePtr(x + xOffset, y + yOffset);
+			if (yOffset > maxOffset) {
+				yOffset = maxOffset;
+			}
+			if (xOffset > maxOffset) {
+				xOffset = maxOffset;
 			}
 
-			maskPtr++;
-			dstPtr++;
+			displaced[x - rect.left] = srcRow[yOffset * srcPitch + x + xOffset];
 		}
+
+		// TODO: The original does "blending" as the water effect does, but
+		// strangely copying the pixels looks more like the original rendering
+		copyRowMasked(dstRow + rect.left, displaced, maskRow + rect.left, rect.width());
 	}
 }
 
@@ -433,7 +603,8 @@ MagnetEffect::MagnetEffect(Myst3Engine *vm) :
 		_lastTime(0),
 		_position(0),
 		_lastAmpl(0),
-		_shakeStrength(nullptr) {
+		_shakeStrength(nullptr),
+		_applyPosition(0) {
 }
 
 MagnetEffect::~MagnetEffect() {
@@ -517,34 +688,30 @@ void MagnetEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Sur
 	if (!mask)
 		error("No mask for face %d", face);
 
-	apply(src, dst, mask->surface, _position * 256.0);
-}
+	_applyPosition = _position * 256.0;
 
-void MagnetEffect::apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position) {
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->getPixels();
+	applyToActiveBlocks(mask, src, dst);
+}
 
-	for (uint y = 0; y < dst->h; y++) {
-		for (uint x = 0; x < dst->w; x++) {
-			uint8 maskValue = *maskPtr;
+void MagnetEffect::applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+		const Common::Rect &rect) {
+	uint32 displaced[640];
 
-			if (maskValue != 0) {
-				int32 displacement = _verticalDisplacement[(maskValue + position) % 256];
-				int32 displacedY = CLIP<int32>(y + displacement, 0, src->h - 1);
+	for (int y = rect.top; y < rect.bottom; y++) {
+		const byte *maskRow = (const byte *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
 
-				uint32 srcValue1 = *(uint32 *) src->getBasePtr(x, displacedY);
-				uint32 srcValue2 = *(uint32 *) src->getBasePtr(x, y);
+		for (int x = rect.left; x < rect.right; x++) {
+			uint8 maskValue = maskRow[x];
 
-#ifdef SCUMM_BIG_ENDIAN
-				*dstPtr = 0x000000FF | ((0x7F7F7F00 & (srcValue1 >> 1)) + (0x7F7F7F00 & (srcValue2 >> 1)));
-#else
-				*dstPtr = 0xFF000000 | ((0x007F7F7F & (srcValue1 >> 1)) + (0x007F7F7F & (srcValue2 >> 1)));
-#endif
-			}
+			int32 displacement = _verticalDisplacement[(maskValue + _applyPosition) % 256];
+			int32 displacedY = CLIP<int32>(y + displacement, 0, src->h - 1);
 
-			maskPtr++;
-			dstPtr++;
+			displaced[x - rect.left] = *(const uint32 *)src->getBasePtr(x, displacedY);
 		}
+
+		averageRowMasked(dstRow + rect.left, displaced, srcRow + rect.left, maskRow + rect.left, rect.width());
 	}
 }
 
@@ -775,26 +942,37 @@ void ShieldEffect::applyForFace(uint face, Graphics::Surface *src, Graphics::Sur
 	if (!mask)
 		error("No mask for face %d", face);
 
-	uint32 *dstPtr = (uint32 *)dst->getPixels();
-	byte *maskPtr = (byte *)mask->surface->getPixels();
+	applyToActiveBlocks(mask, src, dst);
+}
 
-	for (uint y = 0; y < dst->h; y++) {
-		for (uint x = 0; x < dst->w; x++) {
-			uint8 maskValue = *maskPtr;
+void ShieldEffect::applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+		const Common::Rect &rect) {
+	int32 srcPitch = src->pitch / 4;
+	uint32 displaced[640];
 
-			if (maskValue != 0) {
-				int32 yOffset = _displacement[_pattern[(y % 64) * 64 + (x % 64)]];
+	for (int y = rect.top; y < rect.bottom; y++) {
+		const byte *maskRow = (const byte *)mask->getBasePtr(0, y);
+		const uint32 *srcRow = (const uint32 *)src->getBasePtr(0, y);
+		uint32 *dstRow = (uint32 *)dst->getBasePtr(0, y);
+		const uint8 *patternRow = &_pattern[(y % 64) * 64];
 
-				if (yOffset > maskValue) {
-					yOffset = maskValue;
-				}
+		for (int x = rect.left; x < rect.right; x++) {
+			uint8 maskValue = maskRow[x];
+			if (maskValue == 0) {
+				displaced[x - rect.left] = srcRow[x];
+				continue;
+			}
 
-				*dstPtr = *(uint32 *)src->getBasePtr(x, y + yOffset);
+			int32 yOffset = _displacement[patternRow[x % 64]];
+
+			if (yOffset > maskValue) {
+				yOffset = maskValue;
 			}
 
-			maskPtr++;
-			dstPtr++;
+			displaced[x - rect.left] = srcRow[yOffset * srcPitch + x];
 		}
+
+		copyRowMasked(dstRow + rect.left, displaced, maskRow + rect.left, rect.width());
 	}
 }
 
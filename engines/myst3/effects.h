@@ -36,6 +36,8 @@ namespace Myst3 {
 
 class Myst3Engine;
 
+class BlockRowJob;
+
 class Effect {
 public:
 	struct FaceMask {
@@ -60,10 +62,26 @@ public:
 	static FaceMask *loadMask(Common::SeekableReadStream *maskStream);
 
 protected:
+	friend class BlockRowJob;
+
 	Effect(Myst3Engine *vm);
 
 	bool loadMasks(const Common::String &room, uint32 id, Archive::ResourceType type);
 
+	/**
+	 * Apply the effect to the active blocks of a face mask
+	 *
+	 * The rows of blocks are spread over the engine worker threads,
+	 * applyToRect is called for each horizontal run of active blocks.
+	 */
+	void applyToActiveBlocks(FaceMask *mask, Graphics::Surface *src, Graphics::Surface *dst);
+
+	/**
+	 * Apply the effect to a part of a face, may be called from a worker thread
+	 */
+	virtual void applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+			const Common::Rect &rect) {}
+
 	Myst3Engine *_vm;
 
 	typedef Common::HashMap<uint, FaceMask *> FaceMaskMap;
@@ -82,12 +100,17 @@ protected:
 	WaterEffect(Myst3Engine *vm);
 
 	void doStep(float position, bool isFrame);
-	void apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask,
-			bool bottomFace, int32 waterEffectAmpl);
+	void applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+			const Common::Rect &rect) override;
 
 	uint32 _lastUpdate;
 	int32 _step;
 
+	// Parameters of the face being processed
+	bool _bottomFace;
+	int32 _attenuation;
+	int32 _amplOffset;
+
 	int8 _bottomDisplacement[640];
 	int8 _verticalDisplacement[640];
 	int8 _horizontalDisplacements[5][640];
@@ -108,6 +131,8 @@ protected:
 	LavaEffect(Myst3Engine *vm);
 
 	void doStep(int32 position, float ampl);
+	void applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+			const Common::Rect &rect) override;
 
 	uint32 _lastUpdate;
 	int32 _step;
@@ -126,7 +151,8 @@ public:
 protected:
 	MagnetEffect(Myst3Engine *vm);
 
-	void apply(Graphics::Surface *src, Graphics::Surface *dst, Graphics::Surface *mask, int32 position);
+	void applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+			const Common::Rect &rect) override;
 
 	int32 _lastSoundId;
 	Common::SeekableReadStream *_shakeStrength;
@@ -135,6 +161,9 @@ protected:
 	float _position;
 	float _lastAmpl;
 	int32 _verticalDisplacement[256];
+
+	// Position in the effect cycle of the face being processed
+	int32 _applyPosition;
 };
 
 class ShakeEffect : public Effect {
@@ -187,6 +216,8 @@ public:
 protected:
 	ShieldEffect(Myst3Engine *vm);
 	bool loadPattern();
+	void applyToRect(const Graphics::Surface *mask, const Graphics::Surface *src, Graphics::Surface *dst,
+			const Common::Rect &rect) override;
 
 	uint32 _lastTick;
 	float _amplitude;
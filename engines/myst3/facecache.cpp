@@ -0,0 +1,147 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/myst3/facecache.h"
+#include "engines/myst3/archive.h"
+#include "engines/myst3/myst3.h"
+
+#include "common/debug.h"
+#include "common/stream.h"
+#include "common/workerpool.h"
+
+#include "graphics/surface.h"
+
+namespace Myst3 {
+
+class FaceCache::DecodeJob : public Common::WorkerJob {
+public:
+	DecodeJob(const Common::String &room, uint16 node, uint16 face, Common::SeekableReadStream *data) :
+			_room(room),
+			_node(node),
+			_face(face),
+			_data(data),
+			_surface(nullptr) {
+	}
+
+	~DecodeJob() {
+		delete _data;
+
+		if (_surface) {
+			_surface->free();
+			delete _surface;
+		}
+	}
+
+	void execute() override {
+		_surface = Myst3Engine::decodeJpeg(*_data);
+
+		delete _data;
+		_data = nullptr;
+	}
+
+	Common::String _room;
+	uint16 _node;
+	uint16 _face;
+
+	Common::SeekableReadStream *_data;
+	Graphics::Surface *_surface;
+};
+
+FaceCache::FaceCache() :
+		_hits(0),
+		_misses(0) {
+	// The faces of a node are decoded in parallel, there is no use for more threads
+	_pool = new Common::WorkerPool(MIN<uint>(Common::WorkerPool::getDefaultThreadCount(), 6));
+}
+
+FaceCache::~FaceCache() {
+	clear();
+	delete _pool;
+}
+
+bool FaceCache::isAsync() const {
+	return _pool->getThreadCount() > 0;
+}
+
+void FaceCache::prefetch(const Common::String &room, uint16 node, uint16 face, const ResourceDescription &jpegDesc) {
+	if (find(room, node, face))
+		return;
+
+	while (_jobs.size() >= kMaxFaces) {
+		DecodeJob *oldest = _jobs.front();
+		_jobs.pop_front();
+		release(oldest);
+	}
+
+	// Reading the archive is not thread safe, only the decoding is done in the background
+	DecodeJob *job = new DecodeJob(room, node, face, jpegDesc.getData());
+	_jobs.push_back(job);
+	_pool->queue(job);
+}
+
+Graphics::Surface *FaceCache::acquire(const Common::String &room, uint16 node, uint16 face, const ResourceDescription &jpegDesc) {
+	DecodeJob *job = find(room, node, face);
+	if (!job) {
+		_misses++;
+		return Myst3Engine::decodeJpeg(&jpegDesc);
+	}
+
+	_hits++;
+	_jobs.remove(job);
+	_pool->wait(job);
+
+	Graphics::Surface *surface = job->_surface;
+	job->_surface = nullptr;
+	delete job;
+
+	if (!surface)
+		error("Could not decode Myst III JPEG");
+
+	return surface;
+}
+
+void FaceCache::clear() {
+	while (!_jobs.empty()) {
+		DecodeJob *job = _jobs.front();
+		_jobs.pop_front();
+		release(job);
+	}
+}
+
+FaceCache::DecodeJob *FaceCache::find(const Common::String &room, uint16 node, uint16 face) {
+	for (Common::List<DecodeJob *>::iterator it = _jobs.begin(); it != _jobs.end(); it++) {
+		DecodeJob *job = *it;
+		if (job->_node == node && job->_face == face && job->_room == room)
+			return job;
+	}
+
+	return nullptr;
+}
+
+void FaceCache::release(DecodeJob *job) {
+	if (_pool->cancel(job))
+		debugC(kDebugNode, "Cancelled prefetching face %d of node %s %d", job->_face, job->_room.c_str(), job->_node);
+
+	delete job;
+}
+
+} // End of namespace Myst3
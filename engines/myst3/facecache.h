@@ -0,0 +1,103 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef MYST3_FACECACHE_H
+#define MYST3_FACECACHE_H
+
+#include "common/list.h"
+#include "common/str.h"
+
+namespace Common {
+class WorkerPool;
+}
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace Myst3 {
+
+class ResourceDescription;
+
+/**
+ * Decodes the JPEG images of the cube faces on worker threads
+ *
+ * The compressed data is read from the archive on the calling thread,
+ * only the decoding itself happens in the background. Decoded faces
+ * are kept until they are acquired by a node, or until they are evicted
+ * to make room for newer ones.
+ */
+class FaceCache {
+public:
+	FaceCache();
+	~FaceCache();
+
+	/**
+	 * Tells if the faces are decoded in the background
+	 *
+	 * When false, prefetch decodes the face right away.
+	 */
+	bool isAsync() const;
+
+	/**
+	 * Start decoding a face, unless it is already cached
+	 */
+	void prefetch(const Common::String &room, uint16 node, uint16 face, const ResourceDescription &jpegDesc);
+
+	/**
+	 * Get a decoded face and remove it from the cache
+	 *
+	 * The face is decoded on the calling thread when it was not prefetched.
+	 * The caller takes ownership of the surface.
+	 */
+	Graphics::Surface *acquire(const Common::String &room, uint16 node, uint16 face, const ResourceDescription &jpegDesc);
+
+	/**
+	 * Drop all the cached faces
+	 */
+	void clear();
+
+	/** Number of faces acquired after being prefetched, shown by the faceCache console command */
+	uint getHitCount() const { return _hits; }
+	/** Number of faces decoded on demand by acquire() */
+	uint getMissCount() const { return _misses; }
+	void resetStatistics() { _hits = _misses = 0; }
+
+	/** Number of faces kept around, a cube face is about 1.6 MB once decoded */
+	static const uint kMaxFaces = 24;
+
+private:
+	class DecodeJob;
+
+	DecodeJob *find(const Common::String &room, uint16 node, uint16 face);
+	void release(DecodeJob *job);
+
+	Common::WorkerPool *_pool;
+	Common::List<DecodeJob *> _jobs; // Oldest first
+
+	uint _hits;
+	uint _misses;
+};
+
+} // End of namespace Myst3
+
+#endif // MYST3_FACECACHE_H
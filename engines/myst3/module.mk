@@ -8,6 +8,7 @@ MODULE_OBJS := \
 	database.o \
 	detection.o \
 	effects.o \
+	facecache.o \
 	gfx.o \
 	gfx_opengl.o \
 	gfx_tinygl.o \
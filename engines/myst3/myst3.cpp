@@ -20,12 +20,14 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/debug-channels.h"
 #include "common/events.h"
 #include "common/error.h"
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/util.h"
+#include "common/workerpool.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 
@@ -38,6 +40,7 @@
 #include "engines/myst3/console.h"
 #include "engines/myst3/database.h"
 #include "engines/myst3/effects.h"
+#include "engines/myst3/facecache.h"
 #include "engines/myst3/myst3.h"
 #include "engines/myst3/nodecube.h"
 #include "engines/myst3/nodeframe.h"
@@ -65,7 +68,7 @@ namespace Myst3 {
 Myst3Engine::Myst3Engine(OSystem *syst, const Myst3GameDescription *version) :
 		Engine(syst), _system(syst), _gameDescription(version),
 		_db(0), _scriptEngine(0),
-		_state(0), _node(0), _scene(0), _archiveNode(0),
+		_state(0), _node(0), _scene(0), _archiveNode(0), _faceCache(nullptr), _effectPool(nullptr),
 		_cursor(0), _inventory(0), _gfx(0), _menu(0),
 		_rnd(0), _sound(0), _ambient(0),
 		_inputSpacePressed(false), _inputEnterPressed(false),
@@ -119,6 +122,8 @@ Myst3Engine::~Myst3Engine() {
 	delete _inventory;
 	delete _cursor;
 	delete _scene;
+	delete _faceCache;
+	delete _effectPool;
 	delete _archiveNode;
 	delete _db;
 	delete _scriptEngine;
@@ -169,6 +174,8 @@ Common::Error Myst3Engine::run() {
 		_menu = new PagingMenu(this);
 	}
 	_archiveNode = new Archive();
+	_faceCache = new FaceCache();
+	_effectPool = new Common::WorkerPool(Common::WorkerPool::getDefaultThreadCount());
 
 	_system->showMouse(false);
 
@@ -877,6 +884,8 @@ void Myst3Engine::loadNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
 	// Releeshan to the player when he is trapped between both shields.
 	if (nodeID == 9 && roomID == kRoomNarayan)
 		_state->setVar(39, 0);
+
+	prefetchNeighbourNodes();
 }
 
 void Myst3Engine::unloadNode() {
@@ -964,6 +973,69 @@ void Myst3Engine::loadNodeCubeFaces(uint16 nodeID) {
 	_node = new NodeCube(this, nodeID);
 }
 
+void Myst3Engine::prefetchNodeCubeFaces(uint16 nodeID) {
+	Common::String room = _db->getRoomName(_state->getLocationRoom(), _state->getLocationAge());
+
+	for (uint16 face = 1; face <= 6; face++) {
+		ResourceDescription jpegDesc = getFileDescription(room, nodeID, face, Archive::kCubeFace);
+
+		if (jpegDesc.isValid())
+			_faceCache->prefetch(room, nodeID, face, jpegDesc);
+	}
+}
+
+Graphics::Surface *Myst3Engine::loadNodeCubeFace(uint16 nodeID, uint16 face) {
+	Common::String room = _db->getRoomName(_state->getLocationRoom(), _state->getLocationAge());
+	ResourceDescription jpegDesc = getFileDescription(room, nodeID, face, Archive::kCubeFace);
+
+	if (!jpegDesc.isValid())
+		error("Face %d does not exist", nodeID);
+
+	return _faceCache->acquire(room, nodeID, face, jpegDesc);
+}
+
+void Myst3Engine::prefetchNeighbourNodes() {
+	// Speculative decoding is only worth it when it does not block the engine
+	if (!_faceCache->isAsync() || _state->getViewType() != kCube)
+		return;
+
+	uint16 nodeID = _state->getLocationNode();
+	uint32 roomID = _state->getLocationRoom();
+	NodePtr nodeData = _db->getNodeData(nodeID, roomID, _state->getLocationAge());
+	if (!nodeData)
+		return;
+
+	// The nodes the player can move to using the currently enabled hotspots
+	Common::Array<uint16> destinations;
+	for (uint i = 0; i < nodeData->hotspots.size(); i++) {
+		const HotSpot &hotspot = nodeData->hotspots[i];
+		if (hotspot.condition == -1 || !_state->evaluate(hotspot.condition))
+			continue;
+
+		_scriptEngine->listDestinationNodes(hotspot.script, roomID, destinations);
+	}
+
+	Common::Array<uint16> prefetched;
+	for (uint i = 0; i < destinations.size(); i++) {
+		uint16 destination = destinations[i];
+		if (!destination || destination == nodeID || Common::find(prefetched.begin(), prefetched.end(), destination) != prefetched.end())
+			continue;
+
+		// Leave room in the cache for a node that was not prefetched
+		if (prefetched.size() >= FaceCache::kMaxFaces / 6 - 1)
+			break;
+
+		// Frame nodes are cheap to load
+		if (!getFileDescription("", destination, 1, Archive::kCubeFace).isValid())
+			continue;
+
+		debugC(kDebugNode, "Prefetching node %d", destination);
+
+		prefetchNodeCubeFaces(destination);
+		prefetched.push_back(destination);
+	}
+}
+
 void Myst3Engine::loadNodeFrame(uint16 nodeID) {
 	_state->setViewType(kFrame);
 
@@ -1395,13 +1467,21 @@ Graphics::Surface *Myst3Engine::loadTexture(uint16 id) {
 
 Graphics::Surface *Myst3Engine::decodeJpeg(const ResourceDescription *jpegDesc) {
 	Common::SeekableReadStream *jpegStream = jpegDesc->getData();
+	Graphics::Surface *surface = decodeJpeg(*jpegStream);
+	delete jpegStream;
+
+	if (!surface)
+		error("Could not decode Myst III JPEG");
 
+	return surface;
+}
+
+Graphics::Surface *Myst3Engine::decodeJpeg(Common::SeekableReadStream &jpegStream) {
 	Image::JPEGDecoder jpeg;
 	jpeg.setOutputPixelFormat(Texture::getRGBAPixelFormat());
 
-	if (!jpeg.loadStream(*jpegStream))
-		error("Could not decode Myst III JPEG");
-	delete jpegStream;
+	if (!jpeg.loadStream(jpegStream))
+		return nullptr;
 
 	const Graphics::Surface *bitmap = jpeg.getSurface();
 	assert(bitmap->format == Texture::getRGBAPixelFormat());
@@ -38,6 +38,7 @@ struct Surface;
 
 namespace Common {
 struct Event;
+class WorkerPool;
 }
 
 namespace Myst3 {
@@ -61,6 +62,7 @@ enum TransitionType {
 class Archive;
 class Console;
 class Drawable;
+class FaceCache;
 class GameState;
 class HotSpot;
 class Cursor;
@@ -103,6 +105,9 @@ public:
 	Database *_db;
 	Sound *_sound;
 	Ambient *_ambient;
+
+	// Runs the face effects, see Effect::applyToActiveBlocks
+	Common::WorkerPool *_effectPool;
 	
 	Common::RandomSource *_rnd;
 
@@ -133,11 +138,19 @@ public:
 
 	Graphics::Surface *loadTexture(uint16 id);
 	static Graphics::Surface *decodeJpeg(const ResourceDescription *jpegDesc);
+	/**
+	 * Decode a JPEG image from memory, returns nullptr on failure
+	 *
+	 * Does not access the engine, may be called from a worker thread.
+	 */
+	static Graphics::Surface *decodeJpeg(Common::SeekableReadStream &jpegStream);
 
 	void goToNode(uint16 nodeID, TransitionType transition);
 	void loadNode(uint16 nodeID, uint32 roomID = 0, uint32 ageID = 0);
 	void unloadNode();
 	void loadNodeCubeFaces(uint16 nodeID);
+	void prefetchNodeCubeFaces(uint16 nodeID);
+	Graphics::Surface *loadNodeCubeFace(uint16 nodeID, uint16 face);
 	void loadNodeFrame(uint16 nodeID);
 	void loadNodeMenu(uint16 nodeID);
 
@@ -198,6 +211,7 @@ private:
 
 	Common::Array<Archive *> _archivesCommon;
 	Archive *_archiveNode;
+	FaceCache *_faceCache;
 
 	Script *_scriptEngine;
 
@@ -245,6 +259,8 @@ private:
 
 	bool isInventoryVisible();
 
+	void prefetchNeighbourNodes();
+
 	void interactWithHoveredElement();
 
 	friend class Console;
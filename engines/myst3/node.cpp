@@ -34,7 +34,11 @@
 namespace Myst3 {
 
 void Face::setTextureFromJPEG(const ResourceDescription *jpegDesc) {
-	_bitmap = Myst3Engine::decodeJpeg(jpegDesc);
+	setTextureFromBitmap(Myst3Engine::decodeJpeg(jpegDesc));
+}
+
+void Face::setTextureFromBitmap(Graphics::Surface *bitmap) {
+	_bitmap = bitmap;
 	_texture = _vm->_gfx->createTexture(_bitmap);
 
 	// Set the whole texture as dirty
@@ -278,8 +282,11 @@ void Node::update() {
 		// Alloc the target surface if necessary
 		if (!face->_finalBitmap) {
 			face->_finalBitmap = new Graphics::Surface();
+			face->_finalBitmap->copyFrom(*face->_bitmap);
+		} else {
+			// Reuse the buffer, reallocating it for each step is costly
+			memcpy(face->_finalBitmap->getPixels(), face->_bitmap->getPixels(), face->_bitmap->pitch * face->_bitmap->h);
 		}
-		face->_finalBitmap->copyFrom(*face->_bitmap);
 
 		if (effectsForFace == 1) {
 			_effects[0]->applyForFace(faceId, face->_bitmap, face->_finalBitmap);
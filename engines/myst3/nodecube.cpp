@@ -32,14 +32,13 @@ NodeCube::NodeCube(Myst3Engine *vm, uint16 id) :
 		Node(vm, id) {
 	_is3D = true;
 
-	for (int i = 0; i < 6; i++) {
-		ResourceDescription jpegDesc = _vm->getFileDescription("", id, i + 1, Archive::kCubeFace);
-
-		if (!jpegDesc.isValid())
-			error("Face %d does not exist", id);
+	// Start decoding all the faces at once, they are usually
+	// already available when the node was prefetched
+	_vm->prefetchNodeCubeFaces(id);
 
+	for (int i = 0; i < 6; i++) {
 		_faces[i] = new Face(_vm);
-		_faces[i]->setTextureFromJPEG(&jpegDesc);
+		_faces[i]->setTextureFromBitmap(_vm->loadNodeCubeFace(id, i + 1));
 	}
 }
 
@@ -33,6 +33,7 @@
 #include "engines/myst3/sound.h"
 #include "engines/myst3/state.h"
 
+#include "common/algorithm.h"
 #include "common/events.h"
 
 namespace Myst3 {
@@ -287,6 +288,14 @@ Script::Script(Myst3Engine *vm):
 	}
 
 #undef OP
+
+	buildCommandIndex();
+
+	_elseOp = findCommandByProc(&Script::ifElse).op;
+	_whileEndOp = findCommandByProc(&Script::whileEnd).op;
+
+	_profiling = false;
+	resetProfile();
 }
 
 Script::~Script() {
@@ -316,13 +325,62 @@ bool Script::run(const Common::Array<Opcode> *script) {
 	return c.result;
 }
 
-const Script::Command &Script::findCommand(uint16 op) {
-	for (uint16 i = 0; i < _commands.size(); i++)
-		if (_commands[i].op == op)
-			return _commands[i];
+void Script::listDestinationNodes(const Common::Array<Opcode> &script, uint32 roomID, Common::Array<uint16> &nodes) {
+	for (uint i = 0; i < script.size(); i++) {
+		const Opcode &opcode = script[i];
+		CommandProc proc = findCommand(opcode.op).proc;
+
+		int16 node = 0;
+		int16 room = 0;
+		if (proc == &Script::goToNodeTransition || proc == &Script::goToNodeTrans1
+				|| proc == &Script::goToNodeTrans2 || proc == &Script::zipToNode
+				|| proc == &Script::changeNode) {
+			node = opcode.args[0];
+		} else if (proc == &Script::goToRoomNode || proc == &Script::zipToRoomNode
+				|| proc == &Script::changeNodeRoom) {
+			room = opcode.args[0];
+			node = opcode.args[1];
+		} else if (proc == &Script::chooseNextNode) {
+			// Both branches are possible destinations
+			addDestinationNode(opcode.args[1], nodes);
+			node = opcode.args[2];
+		}
+
+		if (room && (uint32)_vm->_state->valueOrVarValue(room) != roomID)
+			continue;
+
+		addDestinationNode(node, nodes);
+	}
+}
+
+void Script::addDestinationNode(int16 node, Common::Array<uint16> &nodes) {
+	if (!node)
+		return;
+
+	// The node opcodes pass their argument through unresolved,
+	// Myst3Engine::loadNode() resolves it with valueOrVarValue()
+	nodes.push_back(_vm->_state->valueOrVarValue(node));
+}
+
+void Script::buildCommandIndex() {
+	// The invalid opcode is the first command
+	for (uint i = 0; i < ARRAYSIZE(_commandIndex); i++)
+		_commandIndex[i] = 0;
+
+	// Walk backwards so the first command declared for an opcode wins
+	for (int i = _commands.size() - 1; i >= 0; i--) {
+		uint16 op = _commands[i].op;
+		if (op < ARRAYSIZE(_commandIndex))
+			_commandIndex[op] = i;
+	}
+}
 
+const Script::Command &Script::findCommand(uint16 op) {
 	// Return the invalid opcode if not found
-	return findCommand(0);
+	if (op >= ARRAYSIZE(_commandIndex))
+		return _commands[0];
+
+	return _commands[_commandIndex[op]];
 }
 
 const Script::Command &Script::findCommandByProc(CommandProc proc) {
@@ -343,10 +401,55 @@ void Script::shiftCommands(uint16 base, int32 value) {
 void Script::runOp(Context &c, const Opcode &op) {
 	const Script::Command &cmd = findCommand(op.op);
 
-	if (cmd.op != 0)
-		(this->*(cmd.proc))(c, op);
-	else
+	if (cmd.op == 0) {
 		debugC(kDebugScript, "Trying to run invalid opcode %d", op.op);
+		return;
+	}
+
+	if (!_profiling) {
+		(this->*(cmd.proc))(c, op);
+		return;
+	}
+
+	uint64 startTime = g_system->getMicros();
+	(this->*(cmd.proc))(c, op);
+
+	_opcodeCount[op.op]++;
+	_opcodeTime[op.op] += g_system->getMicros() - startTime;
+}
+
+void Script::resetProfile() {
+	for (uint i = 0; i < ARRAYSIZE(_opcodeCount); i++) {
+		_opcodeCount[i] = 0;
+		_opcodeTime[i] = 0;
+	}
+}
+
+static bool compareOpcodeStats(const Script::OpcodeStats &a, const Script::OpcodeStats &b) {
+	if (a.count != b.count)
+		return a.count > b.count;
+
+	return a.op < b.op;
+}
+
+Common::Array<Script::OpcodeStats> Script::getProfile() {
+	Common::Array<OpcodeStats> profile;
+
+	for (uint i = 0; i < ARRAYSIZE(_opcodeCount); i++) {
+		if (!_opcodeCount[i])
+			continue;
+
+		OpcodeStats stats;
+		stats.op = i;
+		stats.name = findCommand(i).desc;
+		stats.count = _opcodeCount[i];
+		stats.time = _opcodeTime[i];
+		profile.push_back(stats);
+	}
+
+	Common::sort(profile.begin(), profile.end(), compareOpcodeStats);
+
+	return profile;
 }
 
 void Script::runSingleOp(const Opcode &op) {
@@ -1408,12 +1511,10 @@ void Script::ifElse(Context &c, const Opcode &cmd) {
 }
 
 void Script::goToElse(Context &c) {
-	const Command &elseCommand = findCommandByProc(&Script::ifElse);
-
 	// Go to next command until an else statement is met
 	do {
 		c.op++;
-	} while (c.op != c.script->end() && c.op->op != elseCommand.op);
+	} while (c.op != c.script->end() && c.op->op != _elseOp);
 }
 
 void Script::ifCondition(Context &c, const Opcode &cmd) {
@@ -1974,6 +2075,7 @@ void Script::runScriptWhileDragging(Context &c, const Opcode &cmd) {
 void Script::chooseNextNode(Context &c, const Opcode &cmd) {
 	debugC(kDebugScript, "Opcode %d: Choose next node using condition %d", cmd.op, cmd.args[0]);
 
+	// The node is resolved with valueOrVarValue() when it is loaded
 	if (_vm->_state->evaluate(cmd.args[0]))
 		_vm->_state->setLocationNextNode(cmd.args[1]);
 	else
@@ -2149,8 +2251,6 @@ void Script::drawWhileCond(Context &c, const Opcode &cmd) {
 }
 
 void Script::whileStart(Context &c, const Opcode &cmd) {
-	const Command &whileEndCommand = findCommandByProc(&Script::whileEnd);
-
 	c.whileStart = c.op - 1;
 
 	// Check the while condition
@@ -2158,7 +2258,7 @@ void Script::whileStart(Context &c, const Opcode &cmd) {
 		// Condition is false, go to the next opcode after the end of the while loop
 		do {
 			c.op++;
-		} while (c.op != c.script->end() && c.op->op != whileEndCommand.op);
+		} while (c.op != c.script->end() && c.op->op != _whileEndOp);
 	}
 
 	_vm->processInput(false);
@@ -38,11 +38,44 @@ public:
 	Script(Myst3Engine *vm);
 	virtual ~Script();
 
+	/**
+	 * Run a script
+	 *
+	 * Only the command lookup is direct-indexed. The opcodes are still walked
+	 * from the Common::Array<Opcode> the Database read, including for the hotspot
+	 * and condition scripts evaluated on every mouse move.
+	 */
 	bool run(const Common::Array<Opcode> *script);
 	void runSingleOp(const Opcode &op);
 
 	const Common::String describeOpcode(const Opcode &opcode);
 
+	/**
+	 * Append to nodes the nodes from the specified room a script can move to
+	 *
+	 * Only the node changing opcodes are inspected, the script is not run.
+	 */
+	void listDestinationNodes(const Common::Array<Opcode> &script, uint32 roomID, Common::Array<uint16> &nodes);
+
+	/**
+	 * Execution statistics for an opcode, gathered while profiling is enabled
+	 */
+	struct OpcodeStats {
+		uint16 op;
+		const char *name;
+		uint32 count;
+		uint64 time; // In microseconds, including the nested scripts and frames drawn
+	};
+
+	void setProfiling(bool profiling) { _profiling = profiling; }
+	bool isProfiling() const { return _profiling; }
+	void resetProfile();
+
+	/**
+	 * Get the statistics for the opcodes run since the last reset, most run first
+	 */
+	Common::Array<OpcodeStats> getProfile();
+
 private:
 	struct Context {
 		bool endScript;
@@ -77,8 +110,22 @@ private:
 
 	Common::Array<Command> _commands;
 
+	// Index in _commands of the command for each opcode, 0 for the invalid ones
+	uint16 _commandIndex[256];
+
+	// Opcodes the flow control commands look for
+	uint16 _elseOp;
+	uint16 _whileEndOp;
+
+	bool _profiling;
+	uint32 _opcodeCount[256];
+	uint64 _opcodeTime[256];
+
+	void buildCommandIndex();
+
 	const Command &findCommand(uint16 op);
 	const Command &findCommandByProc(CommandProc proc);
+	void addDestinationNode(int16 node, Common::Array<uint16> &nodes);
 	const Common::String describeCommand(uint16 op);
 	const Common::String describeArgument(char type, int16 value);
 
@@ -28,11 +28,132 @@
 
 #include "common/debug.h"
 #include "common/file.h"
-#include "common/substream.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
 
 namespace Stark {
 namespace Formats {
 
+// SHARED ARCHIVE FILE
+
+/**
+ * The archive file handle, shared by all the member streams
+ *
+ * The position of the handle is tracked so sequential reads from
+ * the same member don't need to seek.
+ */
+class XARCSharedFile {
+public:
+	XARCSharedFile() : _position(0) {}
+
+	bool open(const Common::String &filename) {
+		return _file.open(filename);
+	}
+
+	Common::SeekableReadStream &getStream() {
+		return _file;
+	}
+
+	uint32 read(uint32 offset, void *dataPtr, uint32 dataSize) {
+		Common::StackLock lock(_mutex);
+
+		if (_position != offset || _file.err()) {
+			_file.clearErr();
+			_file.seek(offset);
+		}
+
+		uint32 bytesRead = _file.read(dataPtr, dataSize);
+		_position = offset + bytesRead;
+
+		return bytesRead;
+	}
+
+private:
+	Common::File _file;
+	Common::Mutex _mutex;
+	uint32 _position;
+};
+
+// MEMBER STREAMS
+
+/**
+ * Reads a member from the shared archive file handle, with its own position
+ */
+class XARCMemberStream : public Common::SeekableReadStream {
+public:
+	XARCMemberStream(const Common::SharedPtr<XARCSharedFile> &file, uint32 offset, uint32 length) :
+			_file(file),
+			_offset(offset),
+			_length(length),
+			_pos(0),
+			_eos(false) {
+	}
+
+	// ReadStream API
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		if (dataSize > _length - _pos) {
+			dataSize = _length - _pos;
+			_eos = true;
+		}
+
+		uint32 bytesRead = _file->read(_offset + _pos, dataPtr, dataSize);
+		_pos += bytesRead;
+
+		return bytesRead;
+	}
+
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+
+	// SeekableReadStream API
+	int32 pos() const override { return _pos; }
+	int32 size() const override { return _length; }
+
+	bool seek(int32 offset, int whence = SEEK_SET) override {
+		switch (whence) {
+		case SEEK_END:
+			offset = _length + offset;
+			break;
+		case SEEK_CUR:
+			offset = _pos + offset;
+			break;
+		case SEEK_SET:
+		default:
+			break;
+		}
+
+		if (offset < 0 || (uint32)offset > _length)
+			return false;
+
+		_pos = offset;
+		_eos = false;
+		return true;
+	}
+
+private:
+	Common::SharedPtr<XARCSharedFile> _file;
+	uint32 _offset;
+	uint32 _length;
+	uint32 _pos;
+	bool _eos;
+};
+
+/**
+ * Reads a member straight out of the mapped archive, and keeps
+ * the mapping alive for as long as the stream exists.
+ */
+class XARCMappedStream : public Common::MemoryReadStream {
+public:
+	XARCMappedStream(const Common::SharedPtr<Common::FileMapping> &mapping, uint32 offset, uint32 length) :
+			Common::MemoryReadStream(mapping->getData() + offset, length),
+			_mapping(mapping) {
+	}
+
+private:
+	Common::SharedPtr<Common::FileMapping> _mapping;
+};
+
 // ARCHIVE MEMBER
 
 class XARCMember : public Common::ArchiveMember {
@@ -96,12 +217,15 @@ Common::String XARCMember::readString(Common::ReadStream &stream) {
 // ARCHIVE
 
 bool XARCArchive::open(const Common::String &filename) {
-	Common::File stream;
-	if (!stream.open(filename)) {
+	Common::SharedPtr<XARCSharedFile> file(new XARCSharedFile());
+	if (!file->open(filename)) {
 		return false;
 	}
 
 	_filename = filename;
+	_file = file;
+
+	Common::SeekableReadStream &stream = _file->getStream();
 
 	// Unknown: always 1? version?
 	uint32 unknown = stream.readUint32LE();
@@ -120,29 +244,46 @@ bool XARCArchive::open(const Common::String &filename) {
 
 	for (uint32 i = 0; i < numFiles; i++) {
 		XARCMember *member = new XARCMember(this, stream, offset);
-		_members.push_back(Common::ArchiveMemberPtr(member));
+		Common::ArchiveMemberPtr memberPtr(member);
+		_members.push_back(memberPtr);
+
+		// The first member with a given name wins, like with a linear search
+		if (!_membersByName.contains(member->getName())) {
+			_membersByName[member->getName()] = memberPtr;
+		}
 
 		// Set the offset to the next member
 		offset += member->getLength();
 	}
 
+	mapFile();
+
 	return true;
 }
 
+void XARCArchive::mapFile() {
+	// Only archives that live directly on a filesystem can be mapped
+	Common::ArchiveMemberPtr archiveMember = SearchMan.getMember(_filename);
+	const Common::FSNode *node = dynamic_cast<const Common::FSNode *>(archiveMember.get());
+	if (!node)
+		return;
+
+	Common::FileMapping *mapping = node->createReadMapping();
+	if (!mapping)
+		return;
+
+	_mapping = Common::SharedPtr<Common::FileMapping>(mapping);
+
+	// The file handle is no longer needed
+	_file.reset();
+}
+
 Common::String XARCArchive::getFilename() const {
 	return _filename;
 }
 
 bool XARCArchive::hasFile(const Common::String &name) const {
-	for (Common::ArchiveMemberList::const_iterator it = _members.begin(); it != _members.end(); ++it) {
-		if ((*it)->getName() == name) {
-			// Found it
-			return true;
-		}
-	}
-
-	// Not found
-	return false;
+	return _membersByName.contains(name);
 }
 
 int XARCArchive::listMatchingMembers(Common::ArchiveMemberList &list, const Common::String &pattern) const {
@@ -170,48 +311,39 @@ int XARCArchive::listMembers(Common::ArchiveMemberList &list) const {
 }
 
 const Common::ArchiveMemberPtr XARCArchive::getMember(const Common::String &name) const {
-	for (Common::ArchiveMemberList::const_iterator it = _members.begin(); it != _members.end(); ++it) {
-		if ((*it)->getName() == name) {
-			// Found it
-			return *it;
-		}
-	}
-
 	// Not found, return an empty ptr
-	return Common::ArchiveMemberPtr();
+	return _membersByName.getVal(name, Common::ArchiveMemberPtr());
 }
 
 Common::SeekableReadStream *XARCArchive::createReadStreamForMember(const Common::String &name) const {
-	for (Common::ArchiveMemberList::const_iterator it = _members.begin(); it != _members.end(); ++it) {
-		if ((*it)->getName() == name) {
-			// Found it
-			return createReadStreamForMember((const XARCMember *)it->get());
-		}
+	MemberMap::const_iterator it = _membersByName.find(name);
+	if (it == _membersByName.end()) {
+		// Not found
+		return 0;
 	}
 
-	// Not found
-	return 0;
+	return createReadStreamForMember((const XARCMember *)it->_value.get());
 }
 
 Common::SeekableReadStream *XARCArchive::createReadStreamForMember(const XARCMember *member) const {
-	// Open the xarc file
-	Common::File *f = new Common::File;
-	if (!f)
-		return NULL;
+	uint32 offset = member->getOffset();
+	uint32 length = member->getLength();
 
-	if (!f->open(_filename)) {
-		delete f;
-		return NULL;
+	if (_mapping) {
+		if (offset > _mapping->getSize() || length > _mapping->getSize() - offset) {
+			warning("Stark::XARC: \"%s\" member \"%s\" is out of the archive bounds", _filename.c_str(), member->getName().c_str());
+			return NULL;
+		}
+
+		return new XARCMappedStream(_mapping, offset, length);
 	}
 
-	// Return the substream that contains the archive member
-	uint32 offset = member->getOffset();
-	uint32 length = member->getLength();
-	return new Common::SeekableSubReadStream(f, offset, offset + length, DisposeAfterUse::YES);
+	if (!_file) {
+		return NULL;
+	}
 
-	// Different approach: keep the archive open and read full resources to memory
-	//f.seek(member->getOffset());
-	//return f.readStream(member->getLength());
+	// Return a stream that contains the archive member
+	return new XARCMemberStream(_file, offset, length);
 }
 
 } // End of namespace Formats
@@ -24,12 +24,20 @@
 #define STARK_ARCHIVE_H
 
 #include "common/archive.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/ptr.h"
 #include "common/stream.h"
 
+namespace Common {
+class FileMapping;
+}
+
 namespace Stark {
 namespace Formats {
 
 class XARCMember;
+class XARCSharedFile;
 
 class XARCArchive : public Common::Archive {
 public:
@@ -46,8 +54,18 @@ public:
 	Common::SeekableReadStream *createReadStreamForMember(const XARCMember *member) const;
 
 private:
+	void mapFile();
+
 	Common::String _filename;
 	Common::ArchiveMemberList _members;
+
+	typedef Common::HashMap<Common::String, Common::ArchiveMemberPtr> MemberMap;
+	MemberMap _membersByName;
+
+	// The archive is either mapped into memory, or read through a single file
+	// handle. Both are shared with the member streams, which can outlive the archive.
+	Common::SharedPtr<Common::FileMapping> _mapping;
+	Common::SharedPtr<XARCSharedFile> _file;
 };
 
 } // End of namespace Formats
@@ -132,6 +132,13 @@ Common::String XRCReadStream::getArchiveName() const {
 }
 
 Resources::Object *XRCReader::importTree(XARCArchive *archive) {
+	Resources::Object *root = readTree(archive);
+	postReadTree(root);
+
+	return root;
+}
+
+Resources::Object *XRCReader::readTree(XARCArchive *archive) {
 	// Find the XRC file
 	Common::ArchiveMemberList members;
 	archive->listMatchingMembers(members, "*.xrc");
@@ -159,10 +166,17 @@ Resources::Object *XRCReader::importResource(XRCReadStream *stream, Resources::O
 	importResourceData(stream, resource);
 	importResourceChildren(stream, resource);
 
+	return resource;
+}
+
+void XRCReader::postReadTree(Resources::Object *resource) {
+	Common::Array<Resources::Object *> children = resource->listChildren<Resources::Object>();
+	for (uint i = 0; i < children.size(); i++) {
+		postReadTree(children[i]);
+	}
+
 	// Resource lifecycle update
 	resource->onPostRead();
-
-	return resource;
 }
 
 Resources::Object *XRCReader::createResource(XRCReadStream *stream, Resources::Object *parent) {
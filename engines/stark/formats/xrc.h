@@ -74,6 +74,21 @@ public:
 	 */
 	static Resources::Object *importTree(XARCArchive *archive);
 
+	/**
+	 * Build a resource tree from a stream, without running the post read lifecycle update
+	 *
+	 * Only the archive is accessed, this can be called from a worker thread
+	 * as long as nothing else uses the archive in the meantime.
+	 */
+	static Resources::Object *readTree(XARCArchive *archive);
+
+	/**
+	 * Run the post read lifecycle update on a tree built by readTree
+	 *
+	 * Must be called from the main thread.
+	 */
+	static void postReadTree(Resources::Object *resource);
+
 protected:
 	static Resources::Object *importResource(XRCReadStream *stream, Resources::Object *parent);
 	static Resources::Object *createResource(XRCReadStream *stream, Resources::Object *parent);
@@ -25,6 +25,7 @@ MODULE_OBJS := \
 	model/animhandler.o \
 	model/model.o \
 	model/skeleton_anim.o \
+	movement/floorfacetree.o \
 	movement/followpath.o \
 	movement/followpathlight.o \
 	movement/movement.o \
@@ -0,0 +1,335 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/stark/movement/floorfacetree.h"
+
+#include "common/algorithm.h"
+#include "common/util.h"
+
+#include <float.h>
+
+namespace Stark {
+
+struct FloorFaceTree::CenterAxisComparator {
+	int _axis;
+
+	CenterAxisComparator(int axis) : _axis(axis) {}
+
+	bool operator()(const Face &a, const Face &b) const {
+		if (a.center.getValue(_axis) != b.center.getValue(_axis)) {
+			return a.center.getValue(_axis) < b.center.getValue(_axis);
+		}
+
+		return a.index < b.index;
+	}
+};
+
+FloorFaceTree::FloorFaceTree() :
+		_root(-1) {
+}
+
+void FloorFaceTree::addFace(uint32 faceIndex, const Math::Vector3d &vertex1, const Math::Vector3d &vertex2, const Math::Vector3d &vertex3,
+                            const Math::Vector3d &center) {
+	Face face;
+	face.index = faceIndex;
+	face.center = center;
+
+	for (int i = 0; i < 3; i++) {
+		face.min.setValue(i, MIN(MIN(vertex1.getValue(i), vertex2.getValue(i)), vertex3.getValue(i)));
+		face.max.setValue(i, MAX(MAX(vertex1.getValue(i), vertex2.getValue(i)), vertex3.getValue(i)));
+	}
+
+	_faces.push_back(face);
+	_root = -1;
+}
+
+void FloorFaceTree::clear() {
+	_faces.clear();
+	_nodes.clear();
+	_root = -1;
+}
+
+void FloorFaceTree::build() {
+	_nodes.clear();
+	_root = -1;
+
+	if (_faces.empty()) {
+		return;
+	}
+
+	// The face checks are done with floats, the points found inside a face or on its plane
+	// can be slightly outside of its exact bounds. Grow the bounds by a margin to account for that.
+	float extent = 1.0f;
+	for (uint i = 0; i < _faces.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			extent = MAX(extent, ABS(_faces[i].min.getValue(j)));
+			extent = MAX(extent, ABS(_faces[i].max.getValue(j)));
+		}
+	}
+
+	float margin = extent * 0.0001f;
+	for (uint i = 0; i < _faces.size(); i++) {
+		_faces[i].min -= Math::Vector3d(margin, margin, margin);
+		_faces[i].max += Math::Vector3d(margin, margin, margin);
+	}
+
+	_nodes.reserve(2 * _faces.size() / kLeafSize + 1);
+	_root = buildNode(0, _faces.size());
+}
+
+int32 FloorFaceTree::buildNode(uint32 first, uint32 count) {
+	Node node;
+	node.min = _faces[first].min;
+	node.max = _faces[first].max;
+	node.minFaceIndex = _faces[first].index;
+	node.left = -1;
+	node.right = -1;
+	node.first = first;
+	node.count = count;
+
+	Math::Vector3d centersMin = _faces[first].center;
+	Math::Vector3d centersMax = _faces[first].center;
+	for (uint32 i = first + 1; i < first + count; i++) {
+		const Face &face = _faces[i];
+		for (int j = 0; j < 3; j++) {
+			node.min.setValue(j, MIN(node.min.getValue(j), face.min.getValue(j)));
+			node.max.setValue(j, MAX(node.max.getValue(j), face.max.getValue(j)));
+			centersMin.setValue(j, MIN(centersMin.getValue(j), face.center.getValue(j)));
+			centersMax.setValue(j, MAX(centersMax.getValue(j), face.center.getValue(j)));
+		}
+		node.minFaceIndex = MIN(node.minFaceIndex, face.index);
+	}
+
+	node.centersMiddle = (centersMin + centersMax) / 2.0;
+	node.centersRadius = 0.0f;
+	for (uint32 i = first; i < first + count; i++) {
+		node.centersRadius = MAX(node.centersRadius, node.centersMiddle.getDistanceTo(_faces[i].center));
+	}
+	// Keep the bound conservative despite the rounding errors
+	node.centersRadius = node.centersRadius * 1.001f + 0.001f;
+
+	int32 nodeIndex = _nodes.size();
+	_nodes.push_back(node);
+
+	if (count <= kLeafSize) {
+		return nodeIndex;
+	}
+
+	// Split the faces in two halves along the axis where the centers are the most spread
+	Math::Vector3d spread = centersMax - centersMin;
+	int axis = 0;
+	if (spread.y() > spread.getValue(axis)) {
+		axis = 1;
+	}
+	if (spread.z() > spread.getValue(axis)) {
+		axis = 2;
+	}
+
+	Common::sort(_faces.begin() + first, _faces.begin() + first + count, CenterAxisComparator(axis));
+
+	uint32 leftCount = count / 2;
+	int32 left = buildNode(first, leftCount);
+	int32 right = buildNode(first + leftCount, count - leftCount);
+
+	_nodes[nodeIndex].left = left;
+	_nodes[nodeIndex].right = right;
+
+	return nodeIndex;
+}
+
+int32 FloorFaceTree::findFirstFaceContainingPoint(const Math::Vector3d &point, const FaceFilter &filter) const {
+	int32 result = -1;
+	if (_root >= 0) {
+		findFirstFaceContainingPoint(_root, point, filter, result);
+	}
+	return result;
+}
+
+void FloorFaceTree::findFirstFaceContainingPoint(int32 nodeIndex, const Math::Vector3d &point, const FaceFilter &filter, int32 &result) const {
+	const Node &node = _nodes[nodeIndex];
+
+	if (result >= 0 && node.minFaceIndex >= (uint32)result) {
+		return; // The node only has faces after the current result
+	}
+
+	if (point.x() < node.min.x() || point.x() > node.max.x() || point.y() < node.min.y() || point.y() > node.max.y()) {
+		return;
+	}
+
+	if (node.left < 0) {
+		for (uint32 i = node.first; i < node.first + node.count; i++) {
+			const Face &face = _faces[i];
+			if (result >= 0 && face.index >= (uint32)result) {
+				continue;
+			}
+
+			if (point.x() < face.min.x() || point.x() > face.max.x() || point.y() < face.min.y() || point.y() > face.max.y()) {
+				continue;
+			}
+
+			if (filter.accept(face.index)) {
+				result = face.index;
+			}
+		}
+		return;
+	}
+
+	// Visit the child with the lowest face indices first so the other can be skipped
+	int32 first = node.left;
+	int32 second = node.right;
+	if (_nodes[second].minFaceIndex < _nodes[first].minFaceIndex) {
+		SWAP(first, second);
+	}
+
+	findFirstFaceContainingPoint(first, point, filter, result);
+	findFirstFaceContainingPoint(second, point, filter, result);
+}
+
+int32 FloorFaceTree::findFirstFaceHitByRay(const Math::Ray &ray, const FaceFilter &filter) const {
+	int32 result = -1;
+	if (_root >= 0) {
+		findFirstFaceHitByRay(_root, ray, filter, result);
+	}
+	return result;
+}
+
+void FloorFaceTree::findFirstFaceHitByRay(int32 nodeIndex, const Math::Ray &ray, const FaceFilter &filter, int32 &result) const {
+	const Node &node = _nodes[nodeIndex];
+
+	if (result >= 0 && node.minFaceIndex >= (uint32)result) {
+		return; // The node only has faces after the current result
+	}
+
+	if (!intersectBounds(ray, node.min, node.max)) {
+		return;
+	}
+
+	if (node.left < 0) {
+		for (uint32 i = node.first; i < node.first + node.count; i++) {
+			const Face &face = _faces[i];
+			if (result >= 0 && face.index >= (uint32)result) {
+				continue;
+			}
+
+			if (intersectBounds(ray, face.min, face.max) && filter.accept(face.index)) {
+				result = face.index;
+			}
+		}
+		return;
+	}
+
+	int32 first = node.left;
+	int32 second = node.right;
+	if (_nodes[second].minFaceIndex < _nodes[first].minFaceIndex) {
+		SWAP(first, second);
+	}
+
+	findFirstFaceHitByRay(first, ray, filter, result);
+	findFirstFaceHitByRay(second, ray, filter, result);
+}
+
+int32 FloorFaceTree::findFaceClosestToRay(const Math::Ray &ray, const FaceFilter &filter) const {
+	int32 result = -1;
+	float resultDistance = FLT_MAX;
+	if (_root >= 0) {
+		findFaceClosestToRay(_root, ray, ray.getDirection().getMagnitude(), filter, result, resultDistance);
+	}
+	return result;
+}
+
+void FloorFaceTree::findFaceClosestToRay(int32 nodeIndex, const Math::Ray &ray, float directionLength, const FaceFilter &filter,
+                                         int32 &result, float &resultDistance) const {
+	const Node &node = _nodes[nodeIndex];
+
+	// The distance of the face centers to the ray can't be lower than
+	// the distance of their bounding sphere
+	float minDistance = distanceToRay(node.centersMiddle, ray) - node.centersRadius * directionLength;
+	if (minDistance > resultDistance) {
+		return;
+	}
+
+	if (node.left < 0) {
+		for (uint32 i = node.first; i < node.first + node.count; i++) {
+			const Face &face = _faces[i];
+
+			float distance = distanceToRay(face.center, ray);
+			if (distance > resultDistance || (distance == resultDistance && face.index > (uint32)result)) {
+				continue;
+			}
+
+			if (filter.accept(face.index)) {
+				result = face.index;
+				resultDistance = distance;
+			}
+		}
+		return;
+	}
+
+	// Visit the closest child first so the other can be skipped
+	int32 first = node.left;
+	int32 second = node.right;
+	if (distanceToRay(_nodes[second].centersMiddle, ray) < distanceToRay(_nodes[first].centersMiddle, ray)) {
+		SWAP(first, second);
+	}
+
+	findFaceClosestToRay(first, ray, directionLength, filter, result, resultDistance);
+	findFaceClosestToRay(second, ray, directionLength, filter, result, resultDistance);
+}
+
+float FloorFaceTree::distanceToRay(const Math::Vector3d &point, const Math::Ray &ray) {
+	return Math::Vector3d::crossProduct(ray.getDirection(), point - ray.getOrigin()).getMagnitude();
+}
+
+bool FloorFaceTree::intersectBounds(const Math::Ray &ray, const Math::Vector3d &min, const Math::Vector3d &max) {
+	const Math::Vector3d &origin = ray.getOrigin();
+	const Math::Vector3d &direction = ray.getDirection();
+
+	// Only the part of the ray in front of its origin can hit the faces
+	float tMin = 0.0f;
+	float tMax = FLT_MAX;
+
+	for (int i = 0; i < 3; i++) {
+		if (direction.getValue(i) == 0.0f) {
+			// The ray is parallel to the slab
+			if (origin.getValue(i) < min.getValue(i) || origin.getValue(i) > max.getValue(i)) {
+				return false;
+			}
+			continue;
+		}
+
+		float t1 = (min.getValue(i) - origin.getValue(i)) / direction.getValue(i);
+		float t2 = (max.getValue(i) - origin.getValue(i)) / direction.getValue(i);
+		if (t1 > t2) {
+			SWAP(t1, t2);
+		}
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+		if (tMin > tMax) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // End of namespace Stark
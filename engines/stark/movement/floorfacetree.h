@@ -0,0 +1,133 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef STARK_MOVEMENT_FLOOR_FACE_TREE_H
+#define STARK_MOVEMENT_FLOOR_FACE_TREE_H
+
+#include "common/array.h"
+
+#include "math/ray.h"
+#include "math/vector3d.h"
+
+namespace Stark {
+
+/**
+ * A bounding volume hierarchy of the floor faces
+ *
+ * The queries only run the exact face checks on the faces whose bounds
+ * are near the point or the ray, and return the same face as a scan
+ * of all the faces by increasing index would.
+ */
+class FloorFaceTree {
+public:
+	/** Exact check of a face, run by the queries on the faces passing the bounds check */
+	class FaceFilter {
+	public:
+		virtual ~FaceFilter() {}
+		virtual bool accept(uint32 faceIndex) const = 0;
+	};
+
+	FloorFaceTree();
+
+	/** Add a triangle face to the tree. The tree needs to be built again afterwards. */
+	void addFace(uint32 faceIndex, const Math::Vector3d &vertex1, const Math::Vector3d &vertex2, const Math::Vector3d &vertex3,
+	             const Math::Vector3d &center);
+
+	/** Build the hierarchy from the added faces */
+	void build();
+
+	/** Remove all the faces */
+	void clear();
+
+	/**
+	 * Find the accepted face with the lowest index whose bounds contain the point
+	 * when both are projected on a Z=0 plane
+	 *
+	 * @return -1 if no face was found, the face index otherwise
+	 */
+	int32 findFirstFaceContainingPoint(const Math::Vector3d &point, const FaceFilter &filter) const;
+
+	/**
+	 * Find the accepted face with the lowest index whose bounds are hit by the ray
+	 *
+	 * @return -1 if no face was found, the face index otherwise
+	 */
+	int32 findFirstFaceHitByRay(const Math::Ray &ray, const FaceFilter &filter) const;
+
+	/**
+	 * Find the accepted face with its center closest to the ray
+	 *
+	 * The face with the lowest index is returned when several faces are at the same distance.
+	 *
+	 * @return -1 if no face was found, the face index otherwise
+	 */
+	int32 findFaceClosestToRay(const Math::Ray &ray, const FaceFilter &filter) const;
+
+	/** Compute the distance between a point and a ray, used to compare the face centers */
+	static float distanceToRay(const Math::Vector3d &point, const Math::Ray &ray);
+
+private:
+	static const uint kLeafSize = 4;
+
+	struct Face {
+		uint32 index;
+		Math::Vector3d min;
+		Math::Vector3d max;
+		Math::Vector3d center;
+	};
+
+	struct Node {
+		Math::Vector3d min;
+		Math::Vector3d max;
+
+		// Bounding sphere of the face centers
+		Math::Vector3d centersMiddle;
+		float centersRadius;
+
+		uint32 minFaceIndex;
+
+		// Children nodes for inner nodes, range of faces for the leaves
+		int32 left;
+		int32 right;
+		uint32 first;
+		uint32 count;
+	};
+
+	struct CenterAxisComparator;
+
+	int32 buildNode(uint32 first, uint32 count);
+
+	void findFirstFaceContainingPoint(int32 node, const Math::Vector3d &point, const FaceFilter &filter, int32 &result) const;
+	void findFirstFaceHitByRay(int32 node, const Math::Ray &ray, const FaceFilter &filter, int32 &result) const;
+	void findFaceClosestToRay(int32 node, const Math::Ray &ray, float directionLength, const FaceFilter &filter,
+	                          int32 &result, float &resultDistance) const;
+
+	static bool intersectBounds(const Math::Ray &ray, const Math::Vector3d &min, const Math::Vector3d &max);
+
+	Common::Array<Face> _faces;
+	Common::Array<Node> _nodes;
+	int32 _root;
+};
+
+} // End of namespace Stark
+
+#endif // STARK_MOVEMENT_FLOOR_FACE_TREE_H
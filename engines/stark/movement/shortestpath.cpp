@@ -22,54 +22,76 @@
 
 #include "engines/stark/movement/shortestpath.h"
 
-#include "common/hash-ptr.h"
-
 #include "engines/stark/resources/floor.h"
 
 namespace Stark {
 
-ShortestPath::NodeList ShortestPath::search(const Resources::FloorEdge *start, const Resources::FloorEdge *goal) {
-	NodeList frontier;
-	NodePrecedenceMap cameFrom;
-	NodeCostMap costSoFar;
+ShortestPath::NodeList ShortestPath::search(const Resources::Floor *floor, const Resources::FloorEdge *start, const Resources::FloorEdge *goal) {
+	// Reset the search state in place, clear() would release the storage
+	_nodes.resize(floor->getEdgeCount());
+	for (uint32 i = 0; i < _nodes.size(); i++) {
+		Node &node = _nodes[i];
+		node.cameFrom = nullptr;
+		node.costSoFar = 0;
+		node.estimatedCost = 0;
+		node.heapIndex = -1;
+		node.reached = false;
+		node.closed = false;
+	}
+	_frontier.resize(0);
+
+	Math::Vector3d goalPosition = goal->getPosition();
 
-	frontier.push_back(start);
-	cameFrom[start] = nullptr;
-	costSoFar[start] = 0;
+	Node &startNode = getNode(start);
+	startNode.reached = true;
+	startNode.costSoFar = 0;
+	startNode.estimatedCost = start->getPosition().getDistanceTo(goalPosition);
+	pushOrUpdateEdge(start);
 
-	while (!frontier.empty()) {
-		const Resources::FloorEdge *current = popEdgeWithLowestCost(frontier, costSoFar);
+	while (!_frontier.empty()) {
+		const Resources::FloorEdge *current = popEdgeWithLowestCost();
 
 		if (current == goal)
 			break;
 
-		Common::Array<Resources::FloorEdge *> neighbours = current->getNeighbours();
+		float currentCost = getNode(current).costSoFar;
+
+		const Common::Array<Resources::FloorEdge *> &neighbours = current->getNeighbours();
 		for (uint i = 0; i < neighbours.size(); i++) {
 			const Resources::FloorEdge *next = neighbours[i];
 			if (!next->isEnabled())
 				continue;
 
-			float newCost = costSoFar[current] + current->costTo(next);
-			if (!costSoFar.contains(next) || newCost < costSoFar[next]) {
-				frontier.push_back(next);
-				cameFrom[next] = current;
-				costSoFar[next] = newCost;
+			Node &nextNode = getNode(next);
+			if (nextNode.closed)
+				continue;
+
+			float newCost = currentCost + current->costTo(next);
+			if (!nextNode.reached || newCost < nextNode.costSoFar) {
+				nextNode.reached = true;
+				nextNode.cameFrom = current;
+				nextNode.costSoFar = newCost;
+				nextNode.estimatedCost = newCost + next->getPosition().getDistanceTo(goalPosition);
+				pushOrUpdateEdge(next);
 			}
 		}
 	}
 
-	return rebuildPath(start, goal, cameFrom);
+	return rebuildPath(start, goal);
+}
+
+ShortestPath::Node &ShortestPath::getNode(const Resources::FloorEdge *edge) {
+	return _nodes[edge->getIndex()];
 }
 
-ShortestPath::NodeList ShortestPath::rebuildPath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal,
-                                                 const NodePrecedenceMap &cameFrom) const {
+ShortestPath::NodeList ShortestPath::rebuildPath(const Resources::FloorEdge *start, const Resources::FloorEdge *goal) {
 	NodeList path;
 
 	const Resources::FloorEdge *current = goal;
 	path.push_front(goal);
 
 	while (current && current != start) {
-		current = cameFrom[current];
+		current = getNode(current).cameFrom;
 		path.push_front(current);
 	}
 
@@ -82,20 +104,69 @@ ShortestPath::NodeList ShortestPath::rebuildPath(const Resources::FloorEdge *sta
 	return path;
 }
 
-const Resources::FloorEdge *ShortestPath::popEdgeWithLowestCost(NodeList &frontier, const NodeCostMap &costSoFar) const {
-	// Poor man's priority queue using a list ...
-	NodeList::iterator lowestCostItem = frontier.begin();
-	for (NodeList::iterator it = frontier.begin(); it != frontier.end(); it++) {
-		if (costSoFar[*it] < costSoFar[*lowestCostItem]) {
-			lowestCostItem = it;
-		}
+void ShortestPath::pushOrUpdateEdge(const Resources::FloorEdge *edge) {
+	Node &node = getNode(edge);
+	if (node.heapIndex < 0) {
+		node.heapIndex = _frontier.size();
+		_frontier.push_back(edge);
 	}
 
-	const Resources::FloorEdge *result = *lowestCostItem;
+	// The cost of a node only ever decreases, so it can only move up in the heap
+	siftUp(node.heapIndex);
+}
 
-	frontier.erase(lowestCostItem);
+const Resources::FloorEdge *ShortestPath::popEdgeWithLowestCost() {
+	const Resources::FloorEdge *result = _frontier[0];
+
+	swapHeapItems(0, _frontier.size() - 1);
+	_frontier.pop_back();
+	if (!_frontier.empty()) {
+		siftDown(0);
+	}
+
+	Node &node = getNode(result);
+	node.heapIndex = -1;
+	node.closed = true;
 
 	return result;
 }
 
+void ShortestPath::siftUp(uint32 heapIndex) {
+	while (heapIndex > 0) {
+		uint32 parent = (heapIndex - 1) / 2;
+		if (_nodes[_frontier[parent]->getIndex()].estimatedCost <= _nodes[_frontier[heapIndex]->getIndex()].estimatedCost)
+			break;
+
+		swapHeapItems(parent, heapIndex);
+		heapIndex = parent;
+	}
+}
+
+void ShortestPath::siftDown(uint32 heapIndex) {
+	while (true) {
+		uint32 lowest = heapIndex;
+		uint32 left = 2 * heapIndex + 1;
+		uint32 right = left + 1;
+
+		if (left < _frontier.size()
+		    && _nodes[_frontier[left]->getIndex()].estimatedCost < _nodes[_frontier[lowest]->getIndex()].estimatedCost)
+			lowest = left;
+		if (right < _frontier.size()
+		    && _nodes[_frontier[right]->getIndex()].estimatedCost < _nodes[_frontier[lowest]->getIndex()].estimatedCost)
+			lowest = right;
+
+		if (lowest == heapIndex)
+			break;
+
+		swapHeapItems(lowest, heapIndex);
+		heapIndex = lowest;
+	}
+}
+
+void ShortestPath::swapHeapItems(uint32 heapIndex1, uint32 heapIndex2) {
+	SWAP(_frontier[heapIndex1], _frontier[heapIndex2]);
+	_nodes[_frontier[heapIndex1]->getIndex()].heapIndex = heapIndex1;
+	_nodes[_frontier[heapIndex2]->getIndex()].heapIndex = heapIndex2;
+}
+
 } // End of namespace Stark
@@ -48,9 +48,11 @@ Walk::Walk(Resources::FloorPositionedItem *item) :
 		_collisionWaitTimeout(-1),
 		_collisionWaitCount(0) {
 	_path = new StringPullingPath();
+	_pathSearch = new ShortestPath();
 }
 
 Walk::~Walk() {
+	delete _pathSearch;
 	delete _path;
 }
 
@@ -112,8 +114,7 @@ void Walk::updatePath() const {
 		return;
 	}
 
-	ShortestPath pathSearch;
-	ShortestPath::NodeList edgePath = pathSearch.search(startFloorEdge, destinationFloorEdge);
+	ShortestPath::NodeList edgePath = _pathSearch->search(floor, startFloorEdge, destinationFloorEdge);
 
 	for (ShortestPath::NodeList::const_iterator it = edgePath.begin(); it != edgePath.end(); it++) {
 		_path->addStep((*it)->getPosition());
@@ -29,6 +29,7 @@
 
 namespace Stark {
 
+class ShortestPath;
 class StringPullingPath;
 
 namespace Resources {
@@ -80,6 +81,7 @@ private:
 
 	Resources::FloorPositionedItem *_item3D;
 	StringPullingPath *_path;
+	ShortestPath *_pathSearch;
 
 	Math::Vector3d _destination;
 	Common::Array<Math::Vector3d> _destinations;
@@ -217,8 +217,8 @@ AnimProp::~AnimProp() {
 
 AnimProp::AnimProp(Object *parent, byte subType, uint16 index, const Common::String &name) :
 		Anim(parent, subType, index, name),
-		_movementSpeed(100) {
-	_visual = StarkGfx->createPropRenderer();
+		_movementSpeed(100),
+		_visual(nullptr) {
 }
 
 Visual *AnimProp::getVisual() {
@@ -249,6 +249,10 @@ void AnimProp::onPostRead() {
 		error("Unexpected mesh count in prop anim: '%d'", _meshFilenames.size());
 	}
 
+	// The renderer is created here rather than in the constructor,
+	// the resource tree may be read on a worker thread
+	_visual = StarkGfx->createPropRenderer();
+
 	ArchiveReadStream *stream = StarkArchiveLoader->getFile(_meshFilenames[0], _archiveName);
 	_visual->setModel(Formats::BiffMeshReader::read(stream));
 	delete stream;
@@ -497,12 +501,12 @@ AnimSkeleton::AnimSkeleton(Object *parent, byte subType, uint16 index, const Com
 		_movementSpeed(100),
 		_idleActionFrequency(1),
 		_skeletonAnim(nullptr),
+		_visual(nullptr),
 		_currentTime(0),
 		_totalTime(0),
 		_done(false),
 		_actionItem(nullptr),
 		_shouldResetItem(true) {
-	_visual = StarkGfx->createActorRenderer();
 }
 
 void AnimSkeleton::applyToItem(Item *item) {
@@ -578,6 +582,8 @@ void AnimSkeleton::readData(Formats::XRCReadStream *stream) {
 }
 
 void AnimSkeleton::onPostRead() {
+	_visual = StarkGfx->createActorRenderer();
+
 	ArchiveReadStream *stream = StarkArchiveLoader->getFile(_animFilename, _archiveName);
 
 	_skeletonAnim = new SkeletonAnim();
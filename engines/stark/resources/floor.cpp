@@ -34,6 +34,68 @@
 namespace Stark {
 namespace Resources {
 
+/** Faces containing a point, used with the floor face tree */
+class FaceContainingPointFilter : public FloorFaceTree::FaceFilter {
+public:
+	FaceContainingPointFilter(const Common::Array<FloorFace *> &faces, const Math::Vector3d &point) :
+			_faces(faces),
+			_point(point) {
+	}
+
+	bool accept(uint32 faceIndex) const override {
+		return _faces[faceIndex]->isPointInside(_point);
+	}
+
+private:
+	const Common::Array<FloorFace *> &_faces;
+	Math::Vector3d _point;
+};
+
+/** Faces hit by a ray, used with the floor face tree */
+class FaceHitByRayFilter : public FloorFaceTree::FaceFilter {
+public:
+	FaceHitByRayFilter(const Common::Array<FloorFace *> &faces, const Math::Ray &ray) :
+			_faces(faces),
+			_ray(ray) {
+	}
+
+	bool accept(uint32 faceIndex) const override {
+		Math::Vector3d intersection;
+		if (!_faces[faceIndex]->intersectRay(_ray, intersection)) {
+			return false;
+		}
+
+		// The last accepted face is the result of the query
+		_intersection = intersection;
+		return true;
+	}
+
+	Math::Vector3d getIntersection() const {
+		return _intersection;
+	}
+
+private:
+	const Common::Array<FloorFace *> &_faces;
+	Math::Ray _ray;
+	mutable Math::Vector3d _intersection;
+};
+
+/** Faces characters can walk on, used with the floor face tree */
+class EnabledFaceFilter : public FloorFaceTree::FaceFilter {
+public:
+	EnabledFaceFilter(const Common::Array<FloorFace *> &faces) :
+			_faces(faces) {
+	}
+
+	bool accept(uint32 faceIndex) const override {
+		// For some reason, face 0 is not being considered
+		return faceIndex != 0 && _faces[faceIndex]->isEnabled();
+	}
+
+private:
+	const Common::Array<FloorFace *> &_faces;
+};
+
 Floor::Floor(Object *parent, byte subType, uint16 index, const Common::String &name) :
 		Object(parent, subType, index, name),
 		_facesCount(0) {
@@ -48,13 +110,8 @@ Math::Vector3d Floor::getVertex(uint32 index) const {
 }
 
 int32 Floor::findFaceContainingPoint(const Math::Vector3d &point) const {
-	for (uint32 i = 0; i < _faces.size(); i++) {
-		if (_faces[i]->hasVertices() && _faces[i]->isPointInside(point)) {
-			return i;
-		}
-	}
-
-	return -1;
+	FaceContainingPointFilter filter(_faces, point);
+	return _faceTree.findFirstFaceContainingPoint(point, filter);
 }
 
 void Floor::computePointHeightInFace(Math::Vector3d &point, uint32 faceIndex) const {
@@ -62,34 +119,23 @@ void Floor::computePointHeightInFace(Math::Vector3d &point, uint32 faceIndex) co
 }
 
 int32 Floor::findFaceHitByRay(const Math::Ray &ray, Math::Vector3d &intersection) const {
-	for (uint32 i = 0; i < _faces.size(); i++) {
-		// TODO: Check the ray's intersection with an AABB first if this ends up being slow
-		if (_faces[i]->intersectRay(ray, intersection)) {
-			if (_faces[i]->isEnabled()) {
-				return i;
-			} else {
-				return -1; // Disabled faces block the ray
-			}
-		}
+	FaceHitByRayFilter filter(_faces, ray);
+	int32 faceIndex = _faceTree.findFirstFaceHitByRay(ray, filter);
+	if (faceIndex < 0) {
+		return -1;
+	}
+
+	if (!_faces[faceIndex]->isEnabled()) {
+		return -1; // Disabled faces block the ray
 	}
 
-	return -1;
+	intersection = filter.getIntersection();
+	return faceIndex;
 }
 
 int32 Floor::findFaceClosestToRay(const Math::Ray &ray, Math::Vector3d &center) const {
-	float minDistance = FLT_MAX;
-	int32 minFace = -1;
-
-	// For some reason, face 0 is not being considered
-	for (uint32 i = 1; i < _faces.size(); i++) {
-		if (_faces[i]->isEnabled() && _faces[i]->hasVertices()) {
-			float distance = _faces[i]->distanceToRay(ray);
-			if (distance < minDistance) {
-				minFace = i;
-				minDistance = distance;
-			}
-		}
-	}
+	EnabledFaceFilter filter(_faces);
+	int32 minFace = _faceTree.findFaceClosestToRay(ray, filter);
 
 	if (minFace >= 0) {
 		center = _faces[minFace]->getCenter();
@@ -107,6 +153,10 @@ FloorFace *Floor::getFace(uint32 index) const {
 	return _faces[index];
 }
 
+uint32 Floor::getEdgeCount() const {
+	return _edges.size();
+}
+
 bool Floor::isSegmentInside(const Math::Line3d &segment) const {
 	// The segment is inside the floor if at least one of its extremities is,
 	// and it does not cross any floor border / disabled floor faces
@@ -148,6 +198,7 @@ void Floor::onAllLoaded() {
 	_faces = listChildren<FloorFace>();
 
 	buildEdgeList();
+	buildFaceTree();
 }
 
 void Floor::saveLoad(ResourceSerializer *serializer) {
@@ -189,6 +240,23 @@ void Floor::buildEdgeList() {
 	}
 }
 
+void Floor::buildFaceTree() {
+	_faceTree.clear();
+
+	// Faces without vertices can't contain points or be hit by rays
+	for (uint i = 0; i < _faces.size(); i++) {
+		if (_faces[i]->hasVertices()) {
+			_faceTree.addFace(i,
+			                  getVertex(_faces[i]->getVertexIndex(0)),
+			                  getVertex(_faces[i]->getVertexIndex(1)),
+			                  getVertex(_faces[i]->getVertexIndex(2)),
+			                  _faces[i]->getCenter());
+		}
+	}
+
+	_faceTree.build();
+}
+
 void Floor::addFaceEdgeToList(uint32 faceIndex, uint32 index1, uint32 index2) {
 	uint32 vertexIndex1 = _faces[faceIndex]->getVertexIndex(index1);
 	uint32 vertexIndex2 = _faces[faceIndex]->getVertexIndex(index2);
@@ -203,7 +271,7 @@ void Floor::addFaceEdgeToList(uint32 faceIndex, uint32 index1, uint32 index2) {
 		}
 	}
 
-	_edges.push_back(FloorEdge(startIndex, endIndex, faceIndex));
+	_edges.push_back(FloorEdge(startIndex, endIndex, faceIndex, _edges.size()));
 }
 
 void Floor::enableFloorField(FloorField *floorfield, bool enable) {
@@ -223,11 +291,12 @@ void Floor::printData() {
 	}
 }
 
-FloorEdge::FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1) :
+FloorEdge::FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1, uint32 index) :
         _vertexIndex1(vertexIndex1),
         _vertexIndex2(vertexIndex2),
         _faceIndex1(faceIndex1),
         _faceIndex2(-1),
+        _index(index),
         _enabled(true) {
 }
 
@@ -239,10 +308,14 @@ void FloorEdge::setOtherFace(uint32 faceIndex) {
 	_faceIndex2 = faceIndex;
 }
 
-Common::Array<FloorEdge *> FloorEdge::getNeighbours() const {
+const Common::Array<FloorEdge *> &FloorEdge::getNeighbours() const {
 	return _neighbours;
 }
 
+uint32 FloorEdge::getIndex() const {
+	return _index;
+}
+
 float FloorEdge::costTo(const FloorEdge *other) const {
 	return _middle.getDistanceTo(other->_middle);
 }
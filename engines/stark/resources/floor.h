@@ -30,6 +30,7 @@
 #include "math/ray.h"
 #include "math/vector3d.h"
 
+#include "engines/stark/movement/floorfacetree.h"
 #include "engines/stark/resources/object.h"
 
 namespace Stark {
@@ -51,7 +52,7 @@ class FloorField;
  */
 class FloorEdge {
 public:
-	FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1);
+	FloorEdge(uint16 vertexIndex1, uint16 vertexIndex2, uint32 faceIndex1, uint32 index);
 
 	/** Build a list of neighbour edges in the graph */
 	void buildNeighbours(const Floor *floor);
@@ -66,7 +67,10 @@ public:
 	bool hasVertices(uint16 vertexIndex1, uint16 vertexIndex2) const;
 
 	/** List the edge neighbour edges in the floor */
-	Common::Array<FloorEdge *> getNeighbours() const;
+	const Common::Array<FloorEdge *> &getNeighbours() const;
+
+	/** Get the index of the edge in the floor edge list */
+	uint32 getIndex() const;
 
 	/**
 	 * Computes the cost for going to a neighbour edge
@@ -110,6 +114,7 @@ private:
 	Math::Vector3d _middle;
 	int32 _faceIndex1;
 	int32 _faceIndex2;
+	uint32 _index;
 
 	bool _enabled;
 
@@ -175,6 +180,9 @@ public:
 	/** Get a floor face by its index */
 	FloorFace *getFace(uint32 index) const;
 
+	/** Get the number of edges in the floor's edge graph, edge indices are below this count */
+	uint32 getEdgeCount() const;
+
 	/** Check if the segment is entirely inside the floor */
 	bool isSegmentInside(const Math::Line3d &segment) const;
 
@@ -187,11 +195,13 @@ protected:
 
 	void buildEdgeList();
 	void addFaceEdgeToList(uint32 faceIndex, uint32 index1, uint32 index2);
+	void buildFaceTree();
 
 	uint32 _facesCount;
 	Common::Array<Math::Vector3d> _vertices;
 	Common::Array<FloorFace *> _faces;
 	Common::Array<FloorEdge> _edges;
+	FloorFaceTree _faceTree;
 };
 
 } // End of namespace Resources
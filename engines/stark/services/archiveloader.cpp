@@ -22,34 +22,72 @@
 
 #include "engines/stark/services/archiveloader.h"
 
+#include "engines/stark/debug.h"
 #include "engines/stark/formats/xrc.h"
 #include "engines/stark/resources/level.h"
 #include "engines/stark/resources/location.h"
 
+#include "common/debug.h"
+#include "common/workerpool.h"
+
 namespace Stark {
 
 ArchiveLoader::LoadedArchive::LoadedArchive(const Common::String& archiveName) :
 		_filename(archiveName),
 		_root(nullptr),
-		_useCount(0) {
-	if (!_xarc.open(archiveName)) {
-		error("Unable to open archive '%s'", archiveName.c_str());
-	}
+		_useCount(0),
+		_postRead(false) {
 }
 
 ArchiveLoader::LoadedArchive::~LoadedArchive() {
 	// Resource lifecycle update
-	_root->onPreDestroy();
+	if (_postRead) {
+		_root->onPreDestroy();
+	}
 
 	delete _root;
 }
 
-void ArchiveLoader::LoadedArchive::importResources() {
+bool ArchiveLoader::LoadedArchive::open() {
+	return _xarc.open(_filename);
+}
+
+void ArchiveLoader::LoadedArchive::readResources() {
 	// Import the resource tree
-	_root = Formats::XRCReader::importTree(&_xarc);
+	_root = Formats::XRCReader::readTree(&_xarc);
+}
+
+void ArchiveLoader::LoadedArchive::postReadResources() {
+	Formats::XRCReader::postReadTree(_root);
+	_postRead = true;
+}
+
+class ArchiveLoader::PreloadJob : public Common::WorkerJob {
+public:
+	explicit PreloadJob(LoadedArchive *archive) :
+			_archive(archive) {
+	}
+
+	~PreloadJob() {
+		delete _archive;
+	}
+
+	void execute() override {
+		_archive->readResources();
+	}
+
+	LoadedArchive *_archive;
+};
+
+ArchiveLoader::ArchiveLoader() {
+	// Locations are changed one at a time, a single thread is enough to keep up
+	_preloadPool = new Common::WorkerPool(MIN<uint>(Common::WorkerPool::getDefaultThreadCount(), 1));
 }
 
 ArchiveLoader::~ArchiveLoader() {
+	discardPreloads();
+	delete _preloadPool;
+
 	for (LoadedArchiveList::iterator it = _archives.begin(); it != _archives.end(); it++) {
 		delete *it;
 	}
@@ -61,10 +99,20 @@ bool ArchiveLoader::load(const Common::String &archiveName) {
 		return false;
 	}
 
-	LoadedArchive *archive = new LoadedArchive(archiveName);
+	LoadedArchive *archive = takePreload(archiveName);
+	if (!archive) {
+		archive = new LoadedArchive(archiveName);
+		if (!archive->open()) {
+			error("Unable to open archive '%s'", archiveName.c_str());
+		}
+
+		archive->readResources();
+	}
+
 	_archives.push_back(archive);
 
-	archive->importResources();
+	// The post read step loads files from the archive, it has to be in the list
+	archive->postReadResources();
 
 	return true;
 }
@@ -79,6 +127,86 @@ void ArchiveLoader::unloadUnused() {
 	}
 }
 
+void ArchiveLoader::preload(const Common::String &archiveName) {
+	if (hasArchive(archiveName)) {
+		return;
+	}
+
+	PreloadJob *job = findPreload(archiveName);
+	if (job) {
+		// Move the archive to the back of the list so it is not discarded early
+		_preloads.remove(job);
+		_preloads.push_back(job);
+		return;
+	}
+
+	// Opening the archive goes through the search manager, which is not thread safe
+	LoadedArchive *archive = new LoadedArchive(archiveName);
+	if (!archive->open()) {
+		debugC(kDebugArchive, "Unable to preload archive '%s'", archiveName.c_str());
+		delete archive;
+		return;
+	}
+
+	while (_preloads.size() >= kMaxPreloads) {
+		PreloadJob *oldest = _preloads.front();
+		_preloads.pop_front();
+		releasePreload(oldest);
+	}
+
+	job = new PreloadJob(archive);
+	_preloads.push_back(job);
+	_preloadPool->queue(job);
+}
+
+bool ArchiveLoader::isPreloadAsync() const {
+	return _preloadPool->getThreadCount() > 0;
+}
+
+void ArchiveLoader::discardPreloads() {
+	while (!_preloads.empty()) {
+		PreloadJob *job = _preloads.front();
+		_preloads.pop_front();
+		releasePreload(job);
+	}
+}
+
+ArchiveLoader::PreloadJob *ArchiveLoader::findPreload(const Common::String &archiveName) const {
+	for (PreloadJobList::const_iterator it = _preloads.begin(); it != _preloads.end(); it++) {
+		if ((*it)->_archive->getFilename() == archiveName) {
+			return *it;
+		}
+	}
+
+	return nullptr;
+}
+
+ArchiveLoader::LoadedArchive *ArchiveLoader::takePreload(const Common::String &archiveName) {
+	PreloadJob *job = findPreload(archiveName);
+	if (!job) {
+		return nullptr;
+	}
+
+	_preloads.remove(job);
+	_preloadPool->wait(job);
+
+	debugC(kDebugArchive, "Using preloaded archive '%s'", archiveName.c_str());
+
+	LoadedArchive *archive = job->_archive;
+	job->_archive = nullptr;
+	delete job;
+
+	return archive;
+}
+
+void ArchiveLoader::releasePreload(PreloadJob *job) {
+	if (_preloadPool->cancel(job)) {
+		debugC(kDebugArchive, "Cancelled preloading archive '%s'", job->_archive->getFilename().c_str());
+	}
+
+	delete job;
+}
+
 ArchiveReadStream *ArchiveLoader::getFile(const Common::String &fileName, const Common::String &archiveName) {
 	LoadedArchive *archive = findArchive(archiveName);
 	const Formats::XARCArchive &xarc = archive->getXArc();
@@ -133,12 +261,16 @@ Common::String ArchiveLoader::buildArchiveName(Resources::Level *level, Resource
 			error("Unknown level type %d", level->getSubType());
 		}
 	} else {
-		archive = Common::String::format("%02x/%02x/%02x.xarc", level->getIndex(), location->getIndex(), location->getIndex());
+		archive = buildLocationArchiveName(level, location->getIndex());
 	}
 
 	return archive;
 }
 
+Common::String ArchiveLoader::buildLocationArchiveName(Resources::Level *level, uint16 locationIndex) const {
+	return Common::String::format("%02x/%02x/%02x.xarc", level->getIndex(), locationIndex, locationIndex);
+}
+
 Common::String ArchiveLoader::getExternalFilePath(const Common::String &fileName, const Common::String &archiveName) const {
 	static const char separator = '/';
 
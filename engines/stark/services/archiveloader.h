@@ -34,6 +34,10 @@
 #include "engines/stark/formats/xarc.h"
 #include "engines/stark/resources/object.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Stark {
 
 namespace Resources {
@@ -61,10 +65,15 @@ public:
  *
  * Maintains a list of opened archive files.
  * Loads the resources from the XRC tree.
+ *
+ * Archives can be preloaded ahead of time. The XRC tree of a preloaded
+ * archive is read on a worker thread, the rest of the loading process
+ * happens on the main thread once the archive is actually loaded.
  */
 class ArchiveLoader {
 
 public:
+	ArchiveLoader();
 	~ArchiveLoader();
 
 	/** Load a Xarc archive, and add it to the managed archives list */
@@ -73,6 +82,23 @@ public:
 	/** Unload all the unused Xarc archives */
 	void unloadUnused();
 
+	/**
+	 * Start reading a Xarc archive in the background
+	 *
+	 * Does nothing when the archive is already loaded or preloaded, or when it can't be opened.
+	 * The oldest preloaded archives are discarded when there are too many of them.
+	 */
+	void preload(const Common::String &archiveName);
+
+	/** Are the archives preloaded on a worker thread? When false, preloading is synchronous. */
+	bool isPreloadAsync() const;
+
+	/** Discard all the preloaded archives that have not been loaded */
+	void discardPreloads();
+
+	/** Number of preloaded archives kept around */
+	static const uint kMaxPreloads = 16;
+
 	/** Retrieve a file from a specified archive */
 	ArchiveReadStream *getFile(const Common::String &fileName, const Common::String &archiveName);
 
@@ -85,6 +111,7 @@ public:
 
 	/** Build the archive filename for a level or a location */
 	Common::String buildArchiveName(Resources::Level *level, Resources::Location *location = nullptr) const;
+	Common::String buildLocationArchiveName(Resources::Level *level, uint16 locationIndex) const;
 
 	/** Retrieve a file relative to a specified archive */
 	Common::SeekableReadStream *getExternalFile(const Common::String &fileName, const Common::String &archiveName) const;
@@ -100,7 +127,13 @@ private:
 		const Formats::XARCArchive &getXArc() const { return _xarc; }
 		Resources::Object *getRoot() const { return _root; }
 
-		void importResources();
+		bool open();
+
+		/** Read the resource tree, can be called from a worker thread */
+		void readResources();
+
+		/** Complete the import of a tree read by readResources */
+		void postReadResources();
 
 		bool isInUse() const { return _useCount > 0; }
 		void incUsage() { _useCount++; }
@@ -111,14 +144,25 @@ private:
 		Common::String _filename;
 		Formats::XARCArchive _xarc;
 		Resources::Object *_root;
+		bool _postRead;
 	};
 
+	class PreloadJob;
+
 	typedef Common::List<LoadedArchive *> LoadedArchiveList;
+	typedef Common::List<PreloadJob *> PreloadJobList;
 
 	bool hasArchive(const Common::String &archiveName) const;
 	LoadedArchive *findArchive(const Common::String &archiveName) const;
 
+	PreloadJob *findPreload(const Common::String &archiveName) const;
+	LoadedArchive *takePreload(const Common::String &archiveName);
+	void releasePreload(PreloadJob *job);
+
 	LoadedArchiveList _archives;
+
+	Common::WorkerPool *_preloadPool;
+	PreloadJobList _preloads; // Oldest first
 };
 
 template <class T>
@@ -24,6 +24,7 @@
 
 #include "engines/stark/resources/bookmark.h"
 #include "engines/stark/resources/camera.h"
+#include "engines/stark/resources/command.h"
 #include "engines/stark/resources/floor.h"
 #include "engines/stark/resources/item.h"
 #include "engines/stark/resources/knowledgeset.h"
@@ -157,6 +158,9 @@ void ResourceProvider::popCurrentLocation() {
 }
 
 void ResourceProvider::requestLocationChange(uint16 level, uint16 location) {
+	// Have the location tree read while the level is being loaded
+	preloadLocation(level, location);
+
 	Current *currentLocation = new Current();
 	_locations.push_back(currentLocation);
 
@@ -255,10 +259,51 @@ void ResourceProvider::performLocationChange() {
 
 	current->getLocation()->resetAnimationBlending();
 	purgeOldLocations();
+	preloadExits();
 
 	_locationChangeRequest = false;
 }
 
+void ResourceProvider::preloadLocation(uint16 level, uint16 location) {
+	Resources::Root *root = _global->getRoot();
+	Resources::Level *rootLevelResource = root->findChildWithIndex<Resources::Level>(level);
+	if (!rootLevelResource) {
+		return;
+	}
+
+	_archiveLoader->preload(_archiveLoader->buildArchiveName(rootLevelResource));
+	_archiveLoader->preload(_archiveLoader->buildLocationArchiveName(rootLevelResource, location));
+}
+
+void ResourceProvider::preloadExits() {
+	if (!_archiveLoader->isPreloadAsync()) {
+		return; // Preloading would only delay the current location
+	}
+
+	Current *current = _global->getCurrent();
+	uint16 currentLevel = current->getLevel()->getIndex();
+	uint16 currentLocation = current->getLocation()->getIndex();
+
+	// The locations reachable from the current one are the targets of its go to commands
+	Common::Array<Resources::Command *> commands = current->getLocation()->listChildrenRecursive<Resources::Command>();
+	for (uint i = 0; i < commands.size(); i++) {
+		uint32 subType = commands[i]->getSubType();
+		if (subType != Resources::Command::kLocationGoTo && subType != Resources::Command::kLocationGoToNewCD) {
+			continue;
+		}
+
+		Common::Array<Resources::Command::Argument> arguments = commands[i]->getArguments();
+		uint level = strtol(arguments[0].stringValue.c_str(), nullptr, 16);
+		uint location = strtol(arguments[1].stringValue.c_str(), nullptr, 16);
+
+		if (level == currentLevel && location == currentLocation) {
+			continue;
+		}
+
+		preloadLocation(level, location);
+	}
+}
+
 void ResourceProvider::runLocationChangeScripts(Resources::Object *resource, uint32 scriptCallMode) {
 	Common::Array<Resources::Script *> scripts = resource->listChildrenRecursive<Resources::Script>();
 
@@ -355,6 +400,8 @@ void ResourceProvider::shutdown() {
 
 	_locationStack.clear();
 
+	_archiveLoader->discardPreloads();
+
 	// Flush the locations list
 	for (CurrentList::const_iterator it = _locations.begin(); it != _locations.end(); it++) {
 		Current *location = *it;
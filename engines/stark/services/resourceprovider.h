@@ -56,6 +56,9 @@ public:
 	/** Load the resources for the specified location */
 	void requestLocationChange(uint16 level, uint16 location);
 
+	/** Start reading the archives for the specified location in the background */
+	void preloadLocation(uint16 level, uint16 location);
+
 	/** Is a location change pending? */
 	bool hasLocationChangeRequest() const { return _locationChangeRequest; }
 
@@ -112,6 +115,7 @@ private:
 	Current *findLocation(uint16 level, uint16 location) const;
 
 	void purgeOldLocations();
+	void preloadExits();
 
 	void runLocationChangeScripts(Resources::Object *resource, uint32 scriptCallMode);
 	void setAprilInitialPosition();
@@ -29,6 +29,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/ad/ad_layer.h"
 #include "engines/wintermute/ad/ad_scene_node.h"
+#include "engines/wintermute/ad/ad_walkability_map.h"
 #include "engines/wintermute/base/base_dynamic_buffer.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/base/base_parser.h"
@@ -57,6 +58,7 @@ AdLayer::~AdLayer() {
 		delete _nodes[i];
 	}
 	_nodes.clear();
+	AdWalkabilityMap::invalidate();
 }
 
 
@@ -222,6 +224,8 @@ bool AdLayer::loadBuffer(char *buffer, bool complete) {
 			break;
 		}
 	}
+	AdWalkabilityMap::invalidate();
+
 	if (cmd == PARSERR_TOKENNOTFOUND) {
 		_gameRef->LOG(0, "Syntax error in LAYER definition");
 		return STATUS_FAILED;
@@ -296,6 +300,7 @@ bool AdLayer::scCallMethod(ScScript *script, ScStack *stack, ScStack *thisStack,
 			stack->pushNative(entity, true);
 		}
 		_nodes.add(node);
+		AdWalkabilityMap::invalidate();
 		return STATUS_OK;
 	}
 
@@ -331,6 +336,7 @@ bool AdLayer::scCallMethod(ScScript *script, ScStack *stack, ScStack *thisStack,
 		} else {
 			_nodes.add(node);
 		}
+		AdWalkabilityMap::invalidate();
 
 		return STATUS_OK;
 	}
@@ -370,6 +376,7 @@ bool AdLayer::scCallMethod(ScScript *script, ScStack *stack, ScStack *thisStack,
 				break;
 			}
 		}
+		AdWalkabilityMap::invalidate();
 		stack->pushBool(true);
 		return STATUS_OK;
 	} else {
@@ -468,6 +475,7 @@ bool AdLayer::scSetProperty(const char *name, ScValue *value) {
 		if (_width < 0) {
 			_width = 0;
 		}
+		AdWalkabilityMap::invalidate();
 		return STATUS_OK;
 	}
 
@@ -479,6 +487,7 @@ bool AdLayer::scSetProperty(const char *name, ScValue *value) {
 		if (_height < 0) {
 			_height = 0;
 		}
+		AdWalkabilityMap::invalidate();
 		return STATUS_OK;
 	}
 
@@ -27,6 +27,7 @@
  */
 
 #include "engines/wintermute/ad/ad_region.h"
+#include "engines/wintermute/ad/ad_walkability_map.h"
 #include "engines/wintermute/base/base_dynamic_buffer.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_file_manager.h"
@@ -231,6 +232,7 @@ bool AdRegion::loadBuffer(char *buffer, bool complete) {
 	}
 
 	createRegion();
+	AdWalkabilityMap::invalidate();
 
 	_alpha = BYTETORGBA(ar, ag, ab, alpha);
 
@@ -255,7 +257,12 @@ bool AdRegion::scCallMethod(ScScript *script, ScStack *stack, ScStack *thisStack
 	        return STATUS_OK;
 	    }
 
-	    else*/ return BaseRegion::scCallMethod(script, stack, thisStack, name);
+	    else*/
+	// The point methods of BaseRegion change the walkable pixels
+	if (strcmp(name, "AddPoint") == 0 || strcmp(name, "InsertPoint") == 0 || strcmp(name, "SetPoint") == 0 || strcmp(name, "RemovePoint") == 0) {
+		AdWalkabilityMap::invalidate();
+	}
+	return BaseRegion::scCallMethod(script, stack, thisStack, name);
 }
 
 
@@ -330,6 +337,7 @@ bool AdRegion::scSetProperty(const char *name, ScValue *value) {
 	//////////////////////////////////////////////////////////////////////////
 	else if (strcmp(name, "Blocked") == 0) {
 		_blocked = value->getBool();
+		AdWalkabilityMap::invalidate();
 		return STATUS_OK;
 	}
 
@@ -338,6 +346,7 @@ bool AdRegion::scSetProperty(const char *name, ScValue *value) {
 	//////////////////////////////////////////////////////////////////////////
 	else if (strcmp(name, "Decoration") == 0) {
 		_decoration = value->getBool();
+		AdWalkabilityMap::invalidate();
 		return STATUS_OK;
 	}
 
@@ -356,6 +365,10 @@ bool AdRegion::scSetProperty(const char *name, ScValue *value) {
 		_alpha = (uint32)value->getInt();
 		return STATUS_OK;
 	} else {
+		// Active is handled by BaseRegion
+		if (strcmp(name, "Active") == 0) {
+			AdWalkabilityMap::invalidate();
+		}
 		return BaseRegion::scSetProperty(name, value);
 	}
 }
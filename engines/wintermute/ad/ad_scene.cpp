@@ -40,6 +40,7 @@
 #include "engines/wintermute/ad/ad_scene_node.h"
 #include "engines/wintermute/ad/ad_scene_state.h"
 #include "engines/wintermute/ad/ad_sentence.h"
+#include "engines/wintermute/ad/ad_walkability_map.h"
 #include "engines/wintermute/ad/ad_waypoint_group.h"
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/base/base_dynamic_buffer.h"
@@ -74,6 +75,7 @@ IMPLEMENT_PERSISTENT(AdScene, false)
 //////////////////////////////////////////////////////////////////////////
 AdScene::AdScene(BaseGame *inGame) : BaseObject(inGame) {
 	_pfTarget = new BasePoint;
+	_pfWalkabilityMap = new AdWalkabilityMap();
 	setDefaults();
 }
 
@@ -84,6 +86,8 @@ AdScene::~AdScene() {
 	_gameRef->unregisterObject(_fader);
 	delete _pfTarget;
 	_pfTarget = nullptr;
+	delete _pfWalkabilityMap;
+	_pfWalkabilityMap = nullptr;
 }
 
 
@@ -101,6 +105,8 @@ void AdScene::setDefaults() {
 #endif
 
 	_pfPointsNum = 0;
+	_pfQueue.clear();
+	_pfQueueReady = false;
 	_persistentState = false;
 	_persistentStateSprites = true;
 
@@ -218,6 +224,7 @@ bool AdScene::getPath(const BasePoint &source, const BasePoint &target, AdPath *
 
 		// prepare working path
 		pfPointsStart();
+		pfPrepareBlocking(requester);
 
 		// first point
 		//_pfPath.add(new AdPathPoint(source.x, source.y, 0));
@@ -226,11 +233,11 @@ bool AdScene::getPath(const BasePoint &source, const BasePoint &target, AdPath *
 		int startX = source.x;
 		int startY = source.y;
 		int bestDistance = 1000;
-		if (isBlockedAt(startX, startY, true, requester)) {
+		if (pfIsBlockedAt(startX, startY)) {
 			int tolerance = 2;
 			for (int xxx = startX - tolerance; xxx <= startX + tolerance; xxx++) {
 				for (int yyy = startY - tolerance; yyy <= startY + tolerance; yyy++) {
-					if (isWalkableAt(xxx, yyy, true, requester)) {
+					if (!pfIsBlockedAt(xxx, yyy)) {
 						int distance = abs(xxx - source.x) + abs(yyy - source.y);
 						if (distance < bestDistance) {
 							startX = xxx;
@@ -254,7 +261,7 @@ bool AdScene::getPath(const BasePoint &source, const BasePoint &target, AdPath *
 		// active waypoints
 		for (uint32 i = 0; i < _waypointGroups.size(); i++) {
 			if (_waypointGroups[i]->_active) {
-				pfAddWaypointGroup(_waypointGroups[i], requester);
+				pfAddWaypointGroup(_waypointGroups[i]);
 			}
 		}
 
@@ -262,29 +269,31 @@ bool AdScene::getPath(const BasePoint &source, const BasePoint &target, AdPath *
 		// free waypoints
 		for (uint32 i = 0; i < _objects.size(); i++) {
 			if (_objects[i]->_active && _objects[i] != requester && _objects[i]->_currentWptGroup) {
-				pfAddWaypointGroup(_objects[i]->_currentWptGroup, requester);
+				pfAddWaypointGroup(_objects[i]->_currentWptGroup);
 			}
 		}
 		AdGame *adGame = (AdGame *)_gameRef;
 		for (uint32 i = 0; i < adGame->_objects.size(); i++) {
 			if (adGame->_objects[i]->_active && adGame->_objects[i] != requester && adGame->_objects[i]->_currentWptGroup) {
-				pfAddWaypointGroup(adGame->_objects[i]->_currentWptGroup, requester);
+				pfAddWaypointGroup(adGame->_objects[i]->_currentWptGroup);
 			}
 		}
 
+		_pfQueueReady = false;
+
 		return true;
 	}
 }
 
 
 //////////////////////////////////////////////////////////////////////////
-void AdScene::pfAddWaypointGroup(AdWaypointGroup *wpt, BaseObject *requester) {
+void AdScene::pfAddWaypointGroup(AdWaypointGroup *wpt) {
 	if (!wpt->_active) {
 		return;
 	}
 
 	for (uint32 i = 0; i < wpt->_points.size(); i++) {
-		if (isBlockedAt(wpt->_points[i]->x, wpt->_points[i]->y, true, requester)) {
+		if (pfIsBlockedAt(wpt->_points[i]->x, wpt->_points[i]->y)) {
 			continue;
 		}
 
@@ -349,8 +358,6 @@ uint32 AdScene::getAlphaAt(int x, int y, bool colorCheck) {
 
 //////////////////////////////////////////////////////////////////////////
 bool AdScene::isBlockedAt(int x, int y, bool checkFreeObjects, BaseObject *requester) {
-	bool ret = true;
-
 	if (checkFreeObjects) {
 		for (uint32 i = 0; i < _objects.size(); i++) {
 			if (_objects[i]->_active && _objects[i] != requester && _objects[i]->_currentBlockRegion) {
@@ -370,34 +377,12 @@ bool AdScene::isBlockedAt(int x, int y, bool checkFreeObjects, BaseObject *reque
 	}
 
 
-	if (_mainLayer) {
-		for (uint32 i = 0; i < _mainLayer->_nodes.size(); i++) {
-			AdSceneNode *node = _mainLayer->_nodes[i];
-			/*
-			if (Node->_type == OBJECT_REGION && Node->_region->_active && Node->_region->_blocked && Node->_region->PointInRegion(X, Y))
-			{
-			    ret = true;
-			    break;
-			}
-			*/
-			if (node->_type == OBJECT_REGION && node->_region->_active && !node->_region->hasDecoration() && node->_region->pointInRegion(x, y)) {
-				if (node->_region->isBlocked()) {
-					ret = true;
-					break;
-				} else {
-					ret = false;
-				}
-			}
-		}
-	}
-	return ret;
+	return AdWalkabilityMap::isBlockedByRegions(_mainLayer, x, y);
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 bool AdScene::isWalkableAt(int x, int y, bool checkFreeObjects, BaseObject *requester) {
-	bool ret = false;
-
 	if (checkFreeObjects) {
 		for (uint32 i = 0; i < _objects.size(); i++) {
 			if (_objects[i]->_active && _objects[i] != requester && _objects[i]->_currentBlockRegion) {
@@ -417,25 +402,12 @@ bool AdScene::isWalkableAt(int x, int y, bool checkFreeObjects, BaseObject *requ
 	}
 
 
-	if (_mainLayer) {
-		for (uint32 i = 0; i < _mainLayer->_nodes.size(); i++) {
-			AdSceneNode *node = _mainLayer->_nodes[i];
-			if (node->_type == OBJECT_REGION && node->_region->_active && !node->_region->hasDecoration() && node->_region->pointInRegion(x, y)) {
-				if (node->_region->isBlocked()) {
-					ret = false;
-					break;
-				} else {
-					ret = true;
-				}
-			}
-		}
-	}
-	return ret;
+	return !AdWalkabilityMap::isBlockedByRegions(_mainLayer, x, y);
 }
 
 
 //////////////////////////////////////////////////////////////////////////
-int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject *requester) {
+int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2) {
 	double xStep, yStep, x, y;
 	int xLength, yLength, xCount, yCount;
 	int x1, y1, x2, y2;
@@ -458,7 +430,7 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 		y = y1;
 
 		for (xCount = x1; xCount < x2; xCount++) {
-			if (isBlockedAt(xCount, (int)y, true, requester)) {
+			if (pfIsBlockedAt(xCount, (int)y)) {
 				return -1;
 			}
 			y += yStep;
@@ -473,7 +445,7 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 		x = x1;
 
 		for (yCount = y1; yCount < y2; yCount++) {
-			if (isBlockedAt((int)x, yCount, true, requester)) {
+			if (pfIsBlockedAt((int)x, yCount)) {
 				return -1;
 			}
 			x += xStep;
@@ -485,16 +457,27 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 
 //////////////////////////////////////////////////////////////////////////
 void AdScene::pathFinderStep() {
-	int i;
-	// get lowest unmarked
-	int lowestDist = INT_MAX_VALUE;
-	AdPathPoint *lowestPt = nullptr;
+	pfPrepareBlocking(_pfRequester);
+
+	if (!_pfQueueReady) {
+		_pfQueue.clear();
+		for (int i = 0; i < _pfPointsNum; i++) {
+			if (!_pfPath[i]->_marked && _pfPath[i]->_distance < INT_MAX_VALUE) {
+				pfQueuePush(_pfPath[i]->_distance, i);
+			}
+		}
+		_pfQueueReady = true;
+	}
 
-	for (i = 0; i < _pfPointsNum; i++)
-		if (!_pfPath[i]->_marked && _pfPath[i]->_distance < lowestDist) {
-			lowestDist = _pfPath[i]->_distance;
-			lowestPt = _pfPath[i];
+	// get lowest unmarked, the queue also has the previous distances of the points
+	AdPathPoint *lowestPt = nullptr;
+	while (!_pfQueue.empty() && !lowestPt) {
+		AdPathPoint *point = _pfPath[_pfQueue[0].point];
+		if (!point->_marked && point->_distance == _pfQueue[0].distance) {
+			lowestPt = point;
 		}
+		pfQueuePop();
+	}
 
 	if (lowestPt == nullptr) { // no path -> terminate PathFinder
 		_pfReady = true;
@@ -517,17 +500,106 @@ void AdScene::pathFinderStep() {
 	}
 
 	// otherwise keep on searching
-	for (i = 0; i < _pfPointsNum; i++)
+	for (int i = 0; i < _pfPointsNum; i++)
 		if (!_pfPath[i]->_marked) {
-			int j = getPointsDist(*lowestPt, *_pfPath[i], _pfRequester);
+			int j = getPointsDist(*lowestPt, *_pfPath[i]);
 			if (j != -1 && lowestPt->_distance + j < _pfPath[i]->_distance) {
 				_pfPath[i]->_distance = lowestPt->_distance + j;
 				_pfPath[i]->_origin = lowestPt;
+				pfQueuePush(_pfPath[i]->_distance, i);
 			}
 		}
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfPrepareBlocking(BaseObject *requester) {
+	_pfWalkabilityMap->update(_mainLayer);
+
+	// free objects move, collect their blocking regions for this step only
+	_pfBlockingRegions.clear();
+	for (uint32 i = 0; i < _objects.size(); i++) {
+		if (_objects[i]->_active && _objects[i] != requester && _objects[i]->_currentBlockRegion) {
+			_pfBlockingRegions.push_back(_objects[i]->_currentBlockRegion);
+		}
+	}
+	AdGame *adGame = (AdGame *)_gameRef;
+	for (uint32 i = 0; i < adGame->_objects.size(); i++) {
+		if (adGame->_objects[i]->_active && adGame->_objects[i] != requester && adGame->_objects[i]->_currentBlockRegion) {
+			_pfBlockingRegions.push_back(adGame->_objects[i]->_currentBlockRegion);
+		}
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdScene::pfIsBlockedAt(int x, int y) {
+	// same as isBlockedAt() with the free objects, using the state from pfPrepareBlocking()
+	for (uint32 i = 0; i < _pfBlockingRegions.size(); i++) {
+		if (_pfBlockingRegions[i]->pointInRegion(x, y)) {
+			return true;
+		}
+	}
+
+	return _pfWalkabilityMap->isBlockedAt(x, y);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// The queue is a binary heap ordered by distance, then by point index,
+// to pick the same point as a scan of the unmarked points would.
+static bool pfQueueLess(int32 distance1, int32 point1, int32 distance2, int32 point2) {
+	return distance1 < distance2 || (distance1 == distance2 && point1 < point2);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfQueuePush(int32 distance, int32 point) {
+	uint32 i = _pfQueue.size();
+	_pfQueue.push_back(PathFinderQueueEntry());
+
+	while (i > 0) {
+		uint32 parent = (i - 1) / 2;
+		if (!pfQueueLess(distance, point, _pfQueue[parent].distance, _pfQueue[parent].point)) {
+			break;
+		}
+		_pfQueue[i] = _pfQueue[parent];
+		i = parent;
+	}
+
+	_pfQueue[i].distance = distance;
+	_pfQueue[i].point = point;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfQueuePop() {
+	PathFinderQueueEntry last = _pfQueue.back();
+	_pfQueue.pop_back();
+	if (_pfQueue.empty()) {
+		return;
+	}
+
+	uint32 i = 0;
+	while (true) {
+		uint32 child = 2 * i + 1;
+		if (child >= _pfQueue.size()) {
+			break;
+		}
+		if (child + 1 < _pfQueue.size() && pfQueueLess(_pfQueue[child + 1].distance, _pfQueue[child + 1].point, _pfQueue[child].distance, _pfQueue[child].point)) {
+			child++;
+		}
+		if (!pfQueueLess(_pfQueue[child].distance, _pfQueue[child].point, last.distance, last.point)) {
+			break;
+		}
+		_pfQueue[i] = _pfQueue[child];
+		i = child;
+	}
+
+	_pfQueue[i] = last;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool AdScene::initLoop() {
 #ifdef _DEBUGxxxx
@@ -2741,6 +2813,10 @@ bool AdScene::persist(BasePersistenceManager *persistMgr) {
 	_pfPath.persist(persistMgr);
 	persistMgr->transferSint32(TMEMBER(_pfPointsNum));
 	persistMgr->transferBool(TMEMBER(_pfReady));
+	if (!persistMgr->getIsSaving()) {
+		_pfWalkabilityMap = new AdWalkabilityMap();
+		_pfQueueReady = false;
+	}
 	persistMgr->transferPtr(TMEMBER_PTR(_pfRequester));
 	persistMgr->transferPtr(TMEMBER_PTR(_pfTarget));
 	persistMgr->transferPtr(TMEMBER_PTR(_pfTargetPath));
@@ -3132,6 +3208,7 @@ bool AdScene::persistState(bool saving) {
 						nodeState->_active = node->_region->_active;
 					} else {
 						node->_region->_active = nodeState->_active;
+						AdWalkabilityMap::invalidate();
 					}
 				}
 				break;
@@ -44,6 +44,8 @@ class AdPath;
 class AdScaleLevel;
 class AdRotLevel;
 class AdPathPoint;
+class AdWalkabilityMap;
+class BaseRegion;
 #ifdef ENABLE_WME3D
 class AdSceneGeometry;
 #endif
@@ -164,7 +166,8 @@ public:
 	BaseArray<AdRotLevel *> _rotLevels;
 
 	bool restoreDeviceObjects() override;
-	int getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject *requester = nullptr);
+	// Only valid during a path search: the blocking state is the one set up by pfPrepareBlocking()
+	int getPointsDist(const BasePoint &p1, const BasePoint &p2);
 
 	// scripting interface
 	ScValue *scGetProperty(const Common::String &name) override;
@@ -175,13 +178,27 @@ public:
 
 private:
 	bool persistState(bool saving = true);
-	void pfAddWaypointGroup(AdWaypointGroup *Wpt, BaseObject *requester = nullptr);
+	void pfAddWaypointGroup(AdWaypointGroup *Wpt);
+	void pfPrepareBlocking(BaseObject *requester);
+	bool pfIsBlockedAt(int x, int y);
+	void pfQueuePush(int32 distance, int32 point);
+	void pfQueuePop();
 	bool _pfReady;
 	BasePoint *_pfTarget;
 	AdPath *_pfTargetPath;
 	BaseObject *_pfRequester;
 	BaseArray<AdPathPoint *> _pfPath;
 
+	// Pathfinder state derived from the scene, not saved
+	struct PathFinderQueueEntry {
+		int32 distance;
+		int32 point;
+	};
+	AdWalkabilityMap *_pfWalkabilityMap;
+	Common::Array<BaseRegion *> _pfBlockingRegions;
+	Common::Array<PathFinderQueueEntry> _pfQueue;
+	bool _pfQueueReady;
+
 	int32 _offsetTop;
 	int32 _offsetLeft;
 
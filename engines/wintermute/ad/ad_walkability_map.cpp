@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/base/base_game.h"
+#include "engines/wintermute/ad/ad_walkability_map.h"
+#include "engines/wintermute/ad/ad_layer.h"
+#include "engines/wintermute/ad/ad_region.h"
+#include "engines/wintermute/ad/ad_scene_node.h"
+
+namespace Wintermute {
+
+uint32 AdWalkabilityMap::_regionGeneration = 0;
+
+//////////////////////////////////////////////////////////////////////////
+AdWalkabilityMap::AdWalkabilityMap() : _layer(nullptr), _width(0), _height(0), _generation(0) {
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdWalkabilityMap::update(AdLayer *mainLayer) {
+	if (mainLayer == _layer && _generation == _regionGeneration) {
+		return;
+	}
+
+	_layer = mainLayer;
+	_generation = _regionGeneration;
+	_width = mainLayer ? MAX<int32>(mainLayer->_width, 0) : 0;
+	_height = mainLayer ? MAX<int32>(mainLayer->_height, 0) : 0;
+
+	_pixels.clear();
+	_pixels.resize((_width * _height + kPixelsPerWord - 1) / kPixelsPerWord);
+	for (uint32 i = 0; i < _pixels.size(); i++) {
+		_pixels[i] = 0;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdWalkabilityMap::invalidate() {
+	_regionGeneration++;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdWalkabilityMap::isBlockedAt(int x, int y) {
+	if (x < 0 || y < 0 || x >= _width || y >= _height) {
+		return isBlockedByRegions(_layer, x, y);
+	}
+
+	uint32 pixel = y * _width + x;
+	uint32 &word = _pixels[pixel / kPixelsPerWord];
+	uint32 shift = (pixel % kPixelsPerWord) * kPixelBits;
+
+	if (!(word & (kPixelKnown << shift))) {
+		word |= kPixelKnown << shift;
+		if (isBlockedByRegions(_layer, x, y)) {
+			word |= kPixelBlocked << shift;
+		}
+	}
+
+	return (word & (kPixelBlocked << shift)) != 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdWalkabilityMap::isBlockedByRegions(AdLayer *layer, int x, int y) {
+	bool ret = true;
+
+	if (layer) {
+		for (uint32 i = 0; i < layer->_nodes.size(); i++) {
+			AdSceneNode *node = layer->_nodes[i];
+			if (node->_type == OBJECT_REGION && node->_region->_active && !node->_region->hasDecoration() && node->_region->pointInRegion(x, y)) {
+				if (node->_region->isBlocked()) {
+					ret = true;
+					break;
+				} else {
+					ret = false;
+				}
+			}
+		}
+	}
+	return ret;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_AD_WALKABILITY_MAP_H
+#define WINTERMUTE_AD_WALKABILITY_MAP_H
+
+#include "common/array.h"
+#include "common/scummsys.h"
+
+namespace Wintermute {
+
+class AdLayer;
+
+/**
+ * Cache of the pixels blocked by the regions of the main scene layer
+ *
+ * The pixels are computed the first time they are queried, and forgotten
+ * when the regions change. The blocking regions of the free objects are
+ * not part of the map, as they move and depend on the object asking.
+ *
+ * The layer and region code calls invalidate() whenever it changes
+ * something the blocked pixels depend on.
+ */
+class AdWalkabilityMap {
+public:
+	AdWalkabilityMap();
+
+	/** Forget the cached pixels if the layer or its regions changed since the last update */
+	void update(AdLayer *mainLayer);
+
+	/**
+	 * Signal a change to the layers or their regions: nodes, size, region
+	 * shape, active, blocked or decoration flags
+	 *
+	 * All the maps forget their cached pixels on their next update.
+	 */
+	static void invalidate();
+
+	/** Check if the main layer regions block a pixel, the same way AdScene::isBlockedAt() does */
+	bool isBlockedAt(int x, int y);
+
+	/** Check if the regions of a layer block a pixel, without using any cache */
+	static bool isBlockedByRegions(AdLayer *layer, int x, int y);
+
+private:
+	enum {
+		kPixelKnown = 1,
+		kPixelBlocked = 2,
+		kPixelBits = 2,
+		kPixelsPerWord = 32 / kPixelBits
+	};
+
+	AdLayer *_layer;
+	int32 _width;
+	int32 _height;
+	Common::Array<uint32> _pixels;
+
+	// Value of _regionGeneration the pixels were cached for
+	uint32 _generation;
+
+	// Incremented by invalidate()
+	static uint32 _regionGeneration;
+};
+
+} // End of namespace Wintermute
+
+#endif
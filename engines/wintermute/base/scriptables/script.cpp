@@ -50,6 +50,8 @@ ScScript::ScScript(BaseGame *inGame, ScEngine *engine) : BaseClass(inGame) {
 	_currentLine = 0;
 
 	_symbols = nullptr;
+	_symbolKeys = nullptr;
+	_varSlots = nullptr;
 	_numSymbols = 0;
 
 	_engine = engine;
@@ -173,9 +175,13 @@ bool ScScript::initTables() {
 
 	_numSymbols = getDWORD();
 	_symbols = new char*[_numSymbols];
+	_symbolKeys = new Common::String[_numSymbols];
+	_varSlots = new VarSlot[_numSymbols];
 	for (uint32 i = 0; i < _numSymbols; i++) {
 		uint32 index = getDWORD();
 		_symbols[index] = getString();
+		_symbolKeys[index] = _symbols[index];
+		_varSlots[index].value = nullptr;
 	}
 
 	// load functions table
@@ -231,6 +237,7 @@ bool ScScript::initTables() {
 		_methods[i].name = getString();
 	}
 
+	buildTableIndices();
 
 	_iP = origIP;
 
@@ -238,6 +245,37 @@ bool ScScript::initTables() {
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+void ScScript::buildTableIndices() {
+	_functionIndex.clear();
+	_methodIndex.clear();
+	_eventIndex.clear();
+	_externalIndex.clear();
+
+	// functions, methods and externals resolve to their first entry...
+	for (uint32 i = 0; i < _numFunctions; i++) {
+		if (!_functionIndex.contains(_functions[i].name)) {
+			_functionIndex[_functions[i].name] = i;
+		}
+	}
+	for (uint32 i = 0; i < _numMethods; i++) {
+		if (!_methodIndex.contains(_methods[i].name)) {
+			_methodIndex[_methods[i].name] = i;
+		}
+	}
+	for (uint32 i = 0; i < _numExternals; i++) {
+		if (!_externalIndex.contains(_externals[i].name)) {
+			_externalIndex[_externals[i].name] = i;
+		}
+	}
+
+	// ...while event handlers are matched case-insensitively and the last one wins
+	for (uint32 i = 0; i < _numEvents; i++) {
+		_eventIndex[_events[i].name] = i;
+	}
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool ScScript::create(const char *filename, byte *buffer, uint32 size, BaseScriptHolder *owner) {
 	cleanup();
@@ -398,6 +436,10 @@ void ScScript::cleanup() {
 		delete[] _symbols;
 	}
 	_symbols = nullptr;
+	delete[] _symbolKeys;
+	_symbolKeys = nullptr;
+	delete[] _varSlots;
+	_varSlots = nullptr;
 	_numSymbols = 0;
 
 	if (_globals && !_thread) {
@@ -447,6 +489,11 @@ void ScScript::cleanup() {
 	_externals = nullptr;
 	_numExternals = 0;
 
+	_functionIndex.clear();
+	_methodIndex.clear();
+	_eventIndex.clear();
+	_externalIndex.clear();
+
 	delete _operand;
 	delete _reg1;
 	_operand = nullptr;
@@ -676,7 +723,7 @@ bool ScScript::executeInstruction() {
 	case II_EXTERNAL_CALL: {
 		uint32 symbolIndex = getDWORD();
 
-		TExternalFunction *f = getExternal(_symbols[symbolIndex]);
+		TExternalFunction *f = getExternal(_symbolKeys[symbolIndex]);
 		if (f) {
 			externalCall(_stack, _thisStack, f);
 		} else {
@@ -705,7 +752,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_VAR: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = resolveVar(getDWORD());
 		if (false && /*var->_type==VAL_OBJECT ||*/ var->_type == VAL_NATIVE) {
 			_operand->setReference(var);
 			_stack->push(_operand);
@@ -716,15 +763,14 @@ bool ScScript::executeInstruction() {
 	}
 
 	case II_PUSH_VAR_REF: {
-		ScValue *var = getVar(_symbols[getDWORD()]);
+		ScValue *var = resolveVar(getDWORD());
 		_operand->setReference(var);
 		_stack->push(_operand);
 		break;
 	}
 
 	case II_POP_VAR: {
-		char *varName = _symbols[getDWORD()];
-		ScValue *var = getVar(varName);
+		ScValue *var = resolveVar(getDWORD());
 		if (var) {
 			ScValue *val = _stack->pop();
 			if (!val) {
@@ -777,7 +823,7 @@ bool ScScript::executeInstruction() {
 		break;
 
 	case II_PUSH_THIS:
-		_operand->setReference(getVar(_symbols[getDWORD()]));
+		_operand->setReference(resolveVar(getDWORD()));
 		_thisStack->push(_operand);
 		break;
 
@@ -1114,62 +1160,119 @@ bool ScScript::executeInstruction() {
 
 //////////////////////////////////////////////////////////////////////////
 uint32 ScScript::getFuncPos(const Common::String &name) {
-	for (uint32 i = 0; i < _numFunctions; i++) {
-		if (name == _functions[i].name) {
-			return _functions[i].pos;
-		}
+	TableIndex::const_iterator it = _functionIndex.find(name);
+	if (_engine) {
+		_engine->_lookupStats.tableLookups++;
+		_engine->_lookupStats.tableCompares += (it != _functionIndex.end()) ? it->_value + 1 : _numFunctions;
 	}
-	return 0;
+	return (it != _functionIndex.end()) ? _functions[it->_value].pos : 0;
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 uint32 ScScript::getMethodPos(const Common::String &name) const {
-	for (uint32 i = 0; i < _numMethods; i++) {
-		if (name == _methods[i].name) {
-			return _methods[i].pos;
-		}
+	TableIndex::const_iterator it = _methodIndex.find(name);
+	if (_engine) {
+		_engine->_lookupStats.tableLookups++;
+		_engine->_lookupStats.tableCompares += (it != _methodIndex.end()) ? it->_value + 1 : _numMethods;
 	}
-	return 0;
+	return (it != _methodIndex.end()) ? _methods[it->_value].pos : 0;
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 ScValue *ScScript::getVar(char *name) {
-	ScValue *ret = nullptr;
+	return resolveVar(name, nullptr);
+}
+
 
-	// scope locals
-	if (_scopeStack->_sP >= 0) {
-		if (_scopeStack->getTop()->propExists(name)) {
-			ret = _scopeStack->getTop()->getProp(name);
+//////////////////////////////////////////////////////////////////////////
+void ScScript::getVarScopes(ScValue **scopes) {
+	scopes[0] = (_scopeStack->_sP >= 0) ? _scopeStack->getTop() : nullptr;
+	scopes[1] = _globals;
+	scopes[2] = _engine ? _engine->_globals : nullptr;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::resolveVar(uint32 symbol) {
+	VarSlot &slot = _varSlots[symbol];
+
+	if (slot.value) {
+		ScValue *scopes[3];
+		getVarScopes(scopes);
+
+		bool valid = true;
+		uint32 probes = 0;
+		for (int32 i = 0; i <= slot.level && valid; i++) {
+			if (scopes[i]) {
+				valid = scopes[i]->hasPlainProps() && scopes[i]->getPropStamp() == slot.stamps[i];
+				probes++;
+			} else {
+				valid = slot.stamps[i] == 0;
+			}
+		}
+
+		if (valid) {
+			if (_engine) {
+				_engine->_lookupStats.varLookups++;
+				_engine->_lookupStats.varSlotHits++;
+				_engine->_lookupStats.varProbesBefore += probes + 1;
+			}
+			return slot.value;
 		}
 	}
 
-	// script globals
-	if (ret == nullptr) {
-		if (_globals->propExists(name)) {
-			ret = _globals->getProp(name);
+	return resolveVar(_symbolKeys[symbol], &slot);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScScript::resolveVar(const Common::String &name, VarSlot *slot) {
+	ScValue *scopes[3];
+	getVarScopes(scopes);
+
+	// scope locals, script globals, engine globals
+	ScValue *ret = nullptr;
+	int32 level;
+	uint32 probes = 0;
+	for (level = 0; level < 3 && ret == nullptr; level++) {
+		if (scopes[level]) {
+			ret = scopes[level]->findProp(name);
+			probes++;
 		}
 	}
+	level--;
 
-	// engine globals
-	if (ret == nullptr) {
-		if (_engine->_globals->propExists(name)) {
-			ret = _engine->_globals->getProp(name);
+	if (_engine) {
+		_engine->_lookupStats.varLookups++;
+		_engine->_lookupStats.varProbes += probes;
+		_engine->_lookupStats.varProbesBefore += (ret != nullptr) ? probes + 1 : probes;
+	}
+
+	// remember where the variable was found, unless a scope searched can answer by itself
+	if (ret != nullptr && slot) {
+		slot->value = ret;
+		slot->level = level;
+		for (int32 i = 0; i <= level; i++) {
+			slot->stamps[i] = scopes[i] ? scopes[i]->getPropStamp() : 0;
+			if (scopes[i] && !scopes[i]->hasPlainProps()) {
+				slot->value = nullptr;
+			}
 		}
 	}
 
 	if (ret == nullptr) {
 		//RuntimeError("Variable '%s' is inaccessible in the current block. Consider changing the script.", name);
-		_gameRef->LOG(0, "Warning: variable '%s' is inaccessible in the current block. Consider changing the script (script:%s, line:%d)", name, _filename, _currentLine);
+		_gameRef->LOG(0, "Warning: variable '%s' is inaccessible in the current block. Consider changing the script (script:%s, line:%d)", name.c_str(), _filename, _currentLine);
 		ScValue *val = new ScValue(_gameRef);
 		ScValue *scope = _scopeStack->getTop();
 		if (scope) {
-			scope->setProp(name, val);
-			ret = _scopeStack->getTop()->getProp(name);
+			scope->setProp(name.c_str(), val);
+			ret = _scopeStack->getTop()->getProp(name.c_str());
 		} else {
-			_globals->setProp(name, val);
-			ret = _globals->getProp(name);
+			_globals->setProp(name.c_str(), val);
+			ret = _globals->getProp(name.c_str());
 		}
 		delete val;
 	}
@@ -1356,12 +1459,12 @@ ScScript *ScScript::invokeEventHandler(const Common::String &eventName, bool unb
 
 //////////////////////////////////////////////////////////////////////////
 uint32 ScScript::getEventPos(const Common::String &name) const {
-	for (int i = _numEvents - 1; i >= 0; i--) {
-		if (scumm_stricmp(name.c_str(), _events[i].name) == 0) {
-			return _events[i].pos;
-		}
+	EventTableIndex::const_iterator it = _eventIndex.find(name);
+	if (_engine) {
+		_engine->_lookupStats.tableLookups++;
+		_engine->_lookupStats.tableCompares += (it != _eventIndex.end()) ? _numEvents - it->_value : _numEvents;
 	}
-	return 0;
+	return (it != _eventIndex.end()) ? _events[it->_value].pos : 0;
 }
 
 
@@ -1407,13 +1510,13 @@ bool ScScript::resume() {
 
 
 //////////////////////////////////////////////////////////////////////////
-ScScript::TExternalFunction *ScScript::getExternal(char *name) {
-	for (uint32 i = 0; i < _numExternals; i++) {
-		if (strcmp(name, _externals[i].name) == 0) {
-			return &_externals[i];
-		}
+ScScript::TExternalFunction *ScScript::getExternal(const Common::String &name) {
+	TableIndex::const_iterator it = _externalIndex.find(name);
+	if (_engine) {
+		_engine->_lookupStats.tableLookups++;
+		_engine->_lookupStats.tableCompares += (it != _externalIndex.end()) ? it->_value + 1 : _numExternals;
 	}
-	return nullptr;
+	return (it != _externalIndex.end()) ? &_externals[it->_value] : nullptr;
 }
 
 
@@ -34,6 +34,8 @@
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/persistent.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
 
 namespace Wintermute {
 class BaseScriptHolder;
@@ -148,7 +150,7 @@ public:
 	bool _methodThread;
 	char *_threadEvent;
 	BaseScriptHolder *_owner;
-	ScScript::TExternalFunction *getExternal(char *name);
+	ScScript::TExternalFunction *getExternal(const Common::String &name);
 	bool externalCall(ScStack *stack, ScStack *thisStack, ScScript::TExternalFunction *function);
 private:
 	char **_symbols;
@@ -162,8 +164,32 @@ private:
 	uint32 _numMethods;
 	uint32 _numEvents;
 
+	// Name -> table index; built by initTables(), matching the lookup rules of the old linear scans
+	typedef Common::HashMap<Common::String, uint32> TableIndex;
+	typedef Common::HashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> EventTableIndex;
+	TableIndex _functionIndex;
+	TableIndex _methodIndex;
+	TableIndex _externalIndex;
+	EventTableIndex _eventIndex;
+	// Symbol names converted to hash keys once per compiled script, indexed like _symbols
+	Common::String *_symbolKeys;
+
+	// Where a variable symbol was last found, indexed like _symbols. The slot
+	// is used as long as no property was added to or removed from the scopes
+	// searched up to the one holding the variable, see ScValue::getPropStamp().
+	struct VarSlot {
+		ScValue *value;
+		int32 level;      // 0 for the scope locals, 1 for the script globals, 2 for the engine globals
+		uint64 stamps[3]; // property stamps of the scopes searched, 0 for a missing scope
+	};
+	VarSlot *_varSlots;
+
 	bool initScript();
 	bool initTables();
+	void buildTableIndices();
+	void getVarScopes(ScValue **scopes);
+	ScValue *resolveVar(uint32 symbol);
+	ScValue *resolveVar(const Common::String &name, VarSlot *slot);
 
 	virtual void preInstHook(uint32 inst);
 	virtual void postInstHook(uint32 inst);
@@ -34,6 +34,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_file_manager.h"
 #include "engines/wintermute/utils/utils.h"
+#include "common/config-manager.h"
 
 namespace Wintermute {
 
@@ -75,9 +76,10 @@ ScEngine::ScEngine(BaseGame *inGame) : BaseClass(inGame) {
 	}
 
 	// prepare script cache
-	for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-		_cachedScripts[i] = nullptr;
-	}
+	_cacheHead = _cacheTail = nullptr;
+	_cacheBytes = 0;
+	_cacheBudget = MAX(ConfMan.getInt("script_cache_size"), 0) * 1024;
+	_cacheHits = _cacheMisses = _cacheEvictions = 0;
 
 	_currentScript = nullptr;
 
@@ -188,14 +190,15 @@ ScScript *ScEngine::runScript(const char *filename, BaseScriptHolder *owner) {
 byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache) {
 	// is script in cache?
 	if (!ignoreCache) {
-		for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-			if (_cachedScripts[i] && scumm_stricmp(_cachedScripts[i]->_filename.c_str(), filename) == 0) {
-				_cachedScripts[i]->_timestamp = g_system->getMillis();
-				*outSize = _cachedScripts[i]->_size;
-				return _cachedScripts[i]->_buffer;
-			}
+		ScriptCache::iterator it = _cachedScripts.find(filename);
+		if (it != _cachedScripts.end()) {
+			_cacheHits++;
+			touchCachedScript(it->_value);
+			*outSize = it->_value->_size;
+			return it->_value->_buffer;
 		}
 	}
+	_cacheMisses++;
 
 	// nope, load it
 	byte *compBuffer;
@@ -229,22 +232,27 @@ byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ig
 	// add script to cache
 	CScCachedScript *cachedScript = new CScCachedScript(filename, compBuffer, compSize);
 	if (cachedScript) {
-		int index = 0;
-		uint32 minTime = g_system->getMillis();
-		for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-			if (_cachedScripts[i] == nullptr) {
-				index = i;
-				break;
-			} else if (_cachedScripts[i]->_timestamp <= minTime) {
-				minTime = _cachedScripts[i]->_timestamp;
-				index = i;
-			}
+		ScriptCache::iterator it = _cachedScripts.find(filename);
+		if (it != _cachedScripts.end()) {
+			// reloaded with ignoreCache, replace the old copy
+			unlinkCachedScript(it->_value);
+			_cacheBytes -= it->_value->_size;
+			delete it->_value;
 		}
-
-		if (_cachedScripts[index] != nullptr) {
-			delete _cachedScripts[index];
+		_cachedScripts[filename] = cachedScript;
+		touchCachedScript(cachedScript);
+		_cacheBytes += compSize;
+
+		// evict the least recently used scripts, but always keep the one just loaded,
+		// since the caller gets a pointer into it
+		while (_cacheBytes > _cacheBudget && _cacheTail != cachedScript) {
+			CScCachedScript *victim = _cacheTail;
+			unlinkCachedScript(victim);
+			_cacheBytes -= victim->_size;
+			_cachedScripts.erase(victim->_filename);
+			delete victim;
+			_cacheEvictions++;
 		}
-		_cachedScripts[index] = cachedScript;
 
 		ret = cachedScript->_buffer;
 		*outSize = cachedScript->_size;
@@ -261,6 +269,9 @@ byte *ScEngine::getCompiledScript(const char *filename, uint32 *outSize, bool ig
 
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::tick() {
+	_lastTickLookupStats = _lookupStats;
+	_lookupStats.reset();
+
 	if (_scripts.size() == 0) {
 		return STATUS_OK;
 	}
@@ -469,16 +480,66 @@ int ScEngine::getNumScripts(int *running, int *waiting, int *persistent) {
 
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::emptyScriptCache() {
-	for (int i = 0; i < MAX_CACHED_SCRIPTS; i++) {
-		if (_cachedScripts[i]) {
-			delete _cachedScripts[i];
-			_cachedScripts[i] = nullptr;
-		}
+	for (ScriptCache::iterator it = _cachedScripts.begin(); it != _cachedScripts.end(); ++it) {
+		delete it->_value;
 	}
+	_cachedScripts.clear();
+	_cacheHead = _cacheTail = nullptr;
+	_cacheBytes = 0;
 	return STATUS_OK;
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+ScEngine::ScriptCacheStats ScEngine::getScriptCacheStats() const {
+	ScriptCacheStats stats;
+	stats.hits = _cacheHits;
+	stats.misses = _cacheMisses;
+	stats.evictions = _cacheEvictions;
+	stats.entries = _cachedScripts.size();
+	stats.bytes = _cacheBytes;
+	stats.budget = _cacheBudget;
+	return stats;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::touchCachedScript(CScCachedScript *script) {
+	if (_cacheHead == script) {
+		return;
+	}
+	if (script->_prev) {
+		unlinkCachedScript(script);
+	}
+
+	script->_prev = nullptr;
+	script->_next = _cacheHead;
+	if (_cacheHead) {
+		_cacheHead->_prev = script;
+	}
+	_cacheHead = script;
+	if (!_cacheTail) {
+		_cacheTail = script;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ScEngine::unlinkCachedScript(CScCachedScript *script) {
+	if (script->_prev) {
+		script->_prev->_next = script->_next;
+	} else {
+		_cacheHead = script->_next;
+	}
+	if (script->_next) {
+		script->_next->_prev = script->_prev;
+	} else {
+		_cacheTail = script->_prev;
+	}
+	script->_prev = script->_next = nullptr;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool ScEngine::resetObject(BaseObject *Object) {
 	// terminate all scripts waiting for this object
@@ -35,7 +35,8 @@
 
 namespace Wintermute {
 
-#define MAX_CACHED_SCRIPTS 20
+// Default byte budget of the compiled script cache, see "script_cache_size"
+#define DEFAULT_SCRIPT_CACHE_KB 2048
 class ScScript;
 class ScValue;
 class BaseObject;
@@ -45,13 +46,13 @@ public:
 	class CScCachedScript {
 	public:
 		CScCachedScript(const char *filename, byte *buffer, uint32 size) {
-			_timestamp = g_system->getMillis();
 			_buffer = new byte[size];
 			if (_buffer) {
 				memcpy(_buffer, buffer, size);
 			}
 			_size = size;
 			_filename = filename;
+			_prev = _next = nullptr;
 		};
 
 		~CScCachedScript() {
@@ -60,10 +61,21 @@ public:
 			}
 		};
 
-		uint32 _timestamp;
 		byte *_buffer;
 		uint32 _size;
 		Common::String _filename;
+		// neighbours in the recency list, most recently used first
+		CScCachedScript *_prev;
+		CScCachedScript *_next;
+	};
+
+	struct ScriptCacheStats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+		uint32 entries;
+		uint32 bytes;
+		uint32 budget;
 	};
 
 public:
@@ -79,6 +91,7 @@ public:
 	bool resetObject(BaseObject *Object);
 	bool resetScript(ScScript *script);
 	bool emptyScriptCache();
+	ScriptCacheStats getScriptCacheStats() const;
 	byte *getCompiledScript(const char *filename, uint32 *outSize, bool ignoreCache = false);
 	DECLARE_PERSISTENT(ScEngine, BaseClass)
 	bool cleanup();
@@ -105,9 +118,42 @@ public:
 	void addScriptTime(const char *filename, uint32 Time);
 	void dumpStats();
 
+	/**
+	 * Name resolution counters, collected over one tick() of the engine.
+	 * The "before" figures are what the unindexed lookups would have cost.
+	 */
+	struct LookupStats {
+		uint32 tableLookups;      // function, method, event and external lookups
+		uint32 tableCompares;     // string compares a linear table scan would have made
+		uint32 varLookups;
+		uint32 varSlotHits;       // variable lookups answered by the slot of their symbol
+		uint32 varProbes;         // property map probes made by the other variable lookups
+		uint32 varProbesBefore;   // probes of the propExists()/getProp() pairs
+
+		LookupStats() { reset(); }
+		void reset() {
+			tableLookups = tableCompares = 0;
+			varLookups = varSlotHits = varProbes = varProbesBefore = 0;
+		}
+	};
+
+	LookupStats _lookupStats;
+	LookupStats _lastTickLookupStats;
+
 private:
 
-	CScCachedScript *_cachedScripts[MAX_CACHED_SCRIPTS];
+	typedef Common::HashMap<Common::String, CScCachedScript *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ScriptCache;
+	ScriptCache _cachedScripts;
+	CScCachedScript *_cacheHead;
+	CScCachedScript *_cacheTail;
+	uint32 _cacheBytes;
+	uint32 _cacheBudget;
+	uint32 _cacheHits;
+	uint32 _cacheMisses;
+	uint32 _cacheEvictions;
+
+	void touchCachedScript(CScCachedScript *script);
+	void unlinkCachedScript(CScCachedScript *script);
 	bool _isProfiling;
 	uint32 _profilingStartTime;
 
@@ -42,6 +42,8 @@ namespace Wintermute {
 
 IMPLEMENT_PERSISTENT(ScValue, false)
 
+uint64 ScValue::_lastPropStamp = 0;
+
 //////////////////////////////////////////////////////////////////////////
 ScValue::ScValue(BaseGame *inGame) : BaseClass(inGame) {
 	_type = VAL_NULL;
@@ -54,6 +56,7 @@ ScValue::ScValue(BaseGame *inGame) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	touchProps();
 }
 
 
@@ -69,6 +72,7 @@ ScValue::ScValue(BaseGame *inGame, bool val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	touchProps();
 }
 
 
@@ -84,6 +88,7 @@ ScValue::ScValue(BaseGame *inGame, int32 val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	touchProps();
 }
 
 
@@ -99,6 +104,7 @@ ScValue::ScValue(BaseGame *inGame, double val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	touchProps();
 }
 
 
@@ -115,6 +121,7 @@ ScValue::ScValue(BaseGame *inGame, const char *val) : BaseClass(inGame) {
 	_valRef = nullptr;
 	_persistent = false;
 	_isConstVar = false;
+	touchProps();
 }
 
 
@@ -191,6 +198,24 @@ ScValue *ScValue::getProp(const char *name) {
 	return ret;
 }
 
+//////////////////////////////////////////////////////////////////////////
+ScValue *ScValue::findProp(const Common::String &name) {
+	if (_type == VAL_VARIABLE_REF) {
+		return _valRef->findProp(name);
+	}
+
+	_valIter = _valObject.find(name);
+	if (_valIter == _valObject.end()) {
+		return nullptr;
+	}
+
+	// natives and strings may answer the name themselves, take the full route
+	if (_type == VAL_NATIVE || _type == VAL_STRING) {
+		return getProp(name.c_str());
+	}
+	return _valIter->_value;
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::deleteProp(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
@@ -201,6 +226,7 @@ bool ScValue::deleteProp(const char *name) {
 	if (_valIter != _valObject.end()) {
 		delete _valIter->_value;
 		_valIter->_value = nullptr;
+		touchProps();
 	}
 
 	return STATUS_OK;
@@ -228,6 +254,7 @@ bool ScValue::setProp(const char *name, ScValue *val, bool copyWhole, bool setAs
 		}
 		if (!newVal) {
 			newVal = new ScValue(_gameRef);
+			touchProps();
 		} else {
 			newVal->cleanup();
 		}
@@ -259,6 +286,12 @@ bool ScValue::setProp(const char *name, ScValue *val, bool copyWhole, bool setAs
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+void ScValue::touchProps() {
+	_propStamp = ++_lastPropStamp;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 bool ScValue::propExists(const char *name) {
 	if (_type == VAL_VARIABLE_REF) {
@@ -278,6 +311,7 @@ void ScValue::deleteProps() {
 		_valIter++;
 	}
 	_valObject.clear();
+	touchProps();
 }
 
 
@@ -750,6 +784,7 @@ void ScValue::copy(ScValue *orig, bool copyWhole) {
 	} else {
 		_valObject.clear();
 	}
+	touchProps();
 }
 
 
@@ -822,6 +857,7 @@ bool ScValue::persist(BasePersistenceManager *persistMgr) {
 			_valObject[str] = val;
 			delete[] str;
 		}
+		touchProps();
 	}
 
 	persistMgr->transferPtr(TMEMBER_PTR(_valRef));
@@ -83,13 +83,29 @@ public:
 	bool isObject();
 	bool setProp(const char *name, ScValue *val, bool copyWhole = false, bool setAsConst = false);
 	ScValue *getProp(const char *name);
+	/**
+	 * Same as propExists() followed by getProp(), but takes a prepared
+	 * key and resolves plain objects with a single map probe.
+	 */
+	ScValue *findProp(const Common::String &name);
+	/**
+	 * Changes whenever a property is added or removed, and is never shared
+	 * by two values. A property found by findProp() can be remembered for
+	 * as long as the stamp of its owner stays the same.
+	 */
+	uint64 getPropStamp() const { return _propStamp; }
+	/** Check if findProp() answers from the property map alone, see getPropStamp() */
+	bool hasPlainProps() const { return _type != VAL_VARIABLE_REF && _type != VAL_NATIVE && _type != VAL_STRING; }
 	BaseScriptable *_valNative;
 	ScValue *_valRef;
 private:
+	void touchProps();
 	bool _valBool;
 	int32 _valInt;
 	double _valFloat;
 	char *_valString;
+	uint64 _propStamp;
+	static uint64 _lastPropStamp;
 public:
 	TValType _type;
 	ScValue(BaseGame *inGame);
@@ -36,6 +36,8 @@ Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
+	registerCmd("show_lookups", WRAP_METHOD(Console, Cmd_ShowLookups));
+	registerCmd("script_cache", WRAP_METHOD(Console, Cmd_ScriptCache));
 	registerCmd("help", WRAP_METHOD(Console, Cmd_Help));
 	// Actual (script) debugger commands
 	registerCmd(STEP_CMD, WRAP_METHOD(Console, Cmd_Step));
@@ -308,6 +310,32 @@ bool Console::Cmd_ShowFps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_ShowLookups(int argc, const char **argv) {
+	if (argc != 1) {
+		debugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	ScEngine::LookupStats stats = CONTROLLER->getLookupStats();
+	debugPrintf("Script name lookups in the last frame:\n");
+	debugPrintf("  functions/methods/events/externals: %u lookups, %u string compares without the index\n", stats.tableLookups, stats.tableCompares);
+	debugPrintf("  variables: %u lookups, %u answered by symbol slots, %u property probes (%u without resolved symbols)\n", stats.varLookups,
+	            stats.varSlotHits, stats.varProbes, stats.varProbesBefore);
+	return true;
+}
+
+bool Console::Cmd_ScriptCache(int argc, const char **argv) {
+	if (argc != 1) {
+		debugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	ScEngine::ScriptCacheStats stats = CONTROLLER->getScriptCacheStats();
+	debugPrintf("Compiled script cache: %u scripts, %u of %u KB\n", stats.entries, stats.bytes / 1024, stats.budget / 1024);
+	debugPrintf("  %u hits, %u misses, %u evictions\n", stats.hits, stats.misses, stats.evictions);
+	return true;
+}
+
 bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	if (argc != 3) {
 		debugPrintf("Usage: %s <file path> <output file name>\n", argv[0]);
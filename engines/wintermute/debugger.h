@@ -70,6 +70,8 @@ public:
 	bool Cmd_Help(int argc, const char **argv);
 	bool Cmd_ShowFps(int argc, const char **argv);
 	bool Cmd_DumpFile(int argc, const char **argv);
+	bool Cmd_ShowLookups(int argc, const char **argv);
+	bool Cmd_ScriptCache(int argc, const char **argv);
 
 #if EXTENDED_DEBUGGER_ENABLED
 	/**
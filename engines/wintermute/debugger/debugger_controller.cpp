@@ -260,6 +260,16 @@ void DebuggerController::showFps(bool show) {
 	_engine->_game->setShowFPS(show);
 }
 
+ScEngine::LookupStats DebuggerController::getLookupStats() const {
+	assert(SCENGINE);
+	return SCENGINE->_lastTickLookupStats;
+}
+
+ScEngine::ScriptCacheStats DebuggerController::getScriptCacheStats() const {
+	assert(SCENGINE);
+	return SCENGINE->getScriptCacheStats();
+}
+
 Common::Array<BreakpointInfo> DebuggerController::getBreakpoints() const {
 	assert(SCENGINE);
 	Common::Array<BreakpointInfo> breakpoints;
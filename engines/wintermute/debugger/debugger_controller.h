@@ -26,6 +26,7 @@
 #include "common/str.h"
 #include "engines/wintermute/coll_templ.h"
 #include "engines/wintermute/wintermute.h"
+#include "engines/wintermute/base/scriptables/script_engine.h"
 #include "engines/wintermute/debugger/listing_providers/source_listing_provider.h"
 #include "script_monitor.h"
 #include "error.h"
@@ -106,6 +107,14 @@ public:
 	Common::String getSourcePath() const;
 	Listing *getListing(Error* &err);
 	void showFps(bool show);
+	/**
+	 * Script name lookup counters of the last completed tick
+	 */
+	ScEngine::LookupStats getLookupStats() const;
+	/**
+	 * Compiled script cache usage and hit counters
+	 */
+	ScEngine::ScriptCacheStats getScriptCacheStats() const;
 	/**
 	 * Inherited from ScriptMonitor
 	 */
@@ -36,6 +36,7 @@ MODULE_OBJS := \
 	ad/ad_talk_def.o \
 	ad/ad_talk_holder.o \
 	ad/ad_talk_node.o \
+	ad/ad_walkability_map.o \
 	ad/ad_walkplane.o \
 	ad/ad_waypoint_group.o \
 	ad/ad_waypoint_group3d.o \
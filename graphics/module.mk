@@ -59,9 +59,11 @@ MODULE_OBJS := \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o \
+	tinygl/ztile.o \
 
 ifdef USE_SCALERS
 MODULE_OBJS += \
@@ -27,6 +27,7 @@
  */
 
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/ztile.h"
 
 // glVertex
 
@@ -690,3 +691,14 @@ void tglEnableDirtyRects(bool enable) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	c->_enableDirtyRectangles = enable;
 }
+
+void tglSetRenderThreads(int threadCount) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
+	delete c->_tileRenderer;
+	c->_tileRenderer = nullptr;
+	// A negative count lets the system decide
+	if (threadCount < 0)
+		threadCount = Common::WorkerPool::getDefaultThreadCount();
+	if (threadCount > 0)
+		c->_tileRenderer = new TinyGL::TileRenderer(threadCount);
+}
@@ -846,6 +846,7 @@ void tglTexCoordPointer(TGLint size, TGLenum type, TGLsizei stride, const TGLvoi
 void tglPolygonOffset(TGLfloat factor, TGLfloat units);
 
 void tglEnableDirtyRects(bool enable);
+void tglSetRenderThreads(int threadCount);
 
 void tglDebug(int mode);
 
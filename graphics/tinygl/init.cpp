@@ -29,6 +29,7 @@
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
+#include "graphics/tinygl/ztile.h"
 
 namespace TinyGL {
 
@@ -234,13 +235,16 @@ void glInit(void *zbuffer1, int textureSize) {
 	c->_drawCallAllocator[0].initialize(kDrawCallMemory);
 	c->_drawCallAllocator[1].initialize(kDrawCallMemory);
 	c->_enableDirtyRectangles = true;
+	memset(&c->_dirtyRectStatistics, 0, sizeof(c->_dirtyRectStatistics));
+	c->_tileRenderer = nullptr;
 
-	Graphics::Internal::tglBlitResetScissorRect();
+	Graphics::Internal::tglBlitResetScissorRect(c);
 }
 
 void glClose() {
 	GLContext *c = gl_get_context();
 
+	delete c->_tileRenderer;
 	tglDisposeDrawCallLists(c);
 	tglDisposeResources(c);
 
@@ -251,6 +255,7 @@ void glClose() {
 	gl_free(c->vertex);
 
 	delete c;
+	gl_ctx = nullptr;
 }
 
 } // end of namespace TinyGL
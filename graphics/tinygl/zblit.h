@@ -32,6 +32,10 @@
 #include "graphics/surface.h"
 #include "common/rect.h"
 
+namespace TinyGL {
+	struct GLContext;
+}
+
 namespace Graphics {
 
 struct BlitTransform {
@@ -171,21 +175,22 @@ namespace Internal {
 	void tglCleanupImages(); // This function checks if any blit image is to be cleaned up and deletes it.
 	
 	// Documentation for those is the same as the one before, only those function are the one that actually execute the correct code path.
-	void tglBlit(BlitImage *blitImage, const BlitTransform &transform);
+	// They draw with the given context, which is not necessarily the current one.
+	void tglBlit(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform);
 
 	// Disables blending explicitly.
-	void tglBlitNoBlend(BlitImage *blitImage, const BlitTransform &transform);
+	void tglBlitNoBlend(TinyGL::GLContext *c, BlitImage *blitImage, const BlitTransform &transform);
 
 	// Disables blending, transforms and tinting.
-	void tglBlitFast(BlitImage *blitImage, int x, int y);
+	void tglBlitFast(TinyGL::GLContext *c, BlitImage *blitImage, int x, int y);
 
-	void tglBlitZBuffer(BlitImage *blitImage, int x, int y);
+	void tglBlitZBuffer(TinyGL::GLContext *c, BlitImage *blitImage, int x, int y);
 
 	/**
 	@brief Sets up a scissor rectangle for blit calls: every blit call is affected by this rectangle.
 	*/
-	void tglBlitSetScissorRect(const Common::Rect &rect);
-	void tglBlitResetScissorRect(void);
+	void tglBlitSetScissorRect(TinyGL::GLContext *c, const Common::Rect &rect);
+	void tglBlitResetScissorRect(TinyGL::GLContext *c);
 } // end of namespace Internal
 
 } // end of namespace Graphics
@@ -30,6 +30,7 @@
 
 #include "common/scummsys.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
@@ -93,6 +94,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 
 	this->_zbuf = (unsigned int *)gl_malloc(size);
 	memset(this->_zbuf, 0, size);
+	this->_zbufAllocated = true;
 
 	if (!frame_buffer) {
 		byte *pixelBuffer = (byte *)gl_malloc(this->ysize * this->linesize);
@@ -112,12 +114,37 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelBuffer &fra
 	_alphaTestEnabled = false;
 	_depthTestEnabled = false;
 	_depthFunc = TGL_LESS;
+
+	_spanKernels = false;
+	enableSpanKernels(g_system && g_system->hasFeature(OSystem::kFeatureCpuSSE2));
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer &other) {
+	shareBuffers(other);
 }
 
 FrameBuffer::~FrameBuffer() {
 	if (frame_buffer_allocated)
 		pbuf.free();
-	gl_free(_zbuf);
+	if (_zbufAllocated)
+		gl_free(_zbuf);
+}
+
+void FrameBuffer::shareBuffers(const FrameBuffer &other) {
+	*this = other;
+	this->frame_buffer_allocated = 0;
+	this->_zbufAllocated = false;
+}
+
+bool FrameBuffer::enableSpanKernels(bool enable) {
+#ifdef TGL_SPAN_KERNELS
+	_spanKernels = enable && cmode.bytesPerPixel == 4 &&
+	               cmode.rLoss == 0 && cmode.gLoss == 0 && cmode.bLoss == 0 &&
+	               (cmode.aLoss == 0 || cmode.aLoss == 8);
+#else
+	_spanKernels = false;
+#endif
+	return _spanKernels;
 }
 
 Buffer *FrameBuffer::genOffscreenBuffer() {
@@ -31,6 +31,7 @@
 
 #include "graphics/pixelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 #include "common/rect.h"
 
 namespace TinyGL {
@@ -101,8 +102,23 @@ struct ZBufferPoint {
 
 struct FrameBuffer {
 	FrameBuffer(int xsize, int ysize, const Graphics::PixelBuffer &frame_buffer);
+	FrameBuffer(const FrameBuffer &other);
 	~FrameBuffer();
 
+	/**
+	 * Copy the rendering state of another frame buffer and draw into its color and
+	 * depth buffers from now on. The buffers stay owned by the other frame buffer.
+	 */
+	void shareBuffers(const FrameBuffer &other);
+
+	/**
+	 * Enable the SIMD span kernels of the triangle rasterizer. They are only
+	 * used if the CPU and the pixel format are supported, and give the same
+	 * result as the scalar code.
+	 * @return whether the span kernels are enabled
+	 */
+	bool enableSpanKernels(bool enable);
+
 	Buffer *genOffscreenBuffer();
 	void delOffscreenBuffer(Buffer *buffer);
 	void clear(int clear_z, int z, int clear_color, int r, int g, int b);
@@ -512,7 +528,11 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kDepthWrite, bool kEnableScissor>
 	void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
+	bool setupSpanState(SpanState &state, bool depthWrite, bool alphaTest, bool blending, const Graphics::PixelBuffer *texture);
+
 	unsigned int *_zbuf;
+	bool _zbufAllocated;
+	bool _spanKernels;
 	bool _depthWrite;
 	Graphics::PixelBuffer pbuf;
 	bool _blendingEnabled;
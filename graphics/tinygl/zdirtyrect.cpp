@@ -29,8 +29,10 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/ztile.h"
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/system.h"
 
 namespace TinyGL {
 
@@ -79,6 +81,115 @@ struct DirtyRectangle {
 };
 
 
+DirtyRegionGrid::DirtyRegionGrid(const Common::Rect &bounds) : _bounds(bounds), _stamp(0), _binLookups(0) {
+	_width = (bounds.width() + kBinSize - 1) / kBinSize;
+	_height = (bounds.height() + kBinSize - 1) / kBinSize;
+	_marked.resize(_width * _height);
+	for (uint i = 0; i < _marked.size(); i++) {
+		_marked[i] = false;
+	}
+}
+
+bool DirtyRegionGrid::getBinRange(const Common::Rect &rect, int &left, int &top, int &right, int &bottom) const {
+	Common::Rect clipped = rect.findIntersectingRect(_bounds);
+	if (clipped.isEmpty())
+		return false;
+
+	left = (clipped.left - _bounds.left) / kBinSize;
+	top = (clipped.top - _bounds.top) / kBinSize;
+	right = (clipped.right - _bounds.left + kBinSize - 1) / kBinSize;
+	bottom = (clipped.bottom - _bounds.top + kBinSize - 1) / kBinSize;
+	return true;
+}
+
+void DirtyRegionGrid::addRectangle(const Common::Rect &rect) {
+	int left, top, right, bottom;
+	if (!getBinRange(rect, left, top, right, bottom))
+		return;
+
+	for (int y = top; y < bottom; y++) {
+		for (int x = left; x < right; x++) {
+			_marked[y * _width + x] = true;
+		}
+	}
+}
+
+void DirtyRegionGrid::merge() {
+	_binRectangle.resize(_width * _height);
+	_binRectangles.clear();
+	_rectangles.clear();
+
+	// Scan rows for runs of marked bins, a run extends the rectangle
+	// of the row above when it covers exactly the same columns.
+	for (int y = 0; y < _height; y++) {
+		int x = 0;
+		while (x < _width) {
+			if (!_marked[y * _width + x]) {
+				_binRectangle[y * _width + x] = -1;
+				x++;
+				continue;
+			}
+
+			int runStart = x;
+			while (x < _width && _marked[y * _width + x]) {
+				x++;
+			}
+
+			int index = y > 0 ? _binRectangle[(y - 1) * _width + runStart] : -1;
+			if (index >= 0 && _binRectangles[index].left == runStart && _binRectangles[index].right == x) {
+				_binRectangles[index].bottom = y + 1;
+			} else {
+				index = _binRectangles.size();
+				_binRectangles.push_back(Common::Rect(runStart, y, x, y + 1));
+			}
+
+			for (int i = runStart; i < x; i++) {
+				_binRectangle[y * _width + i] = index;
+			}
+		}
+	}
+
+	for (uint i = 0; i < _binRectangles.size(); i++) {
+		const Common::Rect &bins = _binRectangles[i];
+		Common::Rect rect(
+			_bounds.left + bins.left * kBinSize,
+			_bounds.top + bins.top * kBinSize,
+			_bounds.left + bins.right * kBinSize,
+			_bounds.top + bins.bottom * kBinSize
+		);
+		rect.clip(_bounds);
+		_rectangles.push_back(rect);
+	}
+
+	_rectangleStamp.resize(_rectangles.size());
+	for (uint i = 0; i < _rectangleStamp.size(); i++) {
+		_rectangleStamp[i] = 0;
+	}
+}
+
+void DirtyRegionGrid::findRectangles(const Common::Rect &rect, Common::Array<uint> &indices) {
+	int left, top, right, bottom;
+	if (_rectangles.empty() || !getBinRange(rect, left, top, right, bottom))
+		return;
+
+	// Merged rectangles cover whole bins, so touching a bin means intersecting its rectangle.
+	_stamp++;
+	for (int y = top; y < bottom; y++) {
+		for (int x = left; x < right; x++) {
+			int index = _binRectangle[y * _width + x];
+			if (index >= 0 && _rectangleStamp[index] != _stamp) {
+				_rectangleStamp[index] = _stamp;
+				indices.push_back(index);
+			}
+		}
+	}
+	_binLookups += (right - left) * (bottom - top);
+}
+
+void tglGetDirtyRectStatistics(DirtyRectStatistics &stats) {
+	stats = gl_get_context()->_dirtyRectStatistics;
+}
+
 void tglDisposeResources(TinyGL::GLContext *c) {
 	// Dispose textures and resources.
 	bool allDisposed = true;
@@ -124,6 +235,7 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
 
 	Common::List<DirtyRectangle> rectangles;
+	uint32 startTime = g_system->getMillis();
 
 	DrawCallIterator itFrame = c->_drawCallsQueue.begin();
 	DrawCallIterator endFrame = c->_drawCallsQueue.end();
@@ -150,65 +262,42 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
 	}
 
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
+	// Merge the dirty rectangles on a grid and find the draw calls touching them.
+	// The outer rectangle coordinates are increased to favor merging of adjacent rectangles.
+	DirtyRegionGrid grid(c->renderRect);
 	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		(*it).rectangle.right++;
-		(*it).rectangle.bottom++;
+		Common::Rect rect = (*it).rectangle;
+		rect.right++;
+		rect.bottom++;
+		grid.addRectangle(rect);
 	}
+	grid.merge();
 
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
-				}
-			}
-		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
-		}
-	}
+	const Common::Array<Common::Rect> &dirtyRegions = grid.getRectangles();
+	uint drawCallExecutions = 0;
+	c->_dirtyRectStatistics.totalTime += g_system->getMillis() - startTime;
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		(*it1).rectangle.clip(c->renderRect);
-	}
-
-	if (!rectangles.empty()) {
+	if (!dirtyRegions.empty()) {
 		// Execute draw calls.
-		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+		if (c->_tileRenderer) {
+			// Merged rectangles don't overlap, so the tiles can replay them in any order.
+			c->_tileRenderer->render(c, c->_drawCallsQueue, dirtyRegions);
+		} else {
+			Common::Array<uint> touchedRegions;
+			for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+				touchedRegions.clear();
+				grid.findRectangles((*it)->getDirtyRegion(), touchedRegions);
+				for (uint i = 0; i < touchedRegions.size(); i++) {
+					(*it)->execute(c, dirtyRegions[touchedRegions[i]], true);
 				}
+				drawCallExecutions += touchedRegions.size();
 			}
 		}
 #if TGL_DIRTY_RECT_SHOW
 		// Draw debug rectangles.
-		// Note: white rectangles are rectangle that contained other rectangles
-		// blue rectangles are rectangle merged from other rectangles
-		// red rectangles are original dirty rects
+		// Note: white rectangles are dirty rects of the previous frame
+		// red rectangles are dirty rects of the current frame
+		// blue rectangles are the merged rectangles which were redrawn
 
 		bool blendingEnabled = c->fb->isBlendingEnabled();
 		bool alphaTestEnabled = c->fb->isAlphaTestEnabled();
@@ -218,12 +307,22 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 		for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
 			tglDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
 		}
+		for (uint i = 0; i < dirtyRegions.size(); i++) {
+			tglDrawRectangle(dirtyRegions[i], 0, 0, 255);
+		}
 
 		c->fb->enableBlending(blendingEnabled);
 		c->fb->enableAlphaTest(alphaTestEnabled);
 #endif
 	}
 
+	DirtyRectStatistics &stats = c->_dirtyRectStatistics;
+	stats.frames++;
+	stats.sourceRectangles = rectangles.size();
+	stats.rectangles = dirtyRegions.size();
+	stats.binLookups = grid.getBinLookups();
+	stats.drawCallExecutions = drawCallExecutions;
+
 	// Dispose not necessary draw calls.
 	for (DrawCallIterator it = c->_previousFrameDrawCallsQueue.begin(); it != c->_previousFrameDrawCallsQueue.end(); ++it) {
 		delete *it;
@@ -242,8 +341,15 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 static void tglPresentBufferSimple(TinyGL::GLContext *c) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
 
+	if (c->_tileRenderer) {
+		Common::Array<Common::Rect> regions;
+		regions.push_back(c->renderRect);
+		c->_tileRenderer->render(c, c->_drawCallsQueue, regions);
+	}
+
 	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
+		if (!c->_tileRenderer)
+			(*it)->execute(c, true);
 		delete *it;
 	}
 
@@ -294,8 +400,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (c->_enableDirtyRectangles || c->_tileRenderer) {
 		computeDirtyRegion();
 	}
 }
@@ -333,19 +439,25 @@ void RasterizationDrawCall::computeDirtyRegion() {
 	}
 }
 
-void RasterizationDrawCall::execute(bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
-
+void RasterizationDrawCall::execute(TinyGL::GLContext *c, bool restoreState) const {
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
+	}
+	applyState(c, _state);
+
+	// Rasterization writes back into the vertices, so work on a copy: the draw call
+	// has to give the same result every time it is executed for another region.
+	if (_vertexCount > c->vertex_max) {
+		TinyGL::gl_free(c->vertex);
+		c->vertex_max = _vertexCount;
+		c->vertex = (TinyGL::GLVertex *)TinyGL::gl_malloc(c->vertex_max * sizeof(TinyGL::GLVertex));
 	}
-	applyState(_state);
+	memcpy(c->vertex, _vertex, sizeof(TinyGL::GLVertex) * _vertexCount);
 
 	TinyGL::GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (TinyGL::gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (TinyGL::gl_draw_triangle_func)_drawTriangleBack;
@@ -429,13 +541,12 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->vertex_cnt = prevVertexCount;
 
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(TinyGL::GLContext *c) const {
 	RasterizationState state;
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	state.alphaTest = c->fb->isAlphaTestEnabled();
 	c->fb->getBlendingFactors(state.sfactor, state.dfactor);
 	state.enableBlending = c->fb->isBlendingEnabled();
@@ -467,8 +578,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void RasterizationDrawCall::applyState(TinyGL::GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -495,10 +605,9 @@ void RasterizationDrawCall::applyState(const RasterizationDrawCall::Rasterizatio
 	memcpy(c->viewport.trans._v, state.viewportTranslation, sizeof(c->viewport.trans._v));
 }
 
-void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void RasterizationDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
 	c->fb->setScissorRectangle(clippingRectangle);
-	execute(restoreState);
+	execute(c, restoreState);
 	c->fb->resetScissorRectangle();
 }
 
@@ -518,10 +627,11 @@ bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const
 }
 
 BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransform &transform, BlittingMode blittingMode) : DrawCall(DrawCall_Blitting), _transform(transform), _mode(blittingMode), _image(image) {
+	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	tglIncBlitImageRef(image);
-	_blitState = captureState();
+	_blitState = captureState(c);
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (TinyGL::gl_get_context()->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_tileRenderer) {
 		computeDirtyRegion();
 	}
 }
@@ -530,43 +640,42 @@ BlittingDrawCall::~BlittingDrawCall() {
 	tglDeleteBlitImage(_image);
 }
 
-void BlittingDrawCall::execute(bool restoreState) const {
+void BlittingDrawCall::execute(TinyGL::GLContext *c, bool restoreState) const {
 	BlittingState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_blitState);
+	applyState(c, _blitState);
 
 	switch (_mode) {
 	case Graphics::BlittingDrawCall::BlitMode_Regular:
-		Graphics::Internal::tglBlit(_image, _transform);
+		Graphics::Internal::tglBlit(c, _image, _transform);
 		break;
 	case Graphics::BlittingDrawCall::BlitMode_NoBlend:
-		Graphics::Internal::tglBlitNoBlend(_image, _transform);
+		Graphics::Internal::tglBlitNoBlend(c, _image, _transform);
 		break;
 	case Graphics::BlittingDrawCall::BlitMode_Fast:
-		Graphics::Internal::tglBlitFast(_image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
+		Graphics::Internal::tglBlitFast(c, _image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
 		break;
 	case Graphics::BlittingDrawCall::BlitMode_ZBuffer:
-		Graphics::Internal::tglBlitZBuffer(_image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
+		Graphics::Internal::tglBlitZBuffer(c, _image, _transform._destinationRectangle.left, _transform._destinationRectangle.top);
 		break;
 	default:
 		break;
 	}
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	Graphics::Internal::tglBlitSetScissorRect(clippingRectangle);
-	execute(restoreState);
-	Graphics::Internal::tglBlitResetScissorRect();
+void BlittingDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
+	Graphics::Internal::tglBlitSetScissorRect(c, clippingRectangle);
+	execute(c, restoreState);
+	Graphics::Internal::tglBlitResetScissorRect(c);
 }
 
-BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
+BlittingDrawCall::BlittingState BlittingDrawCall::captureState(TinyGL::GLContext *c) const {
 	BlittingState state;
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
 	state.alphaTest = c->fb->isAlphaTestEnabled();
 	c->fb->getBlendingFactors(state.sfactor, state.dfactor);
 	state.enableBlending = c->fb->isBlendingEnabled();
@@ -576,8 +685,7 @@ BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
 	return state;
 }
 
-void BlittingDrawCall::applyState(const BlittingState &state) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void BlittingDrawCall::applyState(TinyGL::GLContext *c, const BlittingState &state) const {
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->enableAlphaTest(state.alphaTest);
@@ -604,6 +712,9 @@ void BlittingDrawCall::computeDirtyRegion() {
 	}
 	if (blitWidth == 0 || blitHeight == 0) {
 		_dirtyRegion = Common::Rect();
+	} else if (_transform._rotation != 0) {
+		// Rotated blits can reach outside of the destination rectangle.
+		_dirtyRegion = TinyGL::gl_get_context()->renderRect;
 	} else {
 		_dirtyRegion = Common::Rect(
 			_transform._destinationRectangle.left,
@@ -626,18 +737,14 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue) 
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
-	if (c->_enableDirtyRectangles) {
-		_dirtyRegion = c->renderRect;
-	}
+	_dirtyRegion = c->renderRect;
 }
 
-void ClearBufferDrawCall::execute(bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void ClearBufferDrawCall::execute(TinyGL::GLContext *c, bool restoreState) const {
 	c->fb->clear(_clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue);
 }
 
-void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = TinyGL::gl_get_context();
+void ClearBufferDrawCall::execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(), _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue);
 }
@@ -60,8 +60,9 @@ public:
 	bool operator!=(const DrawCall &other) const {
 		return !(*this == other);
 	}
-	virtual void execute(bool restoreState) const = 0;
-	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
+	// Draw calls are executed with the given context, which can differ from the one that recorded them.
+	virtual void execute(TinyGL::GLContext *c, bool restoreState) const = 0;
+	virtual void execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
 protected:
@@ -75,8 +76,8 @@ public:
 	ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue);
 	virtual ~ClearBufferDrawCall() { }
 	bool operator==(const ClearBufferDrawCall &other) const;
-	virtual void execute(bool restoreState) const;
-	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual void execute(TinyGL::GLContext *c, bool restoreState) const;
+	virtual void execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const;
 
 	void *operator new(size_t size) {
 		return ::Internal::allocateFrame(size);
@@ -94,8 +95,8 @@ public:
 	RasterizationDrawCall();
 	virtual ~RasterizationDrawCall() { }
 	bool operator==(const RasterizationDrawCall &other) const;
-	virtual void execute(bool restoreState) const;
-	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual void execute(TinyGL::GLContext *c, bool restoreState) const;
+	virtual void execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const;
 
 	void *operator new(size_t size) {
 		return ::Internal::allocateFrame(size);
@@ -139,8 +140,8 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	RasterizationState captureState(TinyGL::GLContext *c) const;
+	void applyState(TinyGL::GLContext *c, const RasterizationState &state) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
@@ -156,8 +157,8 @@ public:
 	BlittingDrawCall(BlitImage *image, const BlitTransform &transform, BlittingMode blittingMode);
 	virtual ~BlittingDrawCall();
 	bool operator==(const BlittingDrawCall &other) const;
-	virtual void execute(bool restoreState) const;
-	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual void execute(TinyGL::GLContext *c, bool restoreState) const;
+	virtual void execute(TinyGL::GLContext *c, const Common::Rect &clippingRectangle, bool restoreState) const;
 
 	BlittingMode getBlittingMode() const { return _mode; }
 	
@@ -191,12 +192,78 @@ private:
 		}
 	};
 
-	BlittingState captureState() const;
-	void applyState(const BlittingState &state) const;
+	BlittingState captureState(TinyGL::GLContext *c) const;
+	void applyState(TinyGL::GLContext *c, const BlittingState &state) const;
 
 	BlittingState _blitState;
 };
 
 } // end of namespace Graphics
 
+namespace TinyGL {
+
+/**
+ * Union of rectangles stored as a grid of coarse bins. Merging is linear in the
+ * number of bins covered, and the merged rectangles are disjoint and aligned
+ * on bins, so the ones a draw call touches are found by looking up its bins.
+ */
+class DirtyRegionGrid {
+public:
+	static const int kBinSize = 32;
+
+	explicit DirtyRegionGrid(const Common::Rect &bounds);
+
+	/**
+	 * Mark the bins covered by the rectangle, clipped to the bounds.
+	 */
+	void addRectangle(const Common::Rect &rect);
+
+	/**
+	 * Build the disjoint rectangles covering the marked bins.
+	 */
+	void merge();
+
+	const Common::Array<Common::Rect> &getRectangles() const { return _rectangles; }
+
+	/**
+	 * Append to indices the merged rectangles the given rectangle intersects,
+	 * each one only once.
+	 */
+	void findRectangles(const Common::Rect &rect, Common::Array<uint> &indices);
+
+	/**
+	 * Number of bins looked up by findRectangles() since the grid was created.
+	 */
+	uint getBinLookups() const { return _binLookups; }
+
+private:
+	bool getBinRange(const Common::Rect &rect, int &left, int &top, int &right, int &bottom) const;
+
+	Common::Rect _bounds;
+	int _width, _height;
+	Common::Array<bool> _marked;
+	Common::Array<int> _binRectangle;
+	Common::Array<Common::Rect> _binRectangles; // merged rectangles in bin coordinates
+	Common::Array<Common::Rect> _rectangles;
+	Common::Array<uint> _rectangleStamp;
+	uint _stamp;
+	uint _binLookups;
+};
+
+/**
+ * Counters of the dirty rectangle bookkeeping, as returned by tglGetDirtyRectStatistics().
+ */
+struct DirtyRectStatistics {
+	uint frames;				// frames presented with dirty rectangles
+	uint sourceRectangles;		// rectangles of the changed draw calls, last frame
+	uint rectangles;			// merged rectangles, last frame
+	uint binLookups;			// bins looked up to match draw calls, last frame
+	uint drawCallExecutions;	// clipped draw call executions, last frame
+	uint32 totalTime;			// milliseconds spent in the bookkeeping since the context was created
+};
+
+void tglGetDirtyRectStatistics(DirtyRectStatistics &stats);
+
+} // end of namespace TinyGL
+
 #endif
@@ -248,6 +248,7 @@ private:
 };
 
 struct GLContext;
+class TileRenderer;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
@@ -381,6 +382,8 @@ struct GLContext {
 	Common::Rect _scissorRect;
 
 	bool _enableDirtyRectangles;
+	DirtyRectStatistics _dirtyRectStatistics;
+	TileRenderer *_tileRenderer;
 
 	// blit test
 	Common::List<Graphics::BlitImage *> _blitImages;
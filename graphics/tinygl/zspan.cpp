@@ -0,0 +1,450 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/tinygl/zspan.h"
+
+#ifdef TGL_SPAN_KERNELS
+
+#include <emmintrin.h>
+
+#include "graphics/tinygl/zbuffer.h"
+
+namespace TinyGL {
+
+enum SpanMode {
+	kSpanDepth,
+	kSpanColor,
+	kSpanTexture
+};
+
+enum SpanDepthTest {
+	kDepthLess,
+	kDepthLequal,
+	kDepthGeneric
+};
+
+/**
+ * Comparison function as a mask for each of the possible orderings,
+ * to test all the lanes without branching.
+ */
+struct SpanCompare {
+	__m128i less, equal, greater;
+
+	void setup(bool enabled, int func) {
+		const __m128i ones = _mm_set1_epi32(-1);
+		const __m128i zero = _mm_setzero_si128();
+		if (!enabled)
+			func = TGL_ALWAYS;
+		less = (func == TGL_LESS || func == TGL_LEQUAL || func == TGL_NOTEQUAL || func == TGL_ALWAYS) ? ones : zero;
+		equal = (func == TGL_EQUAL || func == TGL_LEQUAL || func == TGL_GEQUAL || func == TGL_ALWAYS) ? ones : zero;
+		greater = (func == TGL_GREATER || func == TGL_GEQUAL || func == TGL_NOTEQUAL || func == TGL_ALWAYS) ? ones : zero;
+	}
+
+	// Check a <func> b, for signed values
+	FORCEINLINE __m128i test(__m128i a, __m128i b) const {
+		__m128i lt = _mm_cmplt_epi32(a, b);
+		__m128i gt = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_or_si128(_mm_and_si128(lt, less), _mm_and_si128(gt, greater)),
+		                    _mm_andnot_si128(_mm_or_si128(lt, gt), equal));
+	}
+};
+
+/**
+ * SpanState converted to vectors, and kept in locals so the compiler knows
+ * the frame buffer writes don't change it.
+ */
+struct SpanSetup {
+	SpanCompare depth;
+	SpanCompare alpha;
+	__m128i alphaRef;
+	bool depthWrite;
+	bool alphaTest;
+	int sourceFactor, destinationFactor;
+	bool hasAlpha;
+	__m128i aShift, rShift, gShift, bShift;
+	__m128i textureAShift, textureRShift, textureGShift, textureBShift;
+
+	explicit SpanSetup(const SpanState &state) {
+		depth.setup(state.depthTest, state.depthFunc);
+		alpha.setup(state.alphaTest, state.alphaFunc);
+		alphaRef = _mm_set1_epi32(state.alphaRef);
+		depthWrite = state.depthWrite;
+		alphaTest = state.alphaTest;
+		sourceFactor = state.sourceFactor;
+		destinationFactor = state.destinationFactor;
+		hasAlpha = state.hasAlpha;
+		aShift = _mm_cvtsi32_si128(state.aShift);
+		rShift = _mm_cvtsi32_si128(state.rShift);
+		gShift = _mm_cvtsi32_si128(state.gShift);
+		bShift = _mm_cvtsi32_si128(state.bShift);
+		textureAShift = _mm_cvtsi32_si128(state.textureAShift);
+		textureRShift = _mm_cvtsi32_si128(state.textureRShift);
+		textureGShift = _mm_cvtsi32_si128(state.textureGShift);
+		textureBShift = _mm_cvtsi32_si128(state.textureBShift);
+	}
+};
+
+// 32 bit low multiplication, SSE2 only has it for 16 bit values.
+static FORCEINLINE __m128i mulLo32(__m128i a, __m128i b) {
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// (a * b) >> 8 for 32 bit lanes holding values whose product is below 65536.
+static FORCEINLINE __m128i mulComponent(__m128i a, __m128i b) {
+	return _mm_srli_epi32(_mm_mullo_epi16(a, b), 8);
+}
+
+static FORCEINLINE __m128i spanLanes(unsigned int value, int delta) {
+	return _mm_set_epi32(value + 3 * delta, value + 2 * delta, value + delta, value);
+}
+
+static FORCEINLINE __m128i extractComponent(__m128i color, __m128i shift) {
+	return _mm_and_si128(_mm_srl_epi32(color, shift), _mm_set1_epi32(0xFF));
+}
+
+static FORCEINLINE __m128i packColor(const SpanSetup &setup, __m128i a, __m128i r, __m128i g, __m128i b) {
+	__m128i color = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(r, setup.rShift), _mm_sll_epi32(g, setup.gShift)),
+	                             _mm_sll_epi32(b, setup.bShift));
+	if (setup.hasAlpha)
+		color = _mm_or_si128(color, _mm_sll_epi32(a, setup.aShift));
+	return color;
+}
+
+// Factor of one of the blending functions, other is the same component of the other color:
+// the destination for the source factor and the blended source for the destination factor,
+// the same way FrameBuffer::writePixel() computes them.
+static FORCEINLINE __m128i blendFactor(int factor, __m128i other, __m128i aSrc, __m128i aDst) {
+	const __m128i ff = _mm_set1_epi32(0xFF);
+	switch (factor) {
+	case TGL_DST_COLOR:
+		return other;
+	case TGL_ONE_MINUS_DST_COLOR:
+		return _mm_sub_epi32(ff, other);
+	case TGL_SRC_ALPHA:
+		return aSrc;
+	case TGL_ONE_MINUS_SRC_ALPHA:
+		return _mm_sub_epi32(ff, aSrc);
+	case TGL_DST_ALPHA:
+		return aDst;
+	case TGL_ONE_MINUS_DST_ALPHA:
+		return _mm_sub_epi32(ff, aDst);
+	default:
+		return _mm_setzero_si128();
+	}
+}
+
+static FORCEINLINE void blendComponents(int factor, __m128i aSrc, __m128i aDst, __m128i &r, __m128i &g, __m128i &b,
+                                        __m128i rOther, __m128i gOther, __m128i bOther) {
+	switch (factor) {
+	case TGL_ZERO:
+		r = g = b = _mm_setzero_si128();
+		break;
+	case TGL_ONE:
+		break;
+	default:
+		r = mulComponent(r, blendFactor(factor, rOther, aSrc, aDst));
+		g = mulComponent(g, blendFactor(factor, gOther, aSrc, aDst));
+		b = mulComponent(b, blendFactor(factor, bOther, aSrc, aDst));
+		break;
+	}
+}
+
+// Modulate 8 bit texture components by the light, which isn't clamped to 8 bits.
+static FORCEINLINE __m128i modulate(__m128i texel, __m128i light, bool smallLight) {
+	__m128i product = smallLight ? _mm_mullo_epi16(texel, light) : mulLo32(texel, light);
+	return _mm_and_si128(_mm_srli_epi32(product, 8), _mm_set1_epi32(0xFF));
+}
+
+/**
+ * Draw 4 pixels. The vectors hold the interpolated values of each pixel,
+ * and the colors are already reduced to 8 bits for untextured spans.
+ */
+template <int kMode, bool kBlending, int kDepthTest>
+static FORCEINLINE void spanQuad(const SpanSetup &setup, const SpanState &state, uint32 *colorBuffer, unsigned int *depthBuffer,
+                                 __m128i z, __m128i a, __m128i r, __m128i g, __m128i b,
+                                 unsigned int s, unsigned int t, int dsdx, int dtdx) {
+	const __m128i sign = _mm_set1_epi32(0x80000000);
+	__m128i zDst = _mm_loadu_si128((const __m128i *)depthBuffer);
+	// Depth values are unsigned, the comparison is zDst <func> z
+	__m128i zDstSigned = _mm_xor_si128(zDst, sign);
+	__m128i zSigned = _mm_xor_si128(z, sign);
+	__m128i mask;
+	if (kDepthTest == kDepthLess)
+		mask = _mm_cmplt_epi32(zDstSigned, zSigned);
+	else if (kDepthTest == kDepthLequal)
+		mask = _mm_andnot_si128(_mm_cmpgt_epi32(zDstSigned, zSigned), _mm_set1_epi32(-1));
+	else
+		mask = setup.depth.test(zDstSigned, zSigned);
+
+	if (kMode == kSpanDepth) {
+		if (setup.depthWrite) {
+			z = _mm_or_si128(_mm_and_si128(mask, z), _mm_andnot_si128(mask, zDst));
+			_mm_storeu_si128((__m128i *)depthBuffer, z);
+		}
+		return;
+	}
+
+	if (_mm_movemask_epi8(mask) == 0)
+		return;
+
+	// Colors are used as 8 bit values, except the light of textured spans which
+	// is only reduced to 8 bits after modulating.
+	const __m128i ff = _mm_set1_epi32(0xFF);
+	const __m128i colorMask = kMode == kSpanTexture ? _mm_set1_epi32(-1) : ff;
+	a = _mm_and_si128(_mm_srli_epi32(a, ZB_POINT_ALPHA_BITS - 8), colorMask);
+	r = _mm_and_si128(_mm_srli_epi32(r, ZB_POINT_RED_BITS - 8), colorMask);
+	g = _mm_and_si128(_mm_srli_epi32(g, ZB_POINT_GREEN_BITS - 8), colorMask);
+	b = _mm_and_si128(_mm_srli_epi32(b, ZB_POINT_BLUE_BITS - 8), colorMask);
+
+	if (kMode == kSpanTexture) {
+		uint32 texels[4];
+		for (int i = 0; i < 4; i++) {
+			unsigned int sss = (s & state.textureSizeMask) >> ZB_POINT_ST_FRAC_BITS;
+			unsigned int ttt = (t & state.textureSizeMask) >> ZB_POINT_ST_FRAC_BITS;
+			texels[i] = state.texture[ttt * state.textureSize + sss];
+			s += dsdx;
+			t += dtdx;
+		}
+		__m128i texel = _mm_loadu_si128((const __m128i *)texels);
+
+		// Lights above 255 need a 32 bit product
+		bool smallLight = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(_mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b)), 8),
+		                                                     _mm_setzero_si128())) == 0xFFFF;
+		a = modulate(extractComponent(texel, setup.textureAShift), a, smallLight);
+		r = modulate(extractComponent(texel, setup.textureRShift), r, smallLight);
+		g = modulate(extractComponent(texel, setup.textureGShift), g, smallLight);
+		b = modulate(extractComponent(texel, setup.textureBShift), b, smallLight);
+	}
+
+	if (setup.alphaTest) {
+		// Fragments pass if alpha <func> reference
+		mask = _mm_and_si128(mask, setup.alpha.test(a, setup.alphaRef));
+		if (_mm_movemask_epi8(mask) == 0)
+			return;
+	}
+
+	if (setup.depthWrite) {
+		z = _mm_or_si128(_mm_and_si128(mask, z), _mm_andnot_si128(mask, zDst));
+		_mm_storeu_si128((__m128i *)depthBuffer, z);
+	}
+
+	__m128i colorDst = _mm_loadu_si128((const __m128i *)colorBuffer);
+	__m128i color;
+	if (!kBlending) {
+		color = packColor(setup, a, r, g, b);
+	} else {
+		__m128i aDst = setup.hasAlpha ? extractComponent(colorDst, setup.aShift) : ff;
+		__m128i rDst = extractComponent(colorDst, setup.rShift);
+		__m128i gDst = extractComponent(colorDst, setup.gShift);
+		__m128i bDst = extractComponent(colorDst, setup.bShift);
+
+		blendComponents(setup.sourceFactor, a, aDst, r, g, b, rDst, gDst, bDst);
+		blendComponents(setup.destinationFactor, a, aDst, rDst, gDst, bDst, r, g, b);
+
+		// Components are below 512, so the 16 bit minimum is enough
+		r = _mm_min_epi16(_mm_add_epi32(r, rDst), ff);
+		g = _mm_min_epi16(_mm_add_epi32(g, gDst), ff);
+		b = _mm_min_epi16(_mm_add_epi32(b, bDst), ff);
+		color = packColor(setup, ff, r, g, b);
+	}
+
+	color = _mm_or_si128(_mm_and_si128(mask, color), _mm_andnot_si128(mask, colorDst));
+	_mm_storeu_si128((__m128i *)colorBuffer, color);
+}
+
+/**
+ * Interpolated values of 4 consecutive pixels, and their increment to the next 4 pixels.
+ */
+struct SpanLanes {
+	__m128i z, a, r, g, b;
+	__m128i zStep, aStep, rStep, gStep, bStep;
+
+	explicit SpanLanes(const SpanValues &values) {
+		z = spanLanes(values.z, values.dzdx);
+		a = spanLanes(values.a, values.dadx);
+		r = spanLanes(values.r, values.drdx);
+		g = spanLanes(values.g, values.dgdx);
+		b = spanLanes(values.b, values.dbdx);
+		zStep = _mm_set1_epi32(4 * values.dzdx);
+		aStep = _mm_set1_epi32(4 * values.dadx);
+		rStep = _mm_set1_epi32(4 * values.drdx);
+		gStep = _mm_set1_epi32(4 * values.dgdx);
+		bStep = _mm_set1_epi32(4 * values.dbdx);
+	}
+
+	FORCEINLINE void step() {
+		z = _mm_add_epi32(z, zStep);
+		a = _mm_add_epi32(a, aStep);
+		r = _mm_add_epi32(r, rStep);
+		g = _mm_add_epi32(g, gStep);
+		b = _mm_add_epi32(b, bStep);
+	}
+
+	void advance(const SpanValues &values, int pixels) {
+		z = _mm_add_epi32(z, _mm_set1_epi32(pixels * values.dzdx));
+		a = _mm_add_epi32(a, _mm_set1_epi32(pixels * values.dadx));
+		r = _mm_add_epi32(r, _mm_set1_epi32(pixels * values.drdx));
+		g = _mm_add_epi32(g, _mm_set1_epi32(pixels * values.dgdx));
+		b = _mm_add_epi32(b, _mm_set1_epi32(pixels * values.dbdx));
+	}
+};
+
+/**
+ * Draw count pixels, with texture coordinates linearly interpolated from s and t.
+ */
+template <int kMode, bool kBlending, int kDepthTest>
+static FORCEINLINE void spanRun(const SpanSetup &setup, const SpanState &state, const SpanValues &values, SpanLanes &lanes,
+                                uint32 *colorBuffer, unsigned int *depthBuffer, int count,
+                                unsigned int s, unsigned int t, int dsdx, int dtdx) {
+	for (; count >= 4; count -= 4) {
+		spanQuad<kMode, kBlending, kDepthTest>(setup, state, colorBuffer, depthBuffer, lanes.z, lanes.a, lanes.r, lanes.g, lanes.b, s, t, dsdx, dtdx);
+		lanes.step();
+		s += 4 * dsdx;
+		t += 4 * dtdx;
+		colorBuffer += 4;
+		depthBuffer += 4;
+	}
+
+	if (count > 0) {
+		// Work on a copy of the last pixels, so nothing outside of the span is touched
+		uint32 colors[4] = { 0, 0, 0, 0 };
+		unsigned int depths[4] = { 0, 0, 0, 0 };
+		for (int i = 0; i < count; i++) {
+			colors[i] = colorBuffer[i];
+			depths[i] = depthBuffer[i];
+		}
+		spanQuad<kMode, kBlending, kDepthTest>(setup, state, colors, depths, lanes.z, lanes.a, lanes.r, lanes.g, lanes.b, s, t, dsdx, dtdx);
+		for (int i = 0; i < count; i++) {
+			colorBuffer[i] = colors[i];
+			depthBuffer[i] = depths[i];
+		}
+		lanes.advance(values, count);
+	}
+}
+
+template <int kMode, bool kBlending, int kDepthTest>
+static void spanKernel(const SpanState &state, int pixel, int count, const SpanValues &values, const SpanPerspective *perspective) {
+	const SpanSetup setup(state);
+	SpanLanes lanes(values);
+	uint32 *colorBuffer = state.colorBuffer + pixel;
+	unsigned int *depthBuffer = state.depthBuffer + pixel;
+
+	if (kMode != kSpanTexture) {
+		spanRun<kMode, kBlending, kDepthTest>(setup, state, values, lanes, colorBuffer, depthBuffer, count, 0, 0, 0, 0);
+		return;
+	}
+
+	// Same perspective correction steps as FrameBuffer::fillTriangle(), from the start of the span
+	float sz = perspective->sz, tz = perspective->tz, fz = perspective->fz;
+	float zinv = (float)(1.0 / fz);
+	int end = perspective->skip + count;
+	for (int x = 0; x < end; x += perspective->interpolation) {
+		float ss = sz * zinv;
+		float tt = tz * zinv;
+		unsigned int s = (int)ss;
+		unsigned int t = (int)tt;
+		int dsdx = (int)((perspective->dszdx - ss * perspective->fdzdx) * zinv);
+		int dtdx = (int)((perspective->dtzdx - tt * perspective->fdzdx) * zinv);
+
+		int next = x + perspective->interpolation;
+		int first = MAX<int>(x, perspective->skip);
+		int last = MIN<int>(next, end);
+		if (first < last) {
+			spanRun<kMode, kBlending, kDepthTest>(setup, state, values, lanes, colorBuffer, depthBuffer, last - first,
+			                                      s + (first - x) * dsdx, t + (first - x) * dtdx, dsdx, dtdx);
+			colorBuffer += last - first;
+			depthBuffer += last - first;
+		}
+
+		if (next < end) {
+			fz += perspective->fndzdx;
+			zinv = (float)(1.0 / fz);
+		}
+		sz += perspective->ndszdx;
+		tz += perspective->ndtzdx;
+	}
+}
+
+template <int kMode, bool kBlending>
+static void spanKernel(const SpanState &state, int pixel, int count, const SpanValues &values, const SpanPerspective *perspective) {
+	if (state.depthTest && state.depthFunc == TGL_LESS)
+		spanKernel<kMode, kBlending, kDepthLess>(state, pixel, count, values, perspective);
+	else if (state.depthTest && state.depthFunc == TGL_LEQUAL)
+		spanKernel<kMode, kBlending, kDepthLequal>(state, pixel, count, values, perspective);
+	else
+		spanKernel<kMode, kBlending, kDepthGeneric>(state, pixel, count, values, perspective);
+}
+
+bool spanKernelsSupportBlending(int sourceFactor, int destinationFactor) {
+	switch (sourceFactor) {
+	case TGL_ZERO:
+	case TGL_ONE:
+	case TGL_DST_COLOR:
+	case TGL_ONE_MINUS_DST_COLOR:
+	case TGL_SRC_ALPHA:
+	case TGL_ONE_MINUS_SRC_ALPHA:
+	case TGL_DST_ALPHA:
+	case TGL_ONE_MINUS_DST_ALPHA:
+		break;
+	default:
+		return false;
+	}
+
+	switch (destinationFactor) {
+	case TGL_ZERO:
+	case TGL_ONE:
+	case TGL_DST_COLOR:
+	case TGL_ONE_MINUS_DST_COLOR:
+	case TGL_SRC_ALPHA:
+	case TGL_ONE_MINUS_SRC_ALPHA:
+	case TGL_DST_ALPHA:
+	case TGL_ONE_MINUS_DST_ALPHA:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void spanKernelDepth(const SpanState &state, int pixel, int count, const SpanValues &values) {
+	spanKernel<kSpanDepth, false>(state, pixel, count, values, nullptr);
+}
+
+void spanKernelColor(const SpanState &state, int pixel, int count, const SpanValues &values) {
+	if (state.blending)
+		spanKernel<kSpanColor, true>(state, pixel, count, values, nullptr);
+	else
+		spanKernel<kSpanColor, false>(state, pixel, count, values, nullptr);
+}
+
+void spanKernelTexture(const SpanState &state, int pixel, int count, const SpanValues &values, const SpanPerspective &perspective) {
+	if (state.blending)
+		spanKernel<kSpanTexture, true>(state, pixel, count, values, &perspective);
+	else
+		spanKernel<kSpanTexture, false>(state, pixel, count, values, &perspective);
+}
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,111 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+
+#if defined(__SSE2__)
+#define TGL_SPAN_KERNELS
+#endif
+
+namespace TinyGL {
+
+/**
+ * Frame buffer state used by the span kernels, captured once per triangle.
+ */
+struct SpanState {
+	uint32 *colorBuffer;
+	unsigned int *depthBuffer;
+	bool depthTest;
+	int depthFunc;
+	bool depthWrite;
+	bool alphaTest;
+	int alphaFunc;
+	int alphaRef;
+	bool blending;
+	int sourceFactor;
+	int destinationFactor;
+	// Color component shifts of the frame buffer, alpha is only stored if hasAlpha
+	int aShift, rShift, gShift, bShift;
+	bool hasAlpha;
+	// Texture, for textured spans only
+	const uint32 *texture;
+	int textureSize;
+	unsigned int textureSizeMask;
+	int textureAShift, textureRShift, textureGShift, textureBShift;
+};
+
+/**
+ * Interpolated values at the first pixel of a span, and their increment per pixel,
+ * in the fixed point formats of ZBufferPoint.
+ */
+struct SpanValues {
+	unsigned int z;
+	int dzdx;
+	unsigned int r, g, b, a;
+	int drdx, dgdx, dbdx, dadx;
+};
+
+/**
+ * Texture coordinates of a span, divided by z. They are only divided again every
+ * interpolation pixels, counted from the unclipped start of the span, and
+ * linearly interpolated in between.
+ */
+struct SpanPerspective {
+	float sz, tz, fz;
+	float dszdx, dtzdx, fdzdx;
+	float ndszdx, ndtzdx, fndzdx;
+	int interpolation;
+	// Pixels of the span before the first drawn pixel
+	int skip;
+};
+
+#ifdef TGL_SPAN_KERNELS
+
+/**
+ * Check whether the span kernels implement the given blending factors.
+ */
+bool spanKernelsSupportBlending(int sourceFactor, int destinationFactor);
+
+/**
+ * Depth test and write count pixels starting at the given pixel offset.
+ */
+void spanKernelDepth(const SpanState &state, int pixel, int count, const SpanValues &values);
+
+/**
+ * Draw count pixels with an interpolated color. A flat color has zero increments.
+ */
+void spanKernelColor(const SpanState &state, int pixel, int count, const SpanValues &values);
+
+/**
+ * Draw count pixels with a perspective correct texture modulated by an interpolated color.
+ */
+void spanKernelTexture(const SpanState &state, int pixel, int count, const SpanValues &values, const SpanPerspective &perspective);
+
+#endif
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,176 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/tinygl/ztile.h"
+#include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zdirtyrect.h"
+
+namespace TinyGL {
+
+class TileRenderer::Tile : public Common::WorkerJob {
+public:
+	Tile(const Common::Rect &rect);
+	~Tile();
+
+	/**
+	 * Copy the state the draw calls don't capture themselves from the presenting
+	 * context and clip the regions to the tile. Called before queuing the tile.
+	 */
+	void prepare(GLContext *c, const Common::List<Graphics::DrawCall *> &drawCalls, const Common::Array<Common::Rect> &regions);
+
+	virtual void execute();
+
+	bool hasRegions() const { return !_regions.empty(); }
+
+	TileStatistics _stats;
+
+private:
+	GLContext _context;
+	FrameBuffer *_fb;
+	const Common::List<Graphics::DrawCall *> *_drawCalls;
+	Common::Array<Common::Rect> _regions;
+};
+
+TileRenderer::Tile::Tile(const Common::Rect &rect) : _fb(nullptr), _drawCalls(nullptr) {
+	_stats.rect = rect;
+	_stats.drawCalls = 0;
+	_stats.frameTime = 0;
+	_stats.totalTime = 0;
+
+	_context.vertex = nullptr;
+	_context.vertex_max = 0;
+	_context._tileRenderer = nullptr;
+}
+
+TileRenderer::Tile::~Tile() {
+	gl_free(_context.vertex);
+	delete _fb;
+}
+
+void TileRenderer::Tile::prepare(GLContext *c, const Common::List<Graphics::DrawCall *> &drawCalls, const Common::Array<Common::Rect> &regions) {
+	_drawCalls = &drawCalls;
+	_regions.clear();
+	for (uint i = 0; i < regions.size(); i++) {
+		Common::Rect region = regions[i].findIntersectingRect(_stats.rect);
+		if (!region.isEmpty())
+			_regions.push_back(region);
+	}
+
+	if (_fb)
+		_fb->shareBuffers(*c->fb);
+	else
+		_fb = new FrameBuffer(*c->fb);
+	_fb->resetScissorRectangle();
+
+	_context.fb = _fb;
+	_context.renderRect = c->renderRect;
+	_context._scissorRect = c->renderRect;
+	_context._textureSize = c->_textureSize;
+	_context.render_mode = c->render_mode;
+	_context.current_cull_face = c->current_cull_face;
+	_context.vertex_n = c->vertex_n;
+	_context.viewport = c->viewport;
+}
+
+void TileRenderer::Tile::execute() {
+	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
+
+	uint32 startTime = g_system->getMillis();
+	uint drawCalls = 0;
+
+	for (DrawCallIterator it = _drawCalls->begin(); it != _drawCalls->end(); ++it) {
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		for (uint i = 0; i < _regions.size(); i++) {
+			if (_regions[i].intersects(drawCallRegion)) {
+				(*it)->execute(&_context, _regions[i], false);
+				drawCalls++;
+			}
+		}
+	}
+
+	_stats.drawCalls = drawCalls;
+	_stats.frameTime = g_system->getMillis() - startTime;
+	_stats.totalTime += _stats.frameTime;
+}
+
+TileRenderer::TileRenderer(uint threadCount) : _pool(threadCount) {
+}
+
+TileRenderer::~TileRenderer() {
+	_pool.waitAll();
+	deleteTiles();
+}
+
+void TileRenderer::createTiles(const Common::Rect &renderRect) {
+	deleteTiles();
+	_renderRect = renderRect;
+
+	for (int y = renderRect.top; y < renderRect.bottom; y += kTileSize) {
+		for (int x = renderRect.left; x < renderRect.right; x += kTileSize) {
+			Common::Rect rect(x, y, MIN<int>(x + kTileSize, renderRect.right), MIN<int>(y + kTileSize, renderRect.bottom));
+			_tiles.push_back(new Tile(rect));
+		}
+	}
+}
+
+void TileRenderer::deleteTiles() {
+	for (uint i = 0; i < _tiles.size(); i++) {
+		delete _tiles[i];
+	}
+	_tiles.clear();
+}
+
+void TileRenderer::render(GLContext *c, const Common::List<Graphics::DrawCall *> &drawCalls, const Common::Array<Common::Rect> &regions) {
+	if (_tiles.empty() || _renderRect != c->renderRect)
+		createTiles(c->renderRect);
+
+	for (uint i = 0; i < _tiles.size(); i++) {
+		Tile *tile = _tiles[i];
+		tile->prepare(c, drawCalls, regions);
+		if (tile->hasRegions()) {
+			_pool.queue(tile);
+		} else {
+			tile->_stats.drawCalls = 0;
+			tile->_stats.frameTime = 0;
+		}
+	}
+
+	_pool.waitAll();
+}
+
+void TileRenderer::getStatistics(Common::Array<TileStatistics> &stats) const {
+	stats.clear();
+	for (uint i = 0; i < _tiles.size(); i++) {
+		stats.push_back(_tiles[i]->_stats);
+	}
+}
+
+void tglGetTileStatistics(Common::Array<TileStatistics> &stats) {
+	GLContext *c = gl_get_context();
+	if (c && c->_tileRenderer)
+		c->_tileRenderer->getStatistics(stats);
+	else
+		stats.clear();
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,99 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef GRAPHICS_TINYGL_ZTILE_H
+#define GRAPHICS_TINYGL_ZTILE_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+#include "common/workerpool.h"
+
+namespace Graphics {
+	class DrawCall;
+}
+
+namespace TinyGL {
+
+struct GLContext;
+
+/**
+ * Per tile counters of the tile renderer, as returned by tglGetTileStatistics().
+ * Times are in milliseconds, the resolution of OSystem::getMillis().
+ */
+struct TileStatistics {
+	Common::Rect rect;
+	uint drawCalls;		// draw call executions in the last frame
+	uint32 frameTime;	// time spent in the last frame
+	uint32 totalTime;	// time spent since the tiles were created
+};
+
+/**
+ * Replays the draw call queue on a pool of worker threads.
+ *
+ * The render rectangle is split in square tiles of kTileSize pixels. Every tile
+ * replays the draw calls overlapping it, clipped to the tile, with a private copy
+ * of the context. Tiles don't overlap, so they share the color and depth buffers
+ * without locking and produce the same image as the sequential path.
+ */
+class TileRenderer {
+public:
+	static const int kTileSize = 128;
+
+	/**
+	 * @param threadCount	number of worker threads. The presenting thread
+	 *						renders tiles as well.
+	 */
+	explicit TileRenderer(uint threadCount);
+	~TileRenderer();
+
+	uint getThreadCount() const { return _pool.getThreadCount(); }
+
+	/**
+	 * Execute the draw calls clipped to the given regions, which must not overlap,
+	 * and wait for all the tiles to finish.
+	 */
+	void render(GLContext *c, const Common::List<Graphics::DrawCall *> &drawCalls, const Common::Array<Common::Rect> &regions);
+
+	void getStatistics(Common::Array<TileStatistics> &stats) const;
+
+private:
+	class Tile;
+
+	void createTiles(const Common::Rect &renderRect);
+	void deleteTiles();
+
+	Common::WorkerPool _pool;
+	Common::Array<Tile *> _tiles;
+	Common::Rect _renderRect;
+};
+
+/**
+ * Fill stats with the counters of every tile of the current context,
+ * or clear it if tile rendering is disabled.
+ */
+void tglGetTileStatistics(Common::Array<TileStatistics> &stats);
+
+} // end of namespace TinyGL
+
+#endif
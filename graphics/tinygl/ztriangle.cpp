@@ -114,6 +114,54 @@ FORCEINLINE static void putPixelTextureMappingPerspective(FrameBuffer *buffer, i
 	}
 }
 
+#ifdef TGL_SPAN_KERNELS
+FORCEINLINE static void advanceSpanValues(SpanValues &values, int pixels) {
+	values.z += pixels * values.dzdx;
+	values.r += pixels * values.drdx;
+	values.g += pixels * values.dgdx;
+	values.b += pixels * values.dbdx;
+	values.a += pixels * values.dadx;
+}
+
+bool FrameBuffer::setupSpanState(SpanState &state, bool depthWrite, bool alphaTest, bool blending, const Graphics::PixelBuffer *texture) {
+	if (!_spanKernels)
+		return false;
+	if (blending && !spanKernelsSupportBlending(_sourceBlendingFactor, _destinationBlendingFactor))
+		return false;
+
+	state.colorBuffer = (uint32 *)pbuf.getRawBuffer();
+	state.depthBuffer = _zbuf;
+	state.depthTest = _depthTestEnabled;
+	state.depthFunc = _depthFunc;
+	state.depthWrite = depthWrite;
+	state.alphaTest = alphaTest;
+	state.alphaFunc = _alphaTestFunc;
+	state.alphaRef = _alphaTestRefVal;
+	state.blending = blending;
+	state.sourceFactor = _sourceBlendingFactor;
+	state.destinationFactor = _destinationBlendingFactor;
+	state.aShift = cmode.aShift;
+	state.rShift = cmode.rShift;
+	state.gShift = cmode.gShift;
+	state.bShift = cmode.bShift;
+	state.hasAlpha = cmode.aLoss == 0;
+
+	if (texture) {
+		const Graphics::PixelFormat &textureFormat = texture->getFormat();
+		state.texture = (const uint32 *)texture->getRawBuffer();
+		state.textureSize = _textureSize;
+		state.textureSizeMask = _textureSizeMask;
+		state.textureAShift = textureFormat.aShift;
+		state.textureRShift = textureFormat.rShift;
+		state.textureGShift = textureFormat.gShift;
+		state.textureBShift = textureFormat.bShift;
+	} else {
+		state.texture = nullptr;
+	}
+	return true;
+}
+#endif
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, int kDrawLogic, bool kDepthWrite, bool kAlphaTestEnabled, bool kEnableScissor, bool kBlendingEnabled>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
 	Graphics::PixelBuffer texture;
@@ -278,6 +326,12 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+#ifdef TGL_SPAN_KERNELS
+	SpanState spanState;
+	const bool useSpanKernels = (kDrawLogic == DRAW_DEPTH_ONLY || kDrawLogic == DRAW_FLAT || kDrawLogic == DRAW_SMOOTH) &&
+		setupSpanState(spanState, kDepthWrite, kAlphaTestEnabled, kBlendingEnabled, (kInterpST || kInterpSTZ) ? &texture : nullptr);
+#endif
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -371,6 +425,56 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
+#ifdef TGL_SPAN_KERNELS
+			if (useSpanKernels) {
+				int n = (x2 >> 16) - x1;
+
+				// Pixels of the span inside of the scissor rectangle
+				int spanStart = x1;
+				int spanEnd = x1 + n + 1;
+				if (kEnableScissor) {
+					if (y < _clipRectangle.top || y >= _clipRectangle.bottom)
+						spanEnd = spanStart;
+					spanStart = MAX<int>(spanStart, _clipRectangle.left);
+					spanEnd = MIN<int>(spanEnd, _clipRectangle.right);
+				}
+
+				SpanValues values;
+				values.z = z1;
+				values.dzdx = dzdx;
+				values.r = r1;
+				values.g = g1;
+				values.b = b1;
+				values.a = a1;
+				values.drdx = kDrawLogic == DRAW_SMOOTH ? drdx : 0;
+				values.dgdx = kDrawLogic == DRAW_SMOOTH ? dgdx : 0;
+				values.dbdx = kDrawLogic == DRAW_SMOOTH ? dbdx : 0;
+				values.dadx = kDrawLogic == DRAW_SMOOTH ? dadx : 0;
+
+				if (spanStart < spanEnd) {
+					advanceSpanValues(values, spanStart - x1);
+					if (kInterpST || kInterpSTZ) {
+						SpanPerspective perspective;
+						perspective.sz = sz1;
+						perspective.tz = tz1;
+						perspective.fz = (float)z1;
+						perspective.dszdx = dszdx;
+						perspective.dtzdx = dtzdx;
+						perspective.fdzdx = fdzdx;
+						perspective.ndszdx = ndszdx;
+						perspective.ndtzdx = ndtzdx;
+						perspective.fndzdx = fndzdx;
+						perspective.interpolation = NB_INTERP;
+						perspective.skip = spanStart - x1;
+						spanKernelTexture(spanState, pp1 + spanStart, spanEnd - spanStart, values, perspective);
+					} else if (kDrawLogic == DRAW_DEPTH_ONLY) {
+						spanKernelDepth(spanState, pp1 + spanStart, spanEnd - spanStart, values);
+					} else {
+						spanKernelColor(spanState, pp1 + spanStart, spanEnd - spanStart, values);
+					}
+				}
+			} else
+#endif
 			{
 				if (kDrawLogic == DRAW_DEPTH_ONLY ||
 						(kDrawLogic == DRAW_FLAT && !(kInterpST || kInterpSTZ))) {
@@ -402,7 +506,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						if (kDrawLogic == DRAW_FLAT) {
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 0, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 1, x, y, z, r, g, b, a, dzdx);
-							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, g, a, dzdx);
+							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 2, x, y, z, r, g, b, a, dzdx);
 							putPixelFlat<kDepthWrite, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled>(this, pp, pz, 3, x, y, z, r, g, b, a, dzdx);
 						}
 						if (kInterpZ) {
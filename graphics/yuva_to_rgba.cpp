@@ -83,6 +83,7 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/workerpool.h"
 #include "graphics/surface.h"
 #include "graphics/yuva_to_rgba.h"
 
@@ -246,7 +247,62 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lo
 	}
 }
 
-void YUVAToRGBAManager::convert420(Graphics::Surface *dst, YUVAToRGBAManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+template<typename PixelInt>
+class YUVA420ConvertJob : public Common::WorkerJob {
+public:
+	YUVA420ConvertJob() : _dstPtr(0), _dstPitch(0), _lookup(0), _colorTab(0), _ySrc(0), _uSrc(0), _vSrc(0), _aSrc(0),
+			_yWidth(0), _yHeight(0), _yPitch(0), _uvPitch(0) {}
+
+	void execute() override {
+		convertYUVA420ToRGBA<PixelInt>(_dstPtr, _dstPitch, _lookup, _colorTab, _ySrc, _uSrc, _vSrc, _aSrc, _yWidth, _yHeight, _yPitch, _uvPitch);
+	}
+
+	byte *_dstPtr;
+	int _dstPitch;
+	const YUVAToRGBALookup *_lookup;
+	int16 *_colorTab;
+	const byte *_ySrc, *_uSrc, *_vSrc, *_aSrc;
+	int _yWidth, _yHeight, _yPitch, _uvPitch;
+};
+
+template<typename PixelInt>
+void convertYUVA420ToRGBABands(Common::WorkerPool *pool, byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	// Every band is an even number of rows so that each one starts on a chroma row
+	int bandCount = pool->getThreadCount() + 1;
+	int bandHeight = (((yHeight + bandCount - 1) / bandCount) + 1) & ~1;
+
+	YUVA420ConvertJob<PixelInt> *jobs = new YUVA420ConvertJob<PixelInt>[bandCount];
+
+	int jobCount = 0;
+	for (int y = 0; y < yHeight; y += bandHeight) {
+		YUVA420ConvertJob<PixelInt> &job = jobs[jobCount++];
+		job._dstPtr = dstPtr + y * dstPitch;
+		job._dstPitch = dstPitch;
+		job._lookup = lookup;
+		job._colorTab = colorTab;
+		job._ySrc = ySrc + y * yPitch;
+		job._uSrc = uSrc + (y >> 1) * uvPitch;
+		job._vSrc = vSrc + (y >> 1) * uvPitch;
+		job._aSrc = aSrc + y * yPitch;
+		job._yWidth = yWidth;
+		job._yHeight = MIN(bandHeight, yHeight - y);
+		job._yPitch = yPitch;
+		job._uvPitch = uvPitch;
+	}
+
+	// The calling thread takes the last band
+	for (int i = 0; i < jobCount - 1; i++)
+		pool->queue(&jobs[i]);
+
+	jobs[jobCount - 1].execute();
+
+	for (int i = 0; i < jobCount - 1; i++)
+		pool->wait(&jobs[i]);
+
+	delete[] jobs;
+}
+
+void YUVAToRGBAManager::convert420(Graphics::Surface *dst, YUVAToRGBAManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, Common::WorkerPool *pool) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
@@ -254,8 +310,17 @@ void YUVAToRGBAManager::convert420(Graphics::Surface *dst, YUVAToRGBAManager::Lu
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	// The lookup is resolved on the calling thread, the bands only read it
 	const YUVAToRGBALookup *lookup = getLookup(dst->format, scale);
 
+	if (pool && pool->getThreadCount() > 0 && yHeight >= 4) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUVA420ToRGBABands<uint16>(pool, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUVA420ToRGBABands<uint32>(pool, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -35,6 +35,10 @@
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 namespace Graphics {
 
 class YUVAToRGBALookup;
@@ -60,8 +64,10 @@ public:
 	 * @param yHeight the height of the y surface (must be divisible by 2)
 	 * @param yPitch  the pitch of the y surface
 	 * @param uvPitch the pitch of the u and v surfaces
+	 * @param pool    if set, the rows are split in bands converted on the pool
+	 *                threads and the calling thread, which waits for all of them
 	 */
-	void convert420(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	void convert420(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, Common::WorkerPool *pool = nullptr);
 
 private:
 	friend class Common::Singleton<SingletonBaseType>;
@@ -36,6 +36,25 @@
 
 #include "engines/engine.h"
 
+// ResidualVM specific start
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+#include "common/dct.h"
+#include "common/endian.h"
+#include "common/math.h"
+#include "common/mdct.h"
+#include "common/random.h"
+#include "common/rdft.h"
+#include "graphics/tinygl/zbuffer.h"
+#ifdef USE_BINK
+#include "common/archive.h"
+#include "common/substream.h"
+#include "video/bink_decoder.h"
+#endif
+// ResidualVM specific end
+
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	#include "gui/console.h"
@@ -77,6 +96,16 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	// ResidualVM specific start
+	registerCmd("mixer_stats",		WRAP_METHOD(Debugger, cmdMixerStats));
+	registerCmd("fft_bench",		WRAP_METHOD(Debugger, cmdFFTBench));
+	registerCmd("resampler_bench",	WRAP_METHOD(Debugger, cmdResamplerBench));
+	registerCmd("tinygl_bench",		WRAP_METHOD(Debugger, cmdTinyGLBench));
+#ifdef USE_BINK
+	registerCmd("bink_bench",		WRAP_METHOD(Debugger, cmdBinkBench));
+#endif
+	// ResidualVM specific end
 }
 
 Debugger::~Debugger() {
@@ -776,6 +805,326 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+// ResidualVM specific start
+bool Debugger::cmdMixerStats(int argc, const char **argv) {
+	Audio::Mixer *mixer = g_system->getMixer();
+	if (argc > 1 && !strcmp(argv[1], "reset")) {
+		mixer->resetMixStatistics();
+		return true;
+	}
+
+	Audio::Mixer::MixStatistics stats = mixer->getMixStatistics();
+	if (!stats.callbacks) {
+		debugPrintf("The mixer hasn't run yet\n");
+		return true;
+	}
+	uint32 audioTime = (uint32)((uint64)stats.samples * 1000 / mixer->getOutputRate());
+	uint32 bufferTime = stats.maxBufferSize * 1000 / mixer->getOutputRate();
+	uint32 mixTime = (uint32)(stats.mixTime / 1000);
+	debugPrintf("%u callbacks, %u ms of audio mixed in %u ms (%.1f%% load)\n", stats.callbacks, audioTime, mixTime,
+	            audioTime ? 100.0f * stats.mixTime / (1000.0f * audioTime) : 0.0f);
+	debugPrintf("Longest callback %.2f ms, for buffers of up to %u ms\n", stats.maxMixTime / 1000.0f, bufferTime);
+	return true;
+}
+
+/**
+ * Run a transform of 2^bits values the given number of times: 0 is the
+ * RDFT and 1 the DCT used by Bink audio, 2 the inverse MDCT used by WMA.
+ * @return the time it took, in ms
+ */
+static uint32 runTransform(int transform, int bits, bool simd, int iterations, bool &simdUsed) {
+	const int size = 1 << bits;
+	float *input = new float[size + 1];
+	float *data = new float[size + 1];
+	for (int i = 0; i <= size; i++)
+		input[i] = (float)((i * 7919) % 201 - 100) / 100.0f;
+
+	Common::RDFT *rdft = nullptr;
+	Common::DCT *dct = nullptr;
+	Common::MDCT *mdct = nullptr;
+	if (transform == 0) {
+		rdft = new Common::RDFT(bits, Common::RDFT::DFT_C2R);
+		simdUsed = rdft->enableSIMDKernels(simd);
+	} else if (transform == 1) {
+		dct = new Common::DCT(bits, Common::DCT::DCT_III);
+		simdUsed = dct->enableSIMDKernels(simd);
+	} else {
+		mdct = new Common::MDCT(bits, true, 1.0);
+		simdUsed = mdct->enableSIMDKernels(simd);
+	}
+
+	uint32 startTime = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		if (mdct) {
+			mdct->calcIMDCT(data, input);
+		} else {
+			memcpy(data, input, (size + 1) * sizeof(float));
+			if (rdft)
+				rdft->calc(data);
+			else
+				dct->calc(data);
+		}
+	}
+	uint32 time = g_system->getMillis() - startTime;
+
+	delete rdft;
+	delete dct;
+	delete mdct;
+	delete[] input;
+	delete[] data;
+	return time;
+}
+
+bool Debugger::cmdFFTBench(int argc, const char **argv) {
+	static const char *const transformNames[] = { "RDFT", "DCT", "IMDCT" };
+	int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+
+	for (int transform = 0; transform < ARRAYSIZE(transformNames); transform++) {
+		for (int bits = 8; bits <= 11; bits++) {
+			bool simdUsed = false;
+			uint32 scalarTime = runTransform(transform, bits, false, iterations, simdUsed);
+			uint32 simdTime = runTransform(transform, bits, true, iterations, simdUsed);
+			if (simdUsed)
+				debugPrintf("%s %d: scalar %u ms, SIMD %u ms\n", transformNames[transform], 1 << bits, scalarTime, simdTime);
+			else
+				debugPrintf("%s %d: scalar %u ms, SIMD kernels are not available\n", transformNames[transform], 1 << bits, scalarTime);
+		}
+	}
+	return true;
+}
+
+/**
+ * Resample the given number of seconds of a stereo tone with one of the
+ * rate converters: 0 is the linear one, 1 and 2 the polyphase one without
+ * and with the SIMD kernels.
+ * @return the time it took, in ms
+ */
+static uint32 runResampler(int converterType, int inRate, int outRate, int seconds) {
+	const int inLength = inRate * seconds;
+	int16 *samples = (int16 *)malloc(2 * inLength * sizeof(int16));
+	for (int i = 0; i < inLength; i++) {
+		int16 value = (int16)(sin(2.0 * M_PI * 440.0 * i / inRate) * 16384.0);
+		WRITE_LE_UINT16(&samples[2 * i], value);
+		WRITE_LE_UINT16(&samples[2 * i + 1], value);
+	}
+	Audio::AudioStream *stream = Audio::makeRawStream((const byte *)samples, 2 * inLength * sizeof(int16), inRate,
+	                                                  Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | Audio::FLAG_STEREO);
+
+	Audio::RateConverter *converter;
+	if (converterType == 0)
+		converter = Audio::makeRateConverter(inRate, outRate, true);
+	else
+		converter = Audio::makePolyphaseRateConverter(inRate, outRate, true, false, converterType == 2);
+
+	const int bufferLength = 1024;
+	int16 buffer[2 * bufferLength];
+	uint32 startTime = g_system->getMillis();
+	int res;
+	do {
+		memset(buffer, 0, sizeof(buffer));
+		res = converter->flow(*stream, buffer, bufferLength, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+	} while (res > 0);
+	uint32 time = g_system->getMillis() - startTime;
+
+	delete converter;
+	delete stream;
+	return time;
+}
+
+bool Debugger::cmdResamplerBench(int argc, const char **argv) {
+	static const char *const converterNames[] = { "linear", "polyphase", "polyphase SIMD" };
+	static const int rates[][2] = { { 22050, 48000 }, { 11025, 44100 } };
+	int seconds = argc > 1 ? atoi(argv[1]) : 60;
+	bool simd = g_system->hasFeature(OSystem::kFeatureCpuSSE2);
+
+	for (int i = 0; i < ARRAYSIZE(rates); i++) {
+		for (int converterType = 0; converterType < ARRAYSIZE(converterNames); converterType++) {
+			if (converterType == 2 && !simd)
+				continue;
+			uint32 time = runResampler(converterType, rates[i][0], rates[i][1], seconds);
+			debugPrintf("%d -> %d Hz, %s: %d s of stereo audio in %u ms (%.0fx realtime)\n", rates[i][0], rates[i][1],
+			            converterNames[converterType], seconds, time, time ? seconds * 1000.0f / time : 0.0f);
+		}
+	}
+	return true;
+}
+
+/**
+ * Draw random triangles with one of the TinyGL fill functions: 0 is depth
+ * only, 1 flat, 2 smooth, 3 and 4 textured flat and smooth.
+ * @return the time it took, in ms
+ */
+static uint32 renderTriangleSoup(TinyGL::FrameBuffer &fb, int mode, int iterations) {
+	const int triangleCount = 500;
+	const int textureSize = 256;
+	Common::RandomSource rnd("tinygl_bench");
+	rnd.setSeed(1234);
+
+	uint32 startTime = g_system->getMillis();
+	for (int i = 0; i < iterations; i++) {
+		for (int j = 0; j < triangleCount; j++) {
+			TinyGL::ZBufferPoint p[3];
+			for (int k = 0; k < 3; k++) {
+				p[k].x = rnd.getRandomNumber(fb.xsize - 1);
+				p[k].y = rnd.getRandomNumber(fb.ysize - 1);
+				p[k].z = rnd.getRandomNumber((1 << 30) - 1);
+				p[k].s = rnd.getRandomNumber((textureSize << ZB_POINT_ST_FRAC_BITS) - 1);
+				p[k].t = rnd.getRandomNumber((textureSize << ZB_POINT_ST_FRAC_BITS) - 1);
+				p[k].r = rnd.getRandomNumber(ZB_POINT_RED_MAX);
+				p[k].g = rnd.getRandomNumber(ZB_POINT_GREEN_MAX);
+				p[k].b = rnd.getRandomNumber(ZB_POINT_BLUE_MAX);
+				p[k].a = rnd.getRandomNumber(ZB_POINT_ALPHA_MAX);
+			}
+			switch (mode) {
+			case 0:
+				fb.fillTriangleDepthOnly(&p[0], &p[1], &p[2]);
+				break;
+			case 1:
+				fb.fillTriangleFlat(&p[0], &p[1], &p[2]);
+				break;
+			case 2:
+				fb.fillTriangleSmooth(&p[0], &p[1], &p[2]);
+				break;
+			case 3:
+				fb.fillTriangleTextureMappingPerspectiveFlat(&p[0], &p[1], &p[2]);
+				break;
+			default:
+				fb.fillTriangleTextureMappingPerspectiveSmooth(&p[0], &p[1], &p[2]);
+				break;
+			}
+		}
+	}
+	return g_system->getMillis() - startTime;
+}
+
+bool Debugger::cmdTinyGLBench(int argc, const char **argv) {
+	static const char *const modeNames[] = { "depth only", "flat", "smooth", "textured flat", "textured smooth" };
+	const int textureSize = 256;
+	int iterations = argc > 1 ? atoi(argv[1]) : 5;
+	bool listStates = argc > 2 && !strcmp(argv[2], "all");
+
+	const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+	TinyGL::FrameBuffer fb(640, 480, Graphics::PixelBuffer(format, (byte *)nullptr));
+	Graphics::PixelBuffer texture(format, textureSize * textureSize, DisposeAfterUse::YES);
+	for (int i = 0; i < textureSize * textureSize; i++) {
+		texture.setPixelAt(i, 0xFF, i & 0xFF, (i >> 8) & 0xFF, i * 7 & 0xFF);
+	}
+	fb.setTexture(texture);
+	fb._textureSize = textureSize;
+	fb._textureSizeMask = (textureSize - 1) << ZB_POINT_ST_FRAC_BITS;
+	fb.enableDepthTest(true);
+	fb.setDepthFunc(TGL_LESS);
+	fb.setAlphaTestFunc(TGL_GREATER, 64);
+	fb.setBlendingFactors(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+	bool hasSpanKernels = fb.enableSpanKernels(true);
+	if (!hasSpanKernels)
+		debugPrintf("SIMD span kernels are not available, only timing the scalar code\n");
+
+	for (int mode = 0; mode < ARRAYSIZE(modeNames); mode++) {
+		uint32 scalarTotal = 0, kernelTotal = 0;
+
+		// Every combination of the states the rasterizer has a specialization for
+		for (int state = 0; state < 16; state++) {
+			fb.enableDepthWrite(state & 1);
+			fb.enableAlphaTest(state & 2);
+			if (state & 4)
+				fb.setScissorRectangle(Common::Rect(32, 24, 608, 456));
+			else
+				fb.resetScissorRectangle();
+			fb.enableBlending(state & 8);
+
+			fb.enableSpanKernels(false);
+			uint32 scalarTime = renderTriangleSoup(fb, mode, iterations);
+			uint32 kernelTime = 0;
+			if (hasSpanKernels) {
+				fb.enableSpanKernels(true);
+				kernelTime = renderTriangleSoup(fb, mode, iterations);
+			}
+			scalarTotal += scalarTime;
+			kernelTotal += kernelTime;
+
+			if (listStates) {
+				debugPrintf("  %s%s%s%s%s: scalar %u ms, SIMD %u ms\n", modeNames[mode],
+				            (state & 1) ? ", depth write" : "", (state & 2) ? ", alpha test" : "",
+				            (state & 4) ? ", scissor" : "", (state & 8) ? ", blended" : "", scalarTime, kernelTime);
+			}
+		}
+
+		if (hasSpanKernels)
+			debugPrintf("%s, 16 states: scalar %u ms, SIMD %u ms\n", modeNames[mode], scalarTotal, kernelTotal);
+		else
+			debugPrintf("%s, 16 states: scalar %u ms\n", modeNames[mode], scalarTotal);
+	}
+	return true;
+}
+
+#ifdef USE_BINK
+/**
+ * Decode up to maxFrames frames of a Bink file, which may be wrapped
+ * in a header like the EMI movies.
+ * @return the time it took, in ms, or -1 if the file couldn't be loaded
+ */
+static int32 decodeBinkFrames(const char *filename, bool simd, int maxFrames, int &frames, bool &simdUsed) {
+	Common::SeekableReadStream *stream = SearchMan.createReadStreamForMember(filename);
+	if (!stream)
+		return -1;
+
+	int32 start = -1;
+	for (int32 pos = 0; pos + 4 <= MIN<int32>(stream->size(), 0x10000); pos++) {
+		stream->seek(pos);
+		if ((stream->readUint32BE() & 0xFFFFFF00) == MKTAG('B', 'I', 'K', 0)) {
+			start = pos;
+			break;
+		}
+	}
+	if (start < 0) {
+		delete stream;
+		return -1;
+	}
+
+	Video::BinkDecoder decoder;
+	if (!decoder.loadStream(new Common::SeekableSubReadStream(stream, start, stream->size(), DisposeAfterUse::YES)))
+		return -1;
+
+	simdUsed = decoder.enableSIMDKernels(simd);
+
+	frames = 0;
+	uint32 startTime = g_system->getMillis();
+	while (frames < maxFrames && decoder.getCurFrame() + 1 < (int)decoder.getFrameCount()) {
+		decoder.decodeNextFrame();
+		frames++;
+	}
+	return g_system->getMillis() - startTime;
+}
+
+bool Debugger::cmdBinkBench(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("Usage: bink_bench <file> [frames]\n");
+		return true;
+	}
+	int maxFrames = argc > 2 ? atoi(argv[2]) : 1000;
+
+	for (int simd = 0; simd < 2; simd++) {
+		int frames = 0;
+		bool simdUsed = false;
+		int32 time = decodeBinkFrames(argv[1], simd, maxFrames, frames, simdUsed);
+		if (time < 0) {
+			debugPrintf("Could not load the Bink video %s\n", argv[1]);
+			return true;
+		}
+		if (simd && !simdUsed) {
+			debugPrintf("SIMD kernels are not available, only timing the scalar code\n");
+			break;
+		}
+		debugPrintf("%s: %d frames in %d ms, %.1f fps\n", simd ? "SIMD" : "scalar", frames, time,
+		            time > 0 ? frames * 1000.0f / time : 0.0f);
+	}
+	return true;
+}
+#endif
+// ResidualVM specific end
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
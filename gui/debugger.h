@@ -233,6 +233,15 @@ protected:
 	bool cmdDebugFlagsList(int argc, const char **argv);
 	bool cmdDebugFlagEnable(int argc, const char **argv);
 	bool cmdDebugFlagDisable(int argc, const char **argv);
+	// ResidualVM specific start
+	bool cmdMixerStats(int argc, const char **argv);
+	bool cmdFFTBench(int argc, const char **argv);
+	bool cmdResamplerBench(int argc, const char **argv);
+	bool cmdTinyGLBench(int argc, const char **argv);
+#ifdef USE_BINK
+	bool cmdBinkBench(int argc, const char **argv);
+#endif
+	// ResidualVM specific end
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
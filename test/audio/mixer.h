@@ -0,0 +1,51 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer.h"
+#include "audio/mixer_dsp.h"
+
+class MixerDSPTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_dsp_kernels() {
+		Audio::MixerDSP scalar, simd;
+		Audio::initMixerDSP(scalar, false);
+		if (!Audio::initMixerDSP(simd, true))
+			return;
+
+		// Odd length to go through the tails, and enough channels to clip
+		const uint len = 67;
+		int16 samples[2 * len];
+		int32 accScalar[2 * len], accSIMD[2 * len];
+		int16 outScalar[2 * len], outSIMD[2 * len];
+		memset(accScalar, 0, sizeof(accScalar));
+		memset(accSIMD, 0, sizeof(accSIMD));
+
+		uint32 seed = 1;
+		for (int channel = 0; channel < 4; channel++) {
+			for (uint i = 0; i < 2 * len; i++) {
+				seed = seed * 1103515245 + 12345;
+				samples[i] = (int16)(seed >> 16);
+			}
+			int volL = channel * 85;
+			int volR = Audio::Mixer::kMaxMixerVolume - channel * 31;
+			scalar.accumulate(accScalar, samples, len, volL, volR);
+			simd.accumulate(accSIMD, samples, len, volL, volR);
+		}
+		TS_ASSERT_SAME_DATA(accScalar, accSIMD, sizeof(accScalar));
+
+		scalar.pack(outScalar, accScalar, len);
+		simd.pack(outSIMD, accSIMD, len);
+		TS_ASSERT_SAME_DATA(outScalar, outSIMD, sizeof(outScalar));
+	}
+
+	void test_accumulate_rounding() {
+		Audio::MixerDSP dsp;
+		Audio::initMixerDSP(dsp, false);
+
+		// Scaling rounds towards zero, like the rate converters
+		const int16 samples[2] = { -3, 3 };
+		int32 acc[2] = { 0, 0 };
+		dsp.accumulate(acc, samples, 1, 128, 128);
+		TS_ASSERT_EQUALS(acc[0], -1);
+		TS_ASSERT_EQUALS(acc[1], 1);
+	}
+};
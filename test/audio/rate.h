@@ -0,0 +1,80 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "helper.h"
+
+class PolyphaseRateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	static Audio::AudioStream *createConstantStream(int sampleRate, int length, int16 value) {
+		int16 *samples = (int16 *)malloc(length * sizeof(int16));
+		for (int i = 0; i < length; i++)
+			WRITE_LE_UINT16(&samples[i], value);
+		return Audio::makeRawStream((const byte *)samples, length * sizeof(int16), sampleRate,
+		                            Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	/** Convert a whole stream, at full volume */
+	static int convert(Audio::RateConverter *converter, Audio::AudioStream *stream, int16 *output, int maxLen) {
+		memset(output, 0, 2 * maxLen * sizeof(int16));
+		int len = 0;
+		while (len < maxLen) {
+			int res = converter->flow(*stream, output + 2 * len, maxLen - len, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			if (res <= 0)
+				break;
+			len += res;
+		}
+		return len;
+	}
+
+public:
+	void test_constant_signal() {
+		const int inLength = 11025;
+		const int maxLen = 4 * inLength;
+		Audio::AudioStream *stream = createConstantStream(11025, inLength, 8000);
+		Audio::RateConverter *converter = Audio::makePolyphaseRateConverter(11025, 44100, false);
+		int16 *output = new int16[2 * maxLen];
+
+		int len = convert(converter, stream, output, maxLen);
+		// All but the last few input samples come out, 4 times
+		TS_ASSERT_LESS_THAN_EQUALS(4 * (inLength - 8), len);
+		TS_ASSERT_LESS_THAN_EQUALS(len, 4 * inLength);
+
+		// Past the initial silence, a constant signal stays constant
+		for (int i = 64; i < len; i++) {
+			TS_ASSERT_EQUALS(output[2 * i], 8000);
+			TS_ASSERT_EQUALS(output[2 * i + 1], 8000);
+		}
+
+		delete[] output;
+		delete converter;
+		delete stream;
+	}
+
+	void test_simd_kernels() {
+		const int maxLen = 3 * 48000;
+		int16 *scalar = new int16[2 * maxLen];
+		int16 *simd = new int16[2 * maxLen];
+
+		Audio::AudioStream *stream = createSineStream<int16>(22050, 2, nullptr, false, true);
+		Audio::RateConverter *converter = Audio::makePolyphaseRateConverter(22050, 48000, true, false, false);
+		int scalarLen = convert(converter, stream, scalar, maxLen);
+		delete converter;
+		delete stream;
+
+		stream = createSineStream<int16>(22050, 2, nullptr, false, true);
+		converter = Audio::makePolyphaseRateConverter(22050, 48000, true, false, true);
+		int simdLen = convert(converter, stream, simd, maxLen);
+		delete converter;
+		delete stream;
+
+		TS_ASSERT_EQUALS(scalarLen, simdLen);
+		TS_ASSERT_EQUALS(memcmp(scalar, simd, 2 * scalarLen * sizeof(int16)), 0);
+
+		delete[] scalar;
+		delete[] simd;
+	}
+};
@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fft.h"
+#include "common/rdft.h"
+#include "common/dct.h"
+#include "common/mdct.h"
+
+#include <math.h>
+
+class FFTTestSuite : public CxxTest::TestSuite {
+	static void fill(float *data, int count, uint32 seed) {
+		for (int i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (float)((seed >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+		}
+	}
+
+	static void assertClose(const float *a, const float *b, int count, float scale) {
+		for (int i = 0; i < count; i++)
+			TS_ASSERT_DELTA(a[i], b[i], 1e-5f * scale);
+	}
+
+	public:
+	void test_fft_against_dft() {
+		const int bits = 6;
+		const int n = 1 << bits;
+		Common::Complex in[n], out[n];
+		fill(&in[0].re, 2 * n, 1);
+		memcpy(out, in, sizeof(in));
+
+		Common::FFT fft(bits, 0);
+		fft.enableSIMDKernels(true);
+		fft.permute(out);
+		fft.calc(out);
+
+		for (int k = 0; k < n; k++) {
+			double re = 0.0, im = 0.0;
+			for (int j = 0; j < n; j++) {
+				double angle = -2.0 * M_PI * j * k / n;
+				re += in[j].re * cos(angle) - in[j].im * sin(angle);
+				im += in[j].re * sin(angle) + in[j].im * cos(angle);
+			}
+			TS_ASSERT_DELTA(out[k].re, re, 1e-4);
+			TS_ASSERT_DELTA(out[k].im, im, 1e-4);
+		}
+	}
+
+	void test_fft_simd() {
+		for (int bits = 2; bits <= 12; bits++) {
+			for (int inverse = 0; inverse < 2; inverse++) {
+				const int n = 1 << bits;
+				Common::Complex *scalar = new Common::Complex[n];
+				Common::Complex *simd = new Common::Complex[n];
+				fill(&scalar[0].re, 2 * n, bits);
+				memcpy(simd, scalar, n * sizeof(Common::Complex));
+
+				Common::FFT fft(bits, inverse);
+				fft.enableSIMDKernels(false);
+				fft.permute(scalar);
+				fft.calc(scalar);
+				fft.enableSIMDKernels(true);
+				fft.permute(simd);
+				fft.calc(simd);
+
+				assertClose(&scalar[0].re, &simd[0].re, 2 * n, (float)n);
+
+				delete[] scalar;
+				delete[] simd;
+			}
+		}
+	}
+
+	void test_transforms_simd() {
+		// The sizes used by Bink audio and WMA
+		for (int bits = 8; bits <= 11; bits++) {
+			const int n = 1 << bits;
+			// DCT-I and DST-I work on n + 1 values
+			float *input = new float[n + 1];
+			float *scalar = new float[n + 1];
+			float *simd = new float[n + 1];
+			fill(input, n + 1, bits);
+
+			for (int type = Common::RDFT::DFT_R2C; type <= Common::RDFT::DFT_C2R; type++) {
+				Common::RDFT rdft(bits, (Common::RDFT::TransformType)type);
+				memcpy(scalar, input, (n + 1) * sizeof(float));
+				memcpy(simd, input, (n + 1) * sizeof(float));
+				rdft.enableSIMDKernels(false);
+				rdft.calc(scalar);
+				rdft.enableSIMDKernels(true);
+				rdft.calc(simd);
+				assertClose(scalar, simd, n, (float)n);
+			}
+
+			for (int type = Common::DCT::DCT_II; type <= Common::DCT::DST_I; type++) {
+				Common::DCT dct(bits, (Common::DCT::TransformType)type);
+				memcpy(scalar, input, (n + 1) * sizeof(float));
+				memcpy(simd, input, (n + 1) * sizeof(float));
+				dct.enableSIMDKernels(false);
+				dct.calc(scalar);
+				dct.enableSIMDKernels(true);
+				dct.calc(simd);
+				assertClose(scalar, simd, n, (float)n);
+			}
+
+			Common::MDCT mdct(bits, true, 1.0);
+			mdct.enableSIMDKernels(false);
+			mdct.calcIMDCT(scalar, input);
+			mdct.enableSIMDKernels(true);
+			mdct.calcIMDCT(simd, input);
+			assertClose(scalar, simd, n, (float)n);
+
+			delete[] input;
+			delete[] scalar;
+			delete[] simd;
+		}
+	}
+};
@@ -0,0 +1,167 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/stark/resources/floor.h"
+#include "engines/stark/resources/floorface.h"
+
+#include <float.h>
+
+// A floor face with its vertex indices set directly instead of read from an XRC stream
+class FloorFaceTreeTestFace : public Stark::Resources::FloorFace {
+public:
+	FloorFaceTreeTestFace(Stark::Resources::Object *parent, uint16 index, int16 vertex1, int16 vertex2, int16 vertex3) :
+			FloorFace(parent, 0, index, "Face") {
+		_indices[0] = vertex1;
+		_indices[1] = vertex2;
+		_indices[2] = vertex3;
+	}
+};
+
+// A floor with its vertices and faces set directly instead of read from an XRC stream
+class FloorFaceTreeTestFloor : public Stark::Resources::Floor {
+public:
+	FloorFaceTreeTestFloor() :
+			Floor(nullptr, 0, 0, "Floor") {
+	}
+
+	void addVertex(const Math::Vector3d &vertex) {
+		_vertices.push_back(vertex);
+	}
+
+	void addFace(int16 vertex1, int16 vertex2, int16 vertex3) {
+		addChild(new FloorFaceTreeTestFace(this, _facesCount++, vertex1, vertex2, vertex3));
+	}
+
+	uint32 getFaceCount() const {
+		return _faces.size();
+	}
+};
+
+class FloorFaceTreeTestSuite : public CxxTest::TestSuite {
+	enum {
+		kGridSize = 12
+	};
+
+	uint32 _seed;
+
+	float nextRandom(float max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 8) % 10000) * max / 10000.0f;
+	}
+
+	// A floor made of a bumpy grid of quads, each split into two triangles, with some faces disabled
+	void buildFloor(FloorFaceTreeTestFloor &floor) {
+		for (int y = 0; y <= kGridSize; y++) {
+			for (int x = 0; x <= kGridSize; x++) {
+				floor.addVertex(Math::Vector3d(x * 50.0f + nextRandom(20.0f), y * 40.0f + nextRandom(20.0f), nextRandom(30.0f)));
+			}
+		}
+
+		for (int y = 0; y < kGridSize; y++) {
+			for (int x = 0; x < kGridSize; x++) {
+				int16 vertex = y * (kGridSize + 1) + x;
+				floor.addFace(vertex, vertex + 1, vertex + kGridSize + 1);
+				floor.addFace(vertex + 1, vertex + kGridSize + 2, vertex + kGridSize + 1);
+			}
+		}
+
+		floor.onAllLoaded();
+
+		for (uint i = 0; i < floor.getFaceCount(); i++) {
+			if (nextRandom(1.0f) < 0.1f) {
+				floor.getFace(i)->enable(false);
+			}
+		}
+	}
+
+	Math::Ray randomRay() {
+		Math::Vector3d origin(nextRandom(800.0f) - 100.0f, nextRandom(700.0f) - 100.0f, 200.0f + nextRandom(300.0f));
+		Math::Vector3d direction(nextRandom(2.0f) - 1.0f, nextRandom(2.0f) - 1.0f, -nextRandom(1.0f));
+		return Math::Ray(origin, direction);
+	}
+
+public:
+	void test_point_queries() {
+		_seed = 1;
+		FloorFaceTreeTestFloor floor;
+		buildFloor(floor);
+
+		for (int i = 0; i < 2000; i++) {
+			Math::Vector3d point(nextRandom(700.0f) - 50.0f, nextRandom(600.0f) - 50.0f, 0.0f);
+			if (i % 10 == 0) {
+				// Points on the shared edges and vertices
+				Stark::Resources::FloorFace *face = floor.getFace(i % floor.getFaceCount());
+				point = floor.getVertex(face->getVertexIndex(i % 3));
+			}
+
+			int32 expected = -1;
+			for (uint j = 0; j < floor.getFaceCount(); j++) {
+				if (floor.getFace(j)->isPointInside(point)) {
+					expected = j;
+					break;
+				}
+			}
+
+			TS_ASSERT_EQUALS(floor.findFaceContainingPoint(point), expected);
+		}
+	}
+
+	void test_ray_queries() {
+		_seed = 2;
+		FloorFaceTreeTestFloor floor;
+		buildFloor(floor);
+
+		for (int i = 0; i < 2000; i++) {
+			Math::Ray ray = randomRay();
+
+			// Disabled faces block the ray
+			int32 expectedHit = -1;
+			Math::Vector3d expectedIntersection;
+			for (uint j = 0; j < floor.getFaceCount(); j++) {
+				Stark::Resources::FloorFace *face = floor.getFace(j);
+				if (face->intersectRay(ray, expectedIntersection)) {
+					expectedHit = face->isEnabled() ? j : -1;
+					break;
+				}
+			}
+
+			// Face 0 is never considered, as in the original
+			int32 expectedClosest = -1;
+			float minDistance = FLT_MAX;
+			for (uint j = 1; j < floor.getFaceCount(); j++) {
+				Stark::Resources::FloorFace *face = floor.getFace(j);
+				float distance = face->distanceToRay(ray);
+				if (face->isEnabled() && distance < minDistance) {
+					expectedClosest = j;
+					minDistance = distance;
+				}
+			}
+
+			Math::Vector3d intersection;
+			int32 hit = floor.findFaceHitByRay(ray, intersection);
+			TS_ASSERT_EQUALS(hit, expectedHit);
+			if (hit >= 0 && hit == expectedHit) {
+				TS_ASSERT(intersection == expectedIntersection);
+			}
+
+			Math::Vector3d center;
+			int32 closest = floor.findFaceClosestToRay(ray, center);
+			TS_ASSERT_EQUALS(closest, expectedClosest);
+			if (closest >= 0 && closest == expectedClosest) {
+				TS_ASSERT(center == floor.getFace(closest)->getCenter());
+			}
+		}
+	}
+
+	void test_empty_floor() {
+		FloorFaceTreeTestFloor floor;
+		floor.onAllLoaded();
+
+		Math::Vector3d point(1.0f, 2.0f, 3.0f);
+		Math::Ray ray(point, Math::Vector3d(0.0f, 0.0f, -1.0f));
+		Math::Vector3d result;
+
+		TS_ASSERT_EQUALS(floor.findFaceContainingPoint(point), -1);
+		TS_ASSERT_EQUALS(floor.findFaceHitByRay(ray, result), -1);
+		TS_ASSERT_EQUALS(floor.findFaceClosestToRay(ray, result), -1);
+	}
+};
@@ -0,0 +1,154 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/tinygl/zbuffer.h"
+
+class TinyGLSpanTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 61,
+		kHeight = 47,
+		kTextureSize = 32,
+		kTriangleCount = 40
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	void randomPoint(TinyGL::ZBufferPoint &p) {
+		p.x = nextRandom(kWidth);
+		p.y = nextRandom(kHeight);
+		p.z = nextRandom(1 << 30);
+		p.s = nextRandom(kTextureSize << ZB_POINT_ST_FRAC_BITS);
+		p.t = nextRandom(kTextureSize << ZB_POINT_ST_FRAC_BITS);
+		p.r = nextRandom(ZB_POINT_RED_MAX + 1);
+		p.g = nextRandom(ZB_POINT_GREEN_MAX + 1);
+		p.b = nextRandom(ZB_POINT_BLUE_MAX + 1);
+		p.a = nextRandom(ZB_POINT_ALPHA_MAX + 1);
+		p.sz = p.tz = 0;
+	}
+
+	/**
+	 * Set the states the rasterizer has a specialization for from the bits
+	 * of state: depth write, alpha test, scissor and blending. The variant
+	 * picks the depth and alpha functions, and with blending the factors,
+	 * so that the 8 variants of the 8 blended states use all the pairs.
+	 */
+	void setState(TinyGL::FrameBuffer &fb, int state, int variant) {
+		static const int kFactors[] = {
+			TGL_ZERO, TGL_ONE, TGL_DST_COLOR, TGL_ONE_MINUS_DST_COLOR,
+			TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA, TGL_DST_ALPHA, TGL_ONE_MINUS_DST_ALPHA
+		};
+
+		// Depth writes are only specialized for when the depth test is enabled too
+		if (state & 1) {
+			fb.enableDepthTest(true);
+			fb.enableDepthWrite(true);
+		} else {
+			fb.enableDepthTest(variant % 3 == 0);
+			fb.enableDepthWrite(variant % 3 == 1);
+		}
+		fb.setDepthFunc(TGL_NEVER + variant);
+
+		fb.enableAlphaTest(state & 2);
+		fb.setAlphaTestFunc(TGL_NEVER + (variant * 3 + 1) % 8, (variant * 37 + 20) & 0xFF);
+
+		if (state & 4)
+			fb.setScissorRectangle(Common::Rect(5 + variant, 7, 40 + variant, 33));
+		else
+			fb.resetScissorRectangle();
+
+		fb.enableBlending(state & 8);
+		int pair = (state & 7) * 8 + variant;
+		fb.setBlendingFactors(kFactors[pair % 8], kFactors[pair / 8]);
+	}
+
+	void drawTriangles(TinyGL::FrameBuffer &fb, int mode, uint32 seed) {
+		_seed = seed;
+		for (int i = 0; i < kTriangleCount; i++) {
+			TinyGL::ZBufferPoint p0, p1, p2;
+			randomPoint(p0);
+			randomPoint(p1);
+			randomPoint(p2);
+			switch (mode) {
+			case 0:
+				fb.fillTriangleDepthOnly(&p0, &p1, &p2);
+				break;
+			case 1:
+				fb.fillTriangleFlat(&p0, &p1, &p2);
+				break;
+			case 2:
+				fb.fillTriangleSmooth(&p0, &p1, &p2);
+				break;
+			case 3:
+				fb.fillTriangleTextureMappingPerspectiveFlat(&p0, &p1, &p2);
+				break;
+			default:
+				fb.fillTriangleTextureMappingPerspectiveSmooth(&p0, &p1, &p2);
+				break;
+			}
+		}
+	}
+
+public:
+	void test_span_kernels() {
+		// With and without an alpha channel in the frame buffer
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		const Graphics::PixelFormat textureFormat(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		byte *scalarPixels = new byte[kWidth * kHeight * 4];
+		byte *kernelPixels = new byte[kWidth * kHeight * 4];
+		uint32 *texels = new uint32[kTextureSize * kTextureSize];
+
+		_seed = 1;
+		for (int i = 0; i < kTextureSize * kTextureSize; i++) {
+			texels[i] = nextRandom(0x10000) | (nextRandom(0x10000) << 16);
+		}
+		Graphics::PixelBuffer texture(textureFormat, (byte *)texels);
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			TinyGL::FrameBuffer scalar(kWidth, kHeight, Graphics::PixelBuffer(formats[f], scalarPixels));
+			TinyGL::FrameBuffer kernel(kWidth, kHeight, Graphics::PixelBuffer(formats[f], kernelPixels));
+			scalar.enableSpanKernels(false);
+			if (!kernel.enableSpanKernels(true))
+				break;
+
+			scalar.setTexture(texture);
+			kernel.setTexture(texture);
+			scalar._textureSize = kernel._textureSize = kTextureSize;
+			scalar._textureSizeMask = kernel._textureSizeMask = (kTextureSize - 1) << ZB_POINT_ST_FRAC_BITS;
+
+			// Every fill function, in every specialization of the rasterizer
+			for (int mode = 0; mode < 5; mode++) {
+				for (int state = 0; state < 16; state++) {
+					for (int variant = 0; variant < 8; variant++) {
+						const uint32 seed = ((f * 5 + mode) * 16 + state) * 8 + variant;
+						_seed = seed;
+						for (int i = 0; i < kWidth * kHeight; i++) {
+							uint32 color = nextRandom(0x10000) | (nextRandom(0x10000) << 16);
+							uint32 depth = nextRandom(1 << 30);
+							((uint32 *)scalarPixels)[i] = ((uint32 *)kernelPixels)[i] = color;
+							scalar.getZBuffer()[i] = kernel.getZBuffer()[i] = depth;
+						}
+
+						setState(scalar, state, variant);
+						setState(kernel, state, variant);
+						drawTriangles(scalar, mode, seed);
+						drawTriangles(kernel, mode, seed);
+
+						TS_ASSERT(memcmp(scalarPixels, kernelPixels, kWidth * kHeight * 4) == 0);
+						TS_ASSERT(memcmp(scalar.getZBuffer(), kernel.getZBuffer(), kWidth * kHeight * 4) == 0);
+					}
+				}
+			}
+		}
+
+		delete[] scalarPixels;
+		delete[] kernelPixels;
+		delete[] texels;
+	}
+};
@@ -5,14 +5,24 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h
-TEST_LIBS    := audio/libaudio.a math/libmath.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/math/*.h
+TEST_LIBS    := audio/libaudio.a graphics/libgraphics.a math/libmath.a common/libcommon.a
+
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/*.h
+	TEST_LIBS := video/libvideo.a $(TEST_LIBS)
+endif
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_STARK), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/stark/*.h
+	TEST_LIBS += engines/stark/libstark.a
+endif
+
 ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/ultima/*/*/*.h
 	TEST_LIBS += engines/ultima/libultima.a
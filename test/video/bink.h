@@ -0,0 +1,95 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/bink_dsp.h"
+
+class BinkDSPTestSuite : public CxxTest::TestSuite {
+	enum {
+		kPitch = 40,
+		kBlockCount = 500
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	// Coefficients in the range of the Bink DCT, with some blocks only
+	// having a few non-zero values like most of the real ones
+	void randomCoefficients(int32 *block, int n) {
+		int range = (n % 3 == 0) ? 256 : 8192;
+		bool sparse = n % 2 == 0;
+		for (int i = 0; i < 64; i++) {
+			if (sparse && i != 0 && nextRandom(8) != 0)
+				block[i] = 0;
+			else
+				block[i] = (int32)nextRandom(range) - range / 2;
+		}
+	}
+
+	void randomPixels(byte *pixels, int size) {
+		for (int i = 0; i < size; i++)
+			pixels[i] = nextRandom(256);
+	}
+
+public:
+	void test_dsp_kernels() {
+#ifdef USE_BINK
+		Video::BinkDSP scalar, simd;
+		Video::initBinkDSP(scalar, false);
+		if (!Video::initBinkDSP(simd, true))
+			return;
+
+		const int planeSize = kPitch * 16;
+		byte scalarPixels[planeSize], simdPixels[planeSize];
+		int32 scalarBlock[64], simdBlock[64];
+
+		for (int n = 0; n < kBlockCount; n++) {
+			_seed = n;
+			// Start the blocks at an odd offset, the planes don't align them
+			byte *scalarDest = scalarPixels + 3;
+			byte *simdDest = simdPixels + 3;
+
+			randomCoefficients(scalarBlock, n);
+			memcpy(simdBlock, scalarBlock, sizeof(scalarBlock));
+			scalar.idct(scalarBlock);
+			simd.idct(simdBlock);
+			TS_ASSERT(memcmp(scalarBlock, simdBlock, sizeof(scalarBlock)) == 0);
+
+			randomCoefficients(scalarBlock, n);
+			memcpy(simdBlock, scalarBlock, sizeof(scalarBlock));
+			randomPixels(scalarPixels, planeSize);
+			memcpy(simdPixels, scalarPixels, planeSize);
+			scalar.idctPut(scalarDest, kPitch, scalarBlock);
+			simd.idctPut(simdDest, kPitch, simdBlock);
+			TS_ASSERT(memcmp(scalarPixels, simdPixels, planeSize) == 0);
+
+			randomCoefficients(scalarBlock, n);
+			memcpy(simdBlock, scalarBlock, sizeof(scalarBlock));
+			scalar.idctAdd(scalarDest, kPitch, scalarBlock);
+			simd.idctAdd(simdDest, kPitch, simdBlock);
+			TS_ASSERT(memcmp(scalarPixels, simdPixels, planeSize) == 0);
+
+			randomCoefficients(scalarBlock, n);
+			memcpy(simdBlock, scalarBlock, sizeof(scalarBlock));
+			scalar.idctPutScaled(scalarDest, kPitch, scalarBlock);
+			simd.idctPutScaled(simdDest, kPitch, simdBlock);
+			TS_ASSERT(memcmp(scalarPixels, simdPixels, planeSize) == 0);
+
+			int16 residue[64];
+			for (int i = 0; i < 64; i++)
+				residue[i] = (int16)nextRandom(1024) - 512;
+			scalar.addResidue(scalarDest, kPitch, residue);
+			simd.addResidue(simdDest, kPitch, residue);
+			TS_ASSERT(memcmp(scalarPixels, simdPixels, planeSize) == 0);
+
+			byte raw[64];
+			randomPixels(raw, 64);
+			scalar.putScaled(scalarDest, kPitch, raw);
+			simd.putScaled(simdDest, kPitch, raw);
+			TS_ASSERT(memcmp(scalarPixels, simdPixels, planeSize) == 0);
+		}
+#endif
+	}
+};
@@ -59,8 +59,43 @@ static const uint16 kAudioFlagStereo = 0x2000;
 // Number of bits used to store first DC value in bundle
 static const uint32 kDCStartBits = 11;
 
+// ResidualVM: threads for decoding the next frame ahead and for the color conversion
+static const uint kMaxDecodeThreads = 3;
+
 namespace Video {
 
+// ResidualVM: the decode threads are shared by all the Bink video tracks,
+// and only started once a track has a frame to decode ahead
+static Common::WorkerPool *s_decodePool = nullptr;
+static uint s_decodePoolUsers = 0;
+static bool s_decodePoolFailed = false;
+
+static Common::WorkerPool *acquireDecodePool() {
+	if (!s_decodePool && !s_decodePoolFailed) {
+		uint threadCount = MIN<uint>(Common::WorkerPool::getDefaultThreadCount(), kMaxDecodeThreads);
+		if (threadCount > 0)
+			s_decodePool = new Common::WorkerPool(threadCount);
+		if (!s_decodePool || s_decodePool->getThreadCount() == 0) {
+			delete s_decodePool;
+			s_decodePool = nullptr;
+			s_decodePoolFailed = true;
+			return nullptr;
+		}
+	}
+
+	if (s_decodePool)
+		s_decodePoolUsers++;
+	return s_decodePool;
+}
+
+static void releaseDecodePool() {
+	assert(s_decodePool && s_decodePoolUsers > 0);
+	if (--s_decodePoolUsers == 0) {
+		delete s_decodePool;
+		s_decodePool = nullptr;
+	}
+}
+
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
 }
@@ -200,16 +235,64 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
+	// ResidualVM: the planes may already have been decoded on a worker thread
+	if (!videoTrack->finishDecodeAhead()) {
+		uint32 videoPacketStart = _bink->pos();
+		uint32 videoPacketEnd   = _bink->pos() + frameSize;
+
+		frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
+				videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+		videoTrack->decodePacket(frame);
 
-	videoTrack->decodePacket(frame);
+		delete frame.bits;
+		frame.bits = 0;
+	}
 
-	delete frame.bits;
-	frame.bits = 0;
+	queueDecodeAhead();
+}
+
+// ResidualVM-specific function
+void BinkDecoder::queueDecodeAhead() {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+
+	// A paused movie may not ask for the next frame for a long time
+	if (isPaused() || !videoTrack->canDecodeAhead())
+		return;
+
+	// Read the video part of the next packet while the engine thread still
+	// owns the file. The audio part is left for readNextPacket(), which
+	// reports the errors of malformed packets at the right frame.
+	const VideoFrame &frame = _frames[videoTrack->getCurFrame() + 1];
+
+	if (!_bink->seek(frame.offset))
+		return;
+
+	uint32 frameSize = frame.size;
+
+	for (uint32 i = 0; i < _audioTracks.size(); i++) {
+		uint32 audioPacketLength = _bink->readUint32LE();
+
+		frameSize -= 4;
+
+		if (frameSize < audioPacketLength)
+			return;
+
+		if (audioPacketLength >= 4) {
+			_bink->skip(audioPacketLength);
+
+			frameSize -= audioPacketLength;
+		}
+	}
+
+	Common::SeekableReadStream *packet = _bink->readStream(frameSize);
+	if (packet->size() != (int32)frameSize) {
+		// Truncated file, let the sequential path deal with it
+		delete packet;
+		return;
+	}
+
+	videoTrack->decodeAhead(packet);
 }
 
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
@@ -243,9 +326,12 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 }
 
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
-		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
+		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id), _decodePool(nullptr), _decodeAhead(this) {
 	_curFrame = -1;
 
+	// ResidualVM: SIMD pixel kernels, when the CPU has them
+	initBinkDSP(_dsp, g_system && g_system->hasFeature(OSystem::kFeatureCpuSSE2));
+
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
@@ -317,6 +403,10 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
+	cancelDecodeAhead();
+	if (_decodePool)
+		releaseDecodePool();
+
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
@@ -363,6 +453,16 @@ Common::Rational BinkDecoder::getFrameRate() {
 	return videoTrack->getFrameRate();
 }
 
+// ResidualVM-specific function
+bool BinkDecoder::enableSIMDKernels(bool enable) {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+	assert(videoTrack);
+
+	// The frame being decoded ahead uses the kernels
+	videoTrack->cancelDecodeAhead();
+	return videoTrack->enableSIMDKernels(enable);
+}
+
 // ResidualVM-specific function
 bool BinkDecoder::seekIntern(const Audio::Timestamp &time) {
 	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
@@ -465,6 +565,7 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 		return false;
 	}
 
+	cancelDecodeAhead();
 	_curFrame = -1;
 
 	// Re-initialize the video with solid green
@@ -480,7 +581,72 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 	return true;
 }
 
+// ResidualVM-specific function
+void BinkDecoder::BinkVideoTrack::setCurFrame(uint32 frame) {
+	// The frame decoded ahead was predicted from the current one
+	cancelDecodeAhead();
+	_curFrame = frame;
+}
+
+// ResidualVM-specific function
+bool BinkDecoder::BinkVideoTrack::canDecodeAhead() {
+	// Wait for a second frame to be asked for, so that grabbing a single
+	// frame of a movie doesn't start the threads
+	if (_decodeAhead._queued || _curFrame < 1 || _curFrame + 1 >= _frameCount)
+		return false;
+
+	// One thread decodes the next frame ahead, the others help converting
+	// the colors
+	if (!_decodePool)
+		_decodePool = acquireDecodePool();
+
+	return _decodePool != nullptr;
+}
+
+// ResidualVM-specific function
+void BinkDecoder::BinkVideoTrack::decodeAhead(Common::SeekableReadStream *packet) {
+	assert(canDecodeAhead());
+
+	// The job only touches the planes, the bundles and its own packet,
+	// none of which the engine thread uses until finishDecodeAhead()
+	_decodeAhead._frame.bits = new Common::BitStream32LELSB(packet, DisposeAfterUse::YES);
+	_decodeAhead._queued = true;
+	_decodePool->queue(&_decodeAhead);
+}
+
+// ResidualVM-specific function
+bool BinkDecoder::BinkVideoTrack::finishDecodeAhead() {
+	if (!_decodeAhead._queued)
+		return false;
+
+	_decodePool->wait(&_decodeAhead);
+	_decodeAhead._queued = false;
+
+	delete _decodeAhead._frame.bits;
+	_decodeAhead._frame.bits = 0;
+
+	finishFrame();
+	return true;
+}
+
+// ResidualVM-specific function
+void BinkDecoder::BinkVideoTrack::cancelDecodeAhead() {
+	if (!_decodeAhead._queued)
+		return;
+
+	_decodePool->cancel(&_decodeAhead);
+	_decodeAhead._queued = false;
+
+	delete _decodeAhead._frame.bits;
+	_decodeAhead._frame.bits = 0;
+}
+
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+	decodePlanes(frame);
+	finishFrame();
+}
+
+void BinkDecoder::BinkVideoTrack::decodePlanes(VideoFrame &frame) {
 	assert(frame.bits);
 
 	if (_hasAlpha) {
@@ -501,14 +667,16 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		if (frame.bits->pos() >= frame.bits->size())
 			break;
 	}
+}
 
+void BinkDecoder::BinkVideoTrack::finishFrame() {
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
 	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _curPlanes[3]
 	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
 	YUVAToRGBAMan.convert420(&_surface, Graphics::YUVAToRGBAManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-			_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+			_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8, _decodePool);
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
@@ -834,17 +1002,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
-
-	int32 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
+	_dsp.idctPutScaled(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
@@ -872,18 +1030,9 @@ void BinkDecoder::BinkVideoTrack::blockScaledPattern(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledRaw(DecodeContext &ctx) {
-	byte row[8];
+	_dsp.putScaled(ctx.dest, ctx.pitch, _bundles[kSourceColors].curPtr);
 
-	byte *dest1 = ctx.dest;
-	byte *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16) {
-		memcpy(row, _bundles[kSourceColors].curPtr, 8);
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = row[i];
-
-		_bundles[kSourceColors].curPtr += 8;
-	}
+	_bundles[kSourceColors].curPtr += 64;
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaled(DecodeContext &ctx) {
@@ -964,11 +1113,7 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	_dsp.addResidue(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
@@ -979,7 +1124,7 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCTPut(ctx, block);
+	_dsp.idctPut(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -1000,7 +1145,7 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, false);
 
-	IDCTAdd(ctx, block);
+	_dsp.idctAdd(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1428,88 +1573,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-    const int a0 = (src)[s0] + (src)[s4]; \
-    const int a1 = (src)[s0] - (src)[s4]; \
-    const int a2 = (src)[s2] + (src)[s6]; \
-    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-    const int a4 = (src)[s5] + (src)[s3]; \
-    const int a5 = (src)[s5] - (src)[s3]; \
-    const int a6 = (src)[s1] + (src)[s7]; \
-    const int a7 = (src)[s1] - (src)[s7]; \
-    const int b0 = a4 + a6; \
-    const int b1 = (A3*(a5 + a7)) >> 11; \
-    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-    (dest)[d0] = munge(a0+a2   +b0); \
-    (dest)[d1] = munge(a1+a3-a2+b2); \
-    (dest)[d2] = munge(a1-a3+a2+b3); \
-    (dest)[d3] = munge(a0-a2   -b4); \
-    (dest)[d4] = munge(a0-a2   +b4); \
-    (dest)[d5] = munge(a1-a3+a2-b3); \
-    (dest)[d6] = munge(a1+a3-a2-b2); \
-    (dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int32 *dest, const int32 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
-	int32 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
@@ -34,9 +34,11 @@
 #include "common/array.h"
 #include "common/bitstream.h"
 #include "common/rational.h"
+#include "common/workerpool.h" // ResidualVM specific
 #include "graphics/surface.h" // ResidualVM specific
 
 #include "video/video_decoder.h"
+#include "video/bink_dsp.h" // ResidualVM specific
 
 #include "graphics/surface.h"
 
@@ -76,6 +78,12 @@ public:
 
 	// ResidualVM-specific:
 	Common::Rational getFrameRate();
+	/**
+	 * Use the SIMD pixel kernels if they are available, they give the same
+	 * output as the scalar ones. Must be called after loading a video.
+	 * @return whether the SIMD kernels are used
+	 */
+	bool enableSIMDKernels(bool enable);
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -84,6 +92,7 @@ protected:
 	// ResidualVM-specific:
 	bool seekIntern(const Audio::Timestamp &time);
 	uint32 findKeyFrame(uint32 frame) const;
+	void queueDecodeAhead();
 
 private:
 	static const int kAudioChannelsMax  = 2;
@@ -162,12 +171,25 @@ private:
 		bool isSeekable() const { return true; }
 		bool seek(const Audio::Timestamp &time) { return true; }
 		bool rewind() override;
-		void setCurFrame(uint32 frame) { _curFrame = frame; }
+		void setCurFrame(uint32 frame);
 // End of ResidualVM-specific
 
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
 
+// ResidualVM-specific:
+		/** Is there a worker thread free to decode the next frame ahead? Starts the shared threads if needed. */
+		bool canDecodeAhead();
+		/** Start decoding the next frame on a worker thread, taking ownership of the packet. */
+		void decodeAhead(Common::SeekableReadStream *packet);
+		/** Complete the frame decoded ahead. Returns false if there is none. */
+		bool finishDecodeAhead();
+		/** Discard the frame decoded ahead, if any. */
+		void cancelDecodeAhead();
+		/** Use the SIMD pixel kernels if they are available. Returns whether they are used. */
+		bool enableSIMDKernels(bool enable) { return initBinkDSP(_dsp, enable); }
+// End of ResidualVM-specific
+
 	public: // ResidualVM
 		Common::Rational getFrameRate() const { return _frameRate; }
 
@@ -231,6 +253,18 @@ private:
 			byte symbols[16]; ///< Huffman symbol => Bink symbol tranlation list.
 		};
 
+		/** The planes of the next frame, decoded on a worker thread. */
+		class DecodeAheadJob : public Common::WorkerJob {
+		public:
+			DecodeAheadJob(BinkVideoTrack *track) : _track(track), _queued(false) {}
+
+			void execute() override { _track->decodePlanes(_frame); }
+
+			BinkVideoTrack *_track;
+			VideoFrame _frame;
+			bool _queued;
+		};
+
 		/** Data structure used for decoding a single Bink data type. */
 		struct Bundle {
 			int countLengths[2]; ///< Lengths of number of entries to decode (in bits).
@@ -276,6 +310,10 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		Common::WorkerPool *_decodePool; ///< Shared threads for the frame ahead and the color conversion, once needed.
+		BinkDSP _dsp; ///< The pixel kernels.
+		DecodeAheadJob _decodeAhead;
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -284,6 +322,11 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
+		/** Decode the planes of a video packet. */
+		void decodePlanes(VideoFrame &frame);
+		/** Convert the decoded planes to the surface and make them the reference frame. */
+		void finishFrame();
+
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
@@ -330,11 +373,6 @@ private:
 		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -0,0 +1,380 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The scalar kernels come from the Bink decoder, which is based on
+// the one found in FFmpeg.
+
+#include "video/bink_dsp.h"
+
+#ifdef USE_BINK
+
+#ifdef BINK_SIMD_KERNELS
+#include <emmintrin.h>
+#endif
+
+namespace Video {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int32 *dest, const int32 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+static void IDCT(int32 *block) {
+	int i;
+	int32 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+static void IDCTPut(byte *dest, uint32 pitch, int32 *block) {
+	int i;
+	int32 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+static void IDCTAdd(byte *dest, uint32 pitch, int32 *block) {
+	int i, j;
+
+	IDCT(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+static void IDCTPutScaled(byte *dest, uint32 pitch, int32 *block) {
+	IDCT(block);
+
+	int32 *src   = block;
+	byte  *dest1 = dest;
+	byte  *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
+	}
+}
+
+static void addResidue(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+static void putScaled(byte *dest, uint32 pitch, const byte *src) {
+	byte *dest1 = dest;
+	byte *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
+	}
+}
+
+#ifdef BINK_SIMD_KERNELS
+
+// 32 bit low multiplication by a constant below 2^15, SSE2 only has it for
+// 16 bit values: the low half of each lane times c is a full 32 bit product,
+// of the high half only the low 16 bits matter.
+static FORCEINLINE __m128i mulConst(__m128i a, int16 c) {
+	const __m128i b = _mm_set1_epi16(c);
+	return _mm_add_epi32(_mm_mullo_epi16(a, b), _mm_slli_epi32(_mm_mulhi_epu16(a, b), 16));
+}
+
+/**
+ * IDCT_TRANSFORM on four columns at once: s holds one input per vector and
+ * one column per lane. The shortcut for columns without AC coefficients
+ * isn't needed, the full transform gives the same result.
+ */
+static FORCEINLINE void transformSSE2(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mulConst(_mm_sub_epi32(s[2], s[6]), A1), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mulConst(_mm_add_epi32(a5, a7), A3), 11);
+	// A4 is negative
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(_mm_sub_epi32(_mm_setzero_si128(), mulConst(a5, -A4)), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mulConst(_mm_sub_epi32(a6, a4), A1), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mulConst(a7, A2), 11), b3), b1);
+	const __m128i a0p2 = _mm_add_epi32(a0, a2);
+	const __m128i a0m2 = _mm_sub_epi32(a0, a2);
+	const __m128i a1p3m2 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i a1m3p2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	d[0] = _mm_add_epi32(a0p2, b0);
+	d[1] = _mm_add_epi32(a1p3m2, b2);
+	d[2] = _mm_add_epi32(a1m3p2, b3);
+	d[3] = _mm_sub_epi32(a0m2, b4);
+	d[4] = _mm_add_epi32(a0m2, b4);
+	d[5] = _mm_sub_epi32(a1m3p2, b3);
+	d[6] = _mm_sub_epi32(a1p3m2, b2);
+	d[7] = _mm_sub_epi32(a0p2, b0);
+}
+
+static FORCEINLINE void transpose4x4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	__m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	__m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	__m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	__m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/**
+ * Transpose an 8x8 block held as rows of two vectors: row i is in[i] for
+ * the columns 0-3 and in[8 + i] for the columns 4-7, and so is out.
+ */
+static FORCEINLINE void transpose8x8(__m128i *out, const __m128i *in) {
+	for (int i = 0; i < 16; i++)
+		out[i] = in[i];
+
+	// Transpose the four quarters, then swap the two off-diagonal ones
+	transpose4x4(out[0], out[1], out[2], out[3]);
+	transpose4x4(out[4], out[5], out[6], out[7]);
+	transpose4x4(out[8], out[9], out[10], out[11]);
+	transpose4x4(out[12], out[13], out[14], out[15]);
+	for (int i = 0; i < 4; i++) {
+		__m128i t = out[4 + i];
+		out[4 + i] = out[8 + i];
+		out[8 + i] = t;
+	}
+}
+
+/**
+ * Both passes of the IDCT, with the row rounding. The block is transposed
+ * in the result, held like transpose8x8() expects: columns[i] has the rows
+ * 0-3 of the column i, and columns[8 + i] the rows 4-7.
+ */
+static FORCEINLINE void IDCTSSE2(__m128i *columns, const int32 *block) {
+	__m128i s[16], d[16];
+
+	for (int i = 0; i < 8; i++) {
+		s[i] = _mm_loadu_si128((const __m128i *)&block[8 * i]);
+		s[8 + i] = _mm_loadu_si128((const __m128i *)&block[8 * i + 4]);
+	}
+
+	// Columns, both halves at once to keep the two dependency chains going
+	transformSSE2(&d[0], &s[0]);
+	transformSSE2(&d[8], &s[8]);
+
+	// Rows, as columns of the transposed block
+	transpose8x8(s, d);
+	transformSSE2(&columns[0], &s[0]);
+	transformSSE2(&columns[8], &s[8]);
+
+	const __m128i rounding = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 16; i++)
+		columns[i] = _mm_srai_epi32(_mm_add_epi32(columns[i], rounding), 8);
+}
+
+/**
+ * The low bytes of the transposed IDCT output, as the assignment to a byte
+ * does, in rows: each of the four vectors holds two rows of 8 pixels.
+ */
+static FORCEINLINE void packRows(__m128i *rows, const __m128i *columns) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	__m128i pairs[4];
+
+	// Two columns per vector
+	for (int i = 0; i < 4; i++) {
+		__m128i column0 = _mm_packs_epi32(_mm_and_si128(columns[2 * i], mask), _mm_and_si128(columns[8 + 2 * i], mask));
+		__m128i column1 = _mm_packs_epi32(_mm_and_si128(columns[2 * i + 1], mask), _mm_and_si128(columns[8 + 2 * i + 1], mask));
+		pairs[i] = _mm_packus_epi16(column0, column1);
+		// Interleave them
+		pairs[i] = _mm_unpacklo_epi8(pairs[i], _mm_srli_si128(pairs[i], 8));
+	}
+
+	__m128i lo01 = _mm_unpacklo_epi16(pairs[0], pairs[1]);
+	__m128i hi01 = _mm_unpackhi_epi16(pairs[0], pairs[1]);
+	__m128i lo23 = _mm_unpacklo_epi16(pairs[2], pairs[3]);
+	__m128i hi23 = _mm_unpackhi_epi16(pairs[2], pairs[3]);
+	rows[0] = _mm_unpacklo_epi32(lo01, lo23);
+	rows[1] = _mm_unpackhi_epi32(lo01, lo23);
+	rows[2] = _mm_unpacklo_epi32(hi01, hi23);
+	rows[3] = _mm_unpackhi_epi32(hi01, hi23);
+}
+
+static void IDCTSSE2(int32 *block) {
+	__m128i columns[16], rows[16];
+	IDCTSSE2(columns, block);
+	transpose8x8(rows, columns);
+
+	for (int i = 0; i < 8; i++) {
+		_mm_storeu_si128((__m128i *)&block[8 * i], rows[i]);
+		_mm_storeu_si128((__m128i *)&block[8 * i + 4], rows[8 + i]);
+	}
+}
+
+static void IDCTPutSSE2(byte *dest, uint32 pitch, int32 *block) {
+	__m128i columns[16], rows[4];
+	IDCTSSE2(columns, block);
+	packRows(rows, columns);
+
+	for (int i = 0; i < 4; i++, dest += pitch << 1) {
+		_mm_storel_epi64((__m128i *)dest, rows[i]);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(rows[i], rows[i]));
+	}
+}
+
+static void IDCTAddSSE2(byte *dest, uint32 pitch, int32 *block) {
+	__m128i columns[16], rows[4];
+	IDCTSSE2(columns, block);
+	packRows(rows, columns);
+
+	for (int i = 0; i < 4; i++, dest += pitch << 1) {
+		__m128i pixels = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dest),
+		                                    _mm_loadl_epi64((const __m128i *)(dest + pitch)));
+		pixels = _mm_add_epi8(pixels, rows[i]);
+		_mm_storel_epi64((__m128i *)dest, pixels);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(pixels, pixels));
+	}
+}
+
+static void IDCTPutScaledSSE2(byte *dest, uint32 pitch, int32 *block) {
+	__m128i columns[16], rows[4];
+	IDCTSSE2(columns, block);
+	packRows(rows, columns);
+
+	for (int i = 0; i < 4; i++) {
+		__m128i row0 = _mm_unpacklo_epi8(rows[i], rows[i]);
+		__m128i row1 = _mm_unpackhi_epi8(rows[i], rows[i]);
+		_mm_storeu_si128((__m128i *)dest, row0);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row0);
+		dest += pitch << 1;
+		_mm_storeu_si128((__m128i *)dest, row1);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row1);
+		dest += pitch << 1;
+	}
+}
+
+static void addResidueSSE2(byte *dest, uint32 pitch, const int16 *block) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+
+	for (int i = 0; i < 8; i += 2, dest += pitch << 1, block += 16) {
+		__m128i residue0 = _mm_and_si128(_mm_loadu_si128((const __m128i *)block), mask);
+		__m128i residue1 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(block + 8)), mask);
+		__m128i residue = _mm_packus_epi16(residue0, residue1);
+		__m128i pixels = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dest),
+		                                    _mm_loadl_epi64((const __m128i *)(dest + pitch)));
+		pixels = _mm_add_epi8(pixels, residue);
+		_mm_storel_epi64((__m128i *)dest, pixels);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(pixels, pixels));
+	}
+}
+
+static void putScaledSSE2(byte *dest, uint32 pitch, const byte *src) {
+	for (int i = 0; i < 8; i++, dest += pitch << 1, src += 8) {
+		__m128i row = _mm_loadl_epi64((const __m128i *)src);
+		row = _mm_unpacklo_epi8(row, row);
+		_mm_storeu_si128((__m128i *)dest, row);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row);
+	}
+}
+
+#endif // BINK_SIMD_KERNELS
+
+bool initBinkDSP(BinkDSP &dsp, bool simd) {
+#ifdef BINK_SIMD_KERNELS
+	if (simd) {
+		dsp.idct          = IDCTSSE2;
+		dsp.idctPut       = IDCTPutSSE2;
+		dsp.idctAdd       = IDCTAddSSE2;
+		dsp.idctPutScaled = IDCTPutScaledSSE2;
+		dsp.addResidue    = addResidueSSE2;
+		dsp.putScaled     = putScaledSSE2;
+		return true;
+	}
+#endif
+
+	dsp.idct          = IDCT;
+	dsp.idctPut       = IDCTPut;
+	dsp.idctAdd       = IDCTAdd;
+	dsp.idctPutScaled = IDCTPutScaled;
+	dsp.addResidue    = addResidue;
+	dsp.putScaled     = putScaled;
+	return false;
+}
+
+} // End of namespace Video
+
+#endif // USE_BINK
@@ -0,0 +1,66 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+#if defined(__SSE2__)
+#define BINK_SIMD_KERNELS
+#endif
+
+namespace Video {
+
+/**
+ * The pixel kernels of the Bink video decoder. All of them work on 8x8
+ * blocks of a plane with the given pitch, and wrap the pixel values
+ * around like the original decoder instead of clamping them.
+ */
+struct BinkDSP {
+	/** Inverse DCT of a block of coefficients, in place. */
+	void (*idct)(int32 *block);
+	/** Inverse DCT of a block of coefficients, written to the pixels. The block is used as scratch space. */
+	void (*idctPut)(byte *dest, uint32 pitch, int32 *block);
+	/** Inverse DCT of a block of coefficients, added to the pixels. The block is used as scratch space. */
+	void (*idctAdd)(byte *dest, uint32 pitch, int32 *block);
+	/** Inverse DCT of a block of coefficients, written to 16x16 pixels. The block is used as scratch space. */
+	void (*idctPutScaled)(byte *dest, uint32 pitch, int32 *block);
+	/** Add a block of residue values to the pixels. */
+	void (*addResidue)(byte *dest, uint32 pitch, const int16 *block);
+	/** Write a block of 8x8 pixels as 16x16 pixels. */
+	void (*putScaled)(byte *dest, uint32 pitch, const byte *src);
+};
+
+/**
+ * Fill in the kernels, using the SIMD versions when requested and built in.
+ * @return whether the SIMD kernels are used
+ */
+bool initBinkDSP(BinkDSP &dsp, bool simd);
+
+} // End of namespace Video
+
+#endif // VIDEO_BINK_DSP_H
+
+#endif // USE_BINK